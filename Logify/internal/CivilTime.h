@@ -0,0 +1,110 @@
+/*
+ * Logify Logger Library - Internal Civil Time
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file provides the conversion of points in time to calendar dates and times
+ * without the time zone functions of the C library, which take a global lock and may
+ * re-read the time zone settings on every call. Local time is UTC plus an offset that is
+ * cached until the next change of the offset, such as a daylight saving time transition.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+
+namespace Logify::civil
+{
+
+  /**
+   * @struct Date
+   * @brief A date of the proleptic Gregorian calendar.
+   */
+  struct Date
+  {
+	  std::int64_t year;
+	  unsigned     month;  ///< 1 to 12.
+	  unsigned     day;    ///< 1 to 31.
+  };
+
+  /**
+   * @brief Converts days since 1970-01-01 to a date. Async-signal-safe.
+   */
+  constexpr Date fromDays(std::int64_t days) noexcept
+  {
+	  std::int64_t z     = days + 719'468;
+	  std::int64_t era   = (z >= 0 ? z : z - 146'096) / 146'097;
+	  std::int64_t doe   = z - era * 146'097;
+	  std::int64_t yoe   = (doe - doe / 1'460 + doe / 36'524 - doe / 146'096) / 365;
+	  std::int64_t doy   = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	  std::int64_t mp    = (5 * doy + 2) / 153;
+	  std::int64_t day   = doy - (153 * mp + 2) / 5 + 1;
+	  std::int64_t month = mp < 10 ? mp + 3 : mp - 9;
+	  return {yoe + era * 400 + (month <= 2 ? 1 : 0), static_cast<unsigned>(month), static_cast<unsigned>(day)};
+  }
+
+  /**
+   * @brief Converts a date to days since 1970-01-01. Async-signal-safe.
+   */
+  constexpr std::int64_t toDays(std::int64_t year, unsigned month, unsigned day) noexcept
+  {
+	  year -= month <= 2 ? 1 : 0;
+	  std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+	  std::int64_t yoe = year - era * 400;
+	  std::int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	  std::int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	  return era * 146'097 + doe - 719'468;
+  }
+
+  /**
+   * @brief Breaks seconds since 1970-01-01 down into the fields of a std::tm, as if in UTC.
+   *
+   * Only the date and time fields are set; no library function is called.
+   * @param seconds The seconds since the epoch, with any UTC offset already added.
+   * @param result The structure receiving the fields.
+   */
+  void breakDown(std::int64_t seconds, std::tm& result) noexcept;
+
+  /**
+   * @struct LocalOffset
+   * @brief The UTC offset of the local time zone at some point in time.
+   */
+  struct LocalOffset
+  {
+	  std::int64_t seconds;   ///< Seconds to add to UTC to get local time.
+	  bool         daylight;  ///< Whether daylight saving time is in effect.
+	  const char*  zone;      ///< The abbreviation of the zone, valid for the lifetime of the process.
+  };
+
+  /**
+   * @brief Retrieves the UTC offset of the local time zone at a point in time.
+   *
+   * The offset is cached together with the period in which it does not change; the C library
+   * is only asked again for times outside all periods seen so far. Thread-safe.
+   * @param seconds The seconds since the epoch.
+   */
+  LocalOffset localOffset(std::int64_t seconds);
+
+  /**
+   * @brief Takes the lock of the offset cache before a fork, so that the child finds the cache consistent.
+   */
+  void lockForFork() noexcept;
+
+  /**
+   * @brief Releases the lock taken by lockForFork(), in the parent or in the child.
+   */
+  void unlockAfterFork() noexcept;
+
+} // namespace Logify::civil
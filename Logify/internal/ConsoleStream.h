@@ -0,0 +1,123 @@
+/*
+ * Logify Logger Library - Internal Console Stream
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the ConsoleStream class, an internal component of the Logify
+ * library that writes log messages directly to the standard output or standard error
+ * file descriptor, bypassing the synchronized iostreams.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Sink.h"
+#include "RecordQueue.h"
+#include <array>
+#include <string>
+
+
+namespace Logify
+{
+
+  /**
+   * @brief ANSI color codes for console output.
+   *
+   * These constants are used to colorize log messages when output to a console
+   * that supports ANSI color codes.
+   */
+  namespace ConsoleColors
+  {
+	static constexpr const char* Grey   = "\033[90m";  ///< Grey color for low-importance messages.
+	static constexpr const char* White  = "\033[97m";  ///< White color for standard messages.
+	static constexpr const char* Yellow = "\033[93m";  ///< Yellow color for warning messages.
+	static constexpr const char* Red    = "\033[91m";  ///< Red color for error messages.
+	static constexpr const char* Reset  = "\033[0m";   ///< Reset color formatting to default.
+
+	/**
+	 * @brief Retrieves the color code used for a given log level.
+	 * @param level The log level.
+	 * @return The ANSI color code for the log level.
+	 */
+	constexpr const char* forLevel(LogLevel level)
+	{
+		switch (level)
+		{
+			case LogLevel::TRACE:
+			case LogLevel::DEBUG:
+				return Grey;
+			case LogLevel::INFO:
+				return White;
+			case LogLevel::WARN:
+				return Yellow;
+			case LogLevel::ERROR:
+			case LogLevel::FATAL:
+				return Red;
+			default:
+				return White;
+		}
+	}
+  } // namespace ConsoleColors
+
+  /**
+   * @class ConsoleStream
+   * @brief Writes log records to file descriptor 1 or 2 with one write call per record.
+   *
+   * Whether the descriptor refers to a terminal is checked once on construction. Colors are
+   * only emitted for terminals, using color prefixes precomputed per log level, so output that
+   * is redirected to a file or pipe contains plain text only.
+   */
+  class ConsoleStream : public Sink
+  {
+   public:
+	  /**
+	   * @brief Constructs a ConsoleStream for the given console target.
+	   * @param target The console stream to write to (standard output or standard error).
+	   * @param minLevel The lowest level of the messages written to the console.
+	   */
+	  ConsoleStream(ConsoleTarget target, LogLevel minLevel);
+
+	  /**
+	   * @brief Retrieves the name of this sink: "stdout" or "stderr".
+	   */
+	  [[nodiscard]] std::string name() const override;
+
+	  /**
+	   * @brief Writes a queued record to the console from a fatal signal handler, without colors.
+	   * @param record The queued record to write.
+	   */
+	  void writeAfterCrash(const QueuedRecord& record) noexcept override;
+
+   protected:
+	  /**
+	   * @brief Writes a log record to the console.
+	   * @param record The log record to write.
+	   */
+	  void write(const LogRecord& record) override;
+
+   private:
+	  /**
+	   * @brief Writes the whole buffer to the file descriptor, retrying on partial writes.
+	   *
+	   * Counts the bytes written and one flush, or a write error if the console is gone.
+	   */
+	  void flushBuffer();
+
+   private:
+	  int                        fd_;          ///< The file descriptor to write to (1 or 2).
+	  bool                       isTerminal_;  ///< Whether fd_ refers to a terminal.
+	  std::array<std::string, 6> prefixes_;    ///< The color prefix per log level (empty if not a terminal).
+	  std::string                suffix_;      ///< The color reset suffix (empty if not a terminal).
+	  std::string                buffer_;      ///< Reused buffer holding the formatted record.
+  };
+
+} // namespace Logify
@@ -0,0 +1,72 @@
+/*
+ * Logify Logger Library - Internal Crash Handler
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file declares the crash handler of the Logify library. Once installed,
+ * it catches fatal signals and std::terminate, writes the records still queued or
+ * buffered by every live Logger using only async-signal-safe calls, and then lets the
+ * process die with the original signal.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+
+namespace Logify
+{
+
+  /**
+   * @class CrashListener
+   * @brief Interface of objects that write their pending records when the process crashes.
+   */
+  class CrashListener
+  {
+   public:
+	  /**
+	   * @brief Writes all pending records. Called at most once, from a fatal signal handler.
+	   *
+	   * Implementations must not allocate memory or take locks, and may only make async-signal-safe calls.
+	   */
+	  virtual void writeAfterCrash() noexcept = 0;
+
+   protected:
+	  ~CrashListener() = default;
+  };
+
+} // namespace Logify
+
+namespace Logify::crash
+{
+
+  /**
+   * @brief Installs the handlers for fatal signals and std::terminate. Does nothing if already installed.
+   *
+   * The signals handled are SIGSEGV, SIGABRT, SIGFPE, SIGILL and (except on Windows) SIGBUS.
+   */
+  void install();
+
+  /**
+   * @brief Registers a listener to be called on a crash.
+   *
+   * At most 64 listeners are registered at a time; further ones are not called.
+   * @param listener The listener to register.
+   */
+  void registerListener(CrashListener* listener) noexcept;
+
+  /**
+   * @brief Unregisters a listener. Must be called before the listener is destroyed.
+   * @param listener The listener to unregister.
+   */
+  void unregisterListener(CrashListener* listener) noexcept;
+
+} // namespace Logify::crash
@@ -0,0 +1,158 @@
+/*
+ * Logify Logger Library - Internal Crash Writer
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the CrashWriter class, which formats log records into a
+ * fixed-size buffer and writes them to a file descriptor. It neither allocates memory
+ * nor takes locks, so it can be used from a fatal signal handler, where only
+ * async-signal-safe functions such as write(2) may be called.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Logify/Logger.h"
+#include "Logify/Field.h"
+#include "RecordQueue.h"
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+
+namespace Logify
+{
+
+  /**
+   * @brief Writes a whole buffer to a file descriptor, retrying on partial writes and EINTR.
+   *
+   * Only calls write(2) (or _write on Windows), so it is async-signal-safe.
+   * @param fd The file descriptor to write to.
+   * @param data The data to write.
+   * @param size The number of bytes to write.
+   * @return True if all bytes were written, false on error.
+   */
+  bool writeAll(int fd, const char* data, std::size_t size) noexcept;
+
+  /**
+   * @brief Writes a whole buffer to a file descriptor at the given offset, retrying on partial writes and EINTR.
+   *
+   * Uses pwrite(2), so the file offset of the descriptor is not changed. The descriptor must not be
+   * opened for appending, or the data is appended instead. On Windows, seeks and writes instead.
+   * @param fd The file descriptor to write to.
+   * @param data The data to write.
+   * @param size The number of bytes to write.
+   * @param offset The position in the file to write the data at.
+   * @return True if all bytes were written, false on error.
+   */
+  bool writeAllAt(int fd, const char* data, std::size_t size, std::uint64_t offset) noexcept;
+
+  /**
+   * @class CrashWriter
+   * @brief Formats log records into a fixed buffer and writes them to a file descriptor.
+   *
+   * Timestamps are written in UTC ("2026-10-18 13:48:03.123 UTC"), because converting to local
+   * time is not async-signal-safe. The buffer is written when it is full and on destruction.
+   */
+  class CrashWriter
+  {
+   public:
+	  /**
+	   * @brief Constructs a CrashWriter for the given file descriptor.
+	   * @param fd The file descriptor to write to.
+	   */
+	  explicit CrashWriter(int fd) noexcept : fd_(fd), size_(0)
+	  {}
+
+	  /**
+	   * @brief Writes the remaining buffered bytes.
+	   */
+	  ~CrashWriter() { flush(); }
+
+	  CrashWriter(const CrashWriter&)            = delete;
+	  CrashWriter& operator=(const CrashWriter&) = delete;
+
+	  /**
+	   * @brief Appends text to the buffer.
+	   */
+	  void append(std::string_view text) noexcept;
+
+	  /**
+	   * @brief Appends the decimal representation of a number.
+	   */
+	  template<typename T>
+	  void appendNumber(T value) noexcept
+	  {
+		  char buffer[32];
+		  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		  append(std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)));
+	  }
+
+	  /**
+	   * @brief Appends a point in time as a UTC date and time with milliseconds.
+	   */
+	  void appendTimestamp(std::chrono::system_clock::time_point time) noexcept;
+
+	  /**
+	   * @brief Appends text with the JSON special characters escaped.
+	   */
+	  void appendJsonEscaped(std::string_view text) noexcept;
+
+	  /**
+	   * @brief Appends text with the HTML special characters escaped.
+	   */
+	  void appendHtmlEscaped(std::string_view text) noexcept;
+
+	  /**
+	   * @brief Appends a queued record as a line of text.
+	   *
+	   * The line has the form "[timestamp][ID:pid/tid][LEVEL]" + separator + "message key=value...\n".
+	   * @param record The record to append.
+	   * @param separator The text between the level and the message, e.g. ": " for consoles.
+	   */
+	  void appendTextLine(const QueuedRecord& record, std::string_view separator) noexcept;
+
+	  /**
+	   * @brief Appends a queued record as a JSON object on its own line, as in JSON Lines files.
+	   */
+	  void appendJsonLine(const QueuedRecord& record) noexcept;
+
+	  /**
+	   * @brief Appends a queued record as a row of the table of HTML log files.
+	   */
+	  void appendHtmlRow(const QueuedRecord& record) noexcept;
+
+	  /**
+	   * @brief Writes the buffered bytes to the file descriptor.
+	   */
+	  void flush() noexcept;
+
+   private:
+	  /**
+	   * @brief Appends the value of a field as text, quoting strings.
+	   */
+	  void appendFieldValue(const Field& field) noexcept;
+
+	  /**
+	   * @brief Appends the value of a field as a JSON value.
+	   */
+	  void appendJsonValue(const Field& field) noexcept;
+
+   private:
+	  int         fd_;            ///< The file descriptor to write to.
+	  std::size_t size_;          ///< Number of bytes in buffer_.
+	  char        buffer_[4096];  ///< The bytes not yet written.
+  };
+
+} // namespace Logify
@@ -8,8 +8,8 @@
  * Description:
  * This header file defines the FileStream class, an internal component of the Logify
  * library used for managing file output streams for logging. The class handles writing
- * log messages to files, rotating files based on size, and ensuring file integrity
- * across log sessions.
+ * log messages to files, rotating files based on size, and keeping HTML files valid
+ * documents at all times.
  *
  * Note:
  * This file is part of the internal implementation of the Logify library and is not
@@ -24,8 +24,11 @@
 
 #include <string>
 #include <memory>
-#include <fstream>
 #include "Logify/ColorScheme.h"
+#include "Sink.h"
+#include "RecordQueue.h"
+#include "RetentionWorker.h"
+#include "LogIndex.h"
 
 
 namespace Logify
@@ -37,8 +40,9 @@ namespace Logify
    */
   enum class FileExtension
   {
-	  LOG,  ///< Standard text-based log files.
-	  HTML  ///< HTML formatted log files.
+	  LOG,   ///< Standard text-based log files.
+	  HTML,  ///< HTML formatted log files.
+	  JSONL  ///< JSON Lines files, one JSON object per log message.
   };
 
   /**
@@ -51,50 +55,130 @@ namespace Logify
    * @brief Manages file output streams for logging, including file rotation and integrity checks.
    *
    * The FileStream class is responsible for writing log messages to files, rotating files when
-   * they exceed a specified size, and maintaining the correct file format. It supports both
-   * plain text and HTML log files.
+   * they exceed a specified size, and maintaining the correct file format. It supports plain
+   * text, HTML and JSON Lines log files.
+   *
+   * Nothing is read or created when the stream is constructed: the file is opened on the first
+   * message, continuing the file with the highest index found by a single directory scan.
+   * With a rotation interval, the local time period ("2026-10-18" or "2026-10-18_13") is part
+   * of the file name, and a new file is started when a record's time reaches the next period.
+   * The file is written through its file descriptor. LOG and JSONL entries are written one by one;
+   * HTML rows are collected in a buffer of up to BufferCapacity bytes. Each batch of HTML rows is
+   * written together with the closing tags, over the closing tags of the previous batch, so the file
+   * is a complete document at any moment. Both the buffer and the open descriptor can be written
+   * from a fatal signal handler. With an index interval, the time index of each file is appended
+   * to as the records are written, not built afterwards; the part since the last entry is written on close.
    */
-  class FileStream
+  class FileStream : public Sink
   {
    public:
 	  /**
-	   * @brief Constructs a FileStream with the specified file name, maximum file size, and color scheme.
+	   * @brief Constructs a FileStream with the specified file name and options.
 	   * @param filename The base name of the log file.
-	   * @param maxFileSize The maximum size of the log file before rotation occurs.
-	   * @param scheme The color scheme used for formatting log messages in HTML files.
+	   * @param options The maximum file size, color scheme, minimum level and retention limits.
 	   */
-	  FileStream(const std::string& filename, std::size_t maxFileSize, const ColorScheme& scheme);
+	  FileStream(const std::string& filename, const FileStreamOptions& options);
 
 	  /**
 	   * @brief Destroys the FileStream, ensuring the file stream is closed properly.
 	   */
-	  ~FileStream();
+	  ~FileStream() override;
 
 	  /**
-	   * @brief Writes a log message to the file.
-	   * @param timestamp The timestamp of the log message.
-	   * @param pid The process ID associated with the log message.
-	   * @param tid The thread ID associated with the log message.
-	   * @param level The log level of the message.
-	   * @param message The actual log message to write.
+	   * @brief Retrieves the name of this sink: the log file name without the rotation index.
 	   */
-	  void write(
-		  const std::string& timestamp,
-		  const std::string& pid,
-		  const std::string& tid,
-		  const std::string& level,
-		  const std::string& message,
-		  size_t indent
-	  );
+	  [[nodiscard]] std::string name() const override;
+
+	  /**
+	   * @brief Writes the buffered entries to the file from a fatal signal handler.
+	   */
+	  void flushAfterCrash() noexcept override;
+
+	  /**
+	   * @brief Writes a queued record to the file from a fatal signal handler, in the file's format.
+	   * @param record The queued record to write.
+	   */
+	  void writeAfterCrash(const QueuedRecord& record) noexcept override;
+
+	  static constexpr std::size_t BufferCapacity = 8192;  ///< Bytes of HTML rows buffered before writing.
+
+   protected:
+	  /**
+	   * @brief Writes a log record to the file.
+	   * @param record The log record to write.
+	   */
+	  void write(const LogRecord& record) override;
+
+	  /**
+	   * @brief Writes the buffered entries to the file.
+	   */
+	  void sync() override;
+
+	  /**
+	   * @brief Moves the stream of a forked child to files of its own.
+	   *
+	   * The file inherited from the parent is left to the parent, without writing to it: the
+	   * child continues with files whose base name ends with its process ID, e.g. "app.4242".
+	   * The retention worker of the parent is given up; the child starts its own with its first file.
+	   */
+	  void childAfterFork() override;
 
    private:
 	  /**
 	   * @brief Opens a new log file for writing.
 	   *
 	   * If the log file already exists, it appends to the file. Otherwise, it creates a new file.
+	   * The first call continues with the file of the highest existing index. If the file cannot
+	   * be opened, fd_ stays -1. An existing HTML file is continued only if canContinueHtml()
+	   * holds, so that the next entries overwrite its closing tags; otherwise the next index is used.
 	   */
 	  void openFile();
 
+	  /**
+	   * @brief Checks that the open HTML file ends with the closing tags and has the columns of the rows.
+	   *
+	   * Reads the last bytes and the header of the file once, when it is opened.
+	   * @return True if the next entries can be written over the closing tags.
+	   */
+	  [[nodiscard]] bool canContinueHtml() const;
+
+	  /**
+	   * @brief Closes the current log file after writing the buffered entries.
+	   */
+	  void closeFile();
+
+	  /**
+	   * @brief Starts the time period containing the given time, closing the file of the previous period.
+	   *
+	   * Converts the time to local time once, to name the period and compute nextRotation_.
+	   * @param time The time of the record that reached the deadline.
+	   */
+	  void startPeriod(std::chrono::system_clock::time_point time);
+
+	  /**
+	   * @brief Writes the buffer to the file and clears it, counting the flush or a write error.
+	   */
+	  void flushBuffer();
+
+	  /**
+	   * @brief Reserves disk space in chunks of preallocate_ bytes, so that the file can grow to the given size.
+	   * @param size The size the file is about to reach.
+	   */
+	  void reserveSpace(std::uint64_t size);
+
+	  /**
+	   * @brief Adds a record to the current part of the time index, writing the part's entry once it spans the index interval.
+	   * @param record The record about to be written.
+	   * @param offset The position of the record in the file.
+	   * @param size The size of the record in the file.
+	   */
+	  void indexRecord(const LogRecord& record, std::uint64_t offset, std::size_t size);
+
+	  /**
+	   * @brief Appends the entry of the current part to the time index, if it holds records. Async-signal-safe.
+	   */
+	  void writeIndexEntry() noexcept;
+
 	  /**
 	   * @brief Generates a file path based on the current file index and extension.
 	   * @return A string representing the generated file path.
@@ -110,30 +194,25 @@ namespace Logify
 
 	  /**
 	   * @brief Checks if the current log file should be rotated based on its size.
+	   *
+	   * The size is tracked while writing, so no file system call is made.
 	   * @return True if the file should be rotated, otherwise false.
 	   */
 	  [[nodiscard]] bool shouldRotate() const;
 
 	  /**
-	   * @brief Verifies the integrity of the current log file.
-	   * @return True if the file is intact, otherwise false.
+	   * @brief Finds the highest index of the existing log files of the current period with a single directory scan.
+	   * @return The highest index, or 0 if there are no log files yet.
 	   */
-	  [[nodiscard]] bool isFileIntact();
+	  [[nodiscard]] int findLastIndex() const;
 
 	  /**
-	   * @brief Validates that the log file ends with the expected end tags.
-	   * @param filePath The path to the log file.
-	   * @param expectedEnd The expected ending string (e.g., HTML tags).
-	   * @return True if the file ends with the expected tags, otherwise false.
-	   */
-	  static bool validateEndTags(const std::string& filePath, const std::string& expectedEnd);
-
-	  /**
-	   * @brief Truncates the log file at the specified position.
-	   * @param filePath The path to the log file.
-	   * @param truncatePosition The position from which to truncate the file.
+	   * @brief Retrieves the position at which the next entries are written.
+	   *
+	   * For HTML files, this is the start of the closing tags, which the entries overwrite.
+	   * @return The position in the current file.
 	   */
-	  static void truncateFileEnd(const std::string& filePath, std::streamoff truncatePosition);
+	  [[nodiscard]] std::uint64_t writeOffset() const noexcept;
 
 	  /**
 	   * @brief Replaces occurrences of a substring within a string with another substring.
@@ -156,19 +235,32 @@ namespace Logify
 	  static std::string extractExtension(const std::string& filename);
 
 	  /**
-	   * @brief Determines the file extension type (LOG or HTML) from a string.
+	   * @brief Determines the file extension type (LOG, HTML or JSONL) from a string.
 	   * @param extension The file extension string.
 	   * @return The corresponding FileExtension enum value.
 	   */
 	  static FileExtension determineExtensionType(const std::string& extension);
    private:
-	  std::string                    logFileName_;    ///< The base name of the log file.
-	  std::string                    extensionName_;  ///< The extension of the log file (e.g., ".log", ".html").
-	  FileExtension                  extension_;      ///< The type of the file extension.
-	  std::size_t                    maxFileSize_;    ///< The maximum file size before rotation.
-	  int                            fileIndex_;      ///< Index for file rotation.
-	  std::unique_ptr<std::ofstream> fileStream_;     ///< Output file stream for writing log messages.
-	  ColorScheme                    colorScheme_;    ///< The color scheme used for HTML log files.
+	  std::string                           logFileName_;    ///< The base name of the log file.
+	  std::string                           extensionName_;  ///< The extension of the log file (e.g., ".log", ".html").
+	  FileExtension                         extension_;      ///< The type of the file extension.
+	  std::size_t                           maxFileSize_;    ///< The maximum file size before rotation.
+	  int                                   fileIndex_;      ///< Index for file rotation.
+	  RotationInterval                      rotation_;       ///< Rotation at wall-clock boundaries, if any.
+	  std::string                           period_;         ///< The time period in the file name, or empty.
+	  std::chrono::system_clock::time_point nextRotation_;   ///< The start of the next time period.
+	  bool                                  scanned_;        ///< Whether the existing files were scanned for the last index.
+	  int                                   fd_;             ///< File descriptor of the current log file, or -1.
+	  std::uint64_t                         fileSize_;       ///< Size of the current log file with its closing tags, without the buffer.
+	  std::size_t                           preallocate_;    ///< Chunk size of reserved disk space, or 0.
+	  std::uint64_t                         allocatedEnd_;   ///< End of the disk space reserved for the file.
+	  std::size_t                           indexInterval_;  ///< Bytes between the entries of the time index, or 0.
+	  int                                   indexFd_;        ///< File descriptor of the time index, or -1.
+	  IndexEntry                            indexEntry_;     ///< The part of the file not yet in the time index.
+	  std::string                           buffer_;         ///< Entries not yet written to the file.
+	  ColorScheme                           colorScheme_;    ///< The color scheme used for HTML log files.
+	  RetentionLimits                       limits_;         ///< The retention limits on the rotated files; none if all are zero.
+	  std::unique_ptr<RetentionWorker>      retention_;      ///< Deletes old files, if retention limits are set.
   };
 
 } // namespace Logify
\ No newline at end of file
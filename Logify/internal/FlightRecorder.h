@@ -0,0 +1,120 @@
+/*
+ * Logify Logger Library - Internal Flight Recorder
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the FlightRecorder class, which keeps the most recent records
+ * that were not written because of their level in per-thread rings in memory. The records
+ * are copied unformatted into reused slots, and are only formatted when they are taken out
+ * for writing after an incident.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "LogRecord.h"
+#include "RecordQueue.h"
+#include "RecordRing.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Logify
+{
+
+  /**
+   * @class FlightRecorder
+   * @brief Keeps the last records of each thread in fixed-size rings, overwriting the oldest.
+   *
+   * Each thread records into its own ring, under a lock that only the thread itself and
+   * takeRecords() use, so recording threads never contend with each other. Recording copies
+   * the message and fields into a fixed-size slot, spilling only large records into the
+   * ring's arena. The ring of a thread that has exited keeps its records and is reused by
+   * the next new thread.
+   */
+  class FlightRecorder
+  {
+   public:
+	  /**
+	   * @brief Constructs a FlightRecorder.
+	   * @param recordsPerThread The number of records kept per thread (at least 1).
+	   */
+	  explicit FlightRecorder(std::size_t recordsPerThread);
+
+	  FlightRecorder(const FlightRecorder&)            = delete;
+	  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+	  /**
+	   * @brief Copies a record into the calling thread's ring, overwriting its oldest record if it is full.
+	   * @param record The record to keep. The formatted timestamp is not copied.
+	   */
+	  void record(const LogRecord& record);
+
+	  /**
+	   * @brief Moves the records of all rings into a vector, ordered by time, and empties the rings.
+	   *
+	   * The records are moved into the elements of the vector, releasing the records previously
+	   * taken into them.
+	   * @param records The vector receiving the records.
+	   */
+	  void takeRecords(std::vector<QueuedRecord>& records);
+
+	  /**
+	   * @brief Takes the locks of all rings before a fork, so that no ring is changing in the child.
+	   */
+	  void lockForFork();
+
+	  /**
+	   * @brief Releases the locks taken by lockForFork() in the parent.
+	   */
+	  void unlockInParent();
+
+	  /**
+	   * @brief Releases the locks taken by lockForFork() in the child.
+	   *
+	   * The rings of the parent's other threads, which do not exist in the child, keep their
+	   * records and are reused by the child's new threads.
+	   */
+	  void unlockInChild();
+
+   private:
+	  /**
+	   * @struct ThreadRing
+	   * @brief The ring of one thread.
+	   */
+	  struct ThreadRing
+	  {
+		  explicit ThreadRing(std::size_t capacity) : records(capacity), owner(std::this_thread::get_id())
+		  {}
+
+		  std::mutex      mutex;    ///< Held while recording and while taking the records.
+		  RecordRing      records;  ///< The last records of the thread.
+		  std::thread::id owner;    ///< The thread recording into the ring; default if it has exited.
+	  };
+
+	  /**
+	   * @brief Retrieves the ring of the calling thread, assigning one on its first call.
+	   */
+	  ThreadRing& threadRing();
+
+   private:
+	  std::uint64_t                            id_;                ///< Unique identifier, for the thread-local lookup.
+	  std::size_t                              recordsPerThread_;  ///< The number of slots of each ring.
+	  std::mutex                               ringsMutex_;        ///< Protects rings_.
+	  std::vector<std::shared_ptr<ThreadRing>> rings_;             ///< The rings of all threads that recorded.
+  };
+
+} // namespace Logify
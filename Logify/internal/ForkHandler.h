@@ -0,0 +1,187 @@
+/*
+ * Logify Logger Library - Internal Fork Handler
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file declares the fork handler of the Logify library. It registers
+ * pthread_atfork handlers once, through which every live Logger takes its locks before
+ * fork(), releases them in the parent, and in the child releases them and leaves the
+ * parent's threads, files and connections to the parent. The child starts threads of its
+ * own on its first use of a logger, as none may be started from the handlers.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+
+
+namespace Logify
+{
+
+  /**
+   * @class ForkListener
+   * @brief Interface of objects that keep working in the child of a fork.
+   *
+   * Only the thread calling fork() exists in the child. A lock held by any other thread at
+   * that moment would stay locked forever, so listeners take their locks in prepareFork()
+   * and release them in both processes afterwards.
+   *
+   * The child handler may not start threads. A listener gives up the parent's threads there
+   * or on its first use in the child, which it notices by forking::generation(), and starts
+   * its own threads on that first use.
+   */
+  class ForkListener
+  {
+   public:
+	  /**
+	   * @brief Takes the locks of the listener. Called in the parent, just before the fork.
+	   */
+	  virtual void prepareFork() noexcept = 0;
+
+	  /**
+	   * @brief Releases the locks taken by prepareFork(). Called in the parent after the fork.
+	   */
+	  virtual void parentAfterFork() noexcept = 0;
+
+	  /**
+	   * @brief Releases the locks taken by prepareFork() and forgets what belongs to the parent. Called in the child.
+	   */
+	  virtual void childAfterFork() noexcept = 0;
+
+   protected:
+	  ~ForkListener() = default;
+  };
+
+  /**
+   * @class ForkSafeSharedMutex
+   * @brief A read-write lock that the thread calling fork() can release in the child.
+   *
+   * A std::shared_mutex knows its writer by the thread ID, which is new in the child, so the
+   * child cannot unlock what the parent locked in prepareFork(). This lock keeps writers out
+   * of each other with a plain mutex, which the child may unlock, and counts its readers in an
+   * atomic. Readers only touch the counter while no writer is waiting. Writers are rare: they
+   * wait for the readers to leave, and readers arriving meanwhile wait for the writer.
+   */
+  class ForkSafeSharedMutex
+  {
+   public:
+	  /**
+	   * @brief Takes the lock exclusively, waiting for the readers to leave.
+	   */
+	  void lock()
+	  {
+		  writerMutex_.lock();
+		  writing_.store(true);
+		  while (readers_.load() != 0) std::this_thread::yield();
+	  }
+
+	  /**
+	   * @brief Releases the exclusive lock; also in the child, by the thread that took it before the fork.
+	   */
+	  void unlock()
+	  {
+		  writing_.store(false);
+		  writerMutex_.unlock();
+	  }
+
+	  /**
+	   * @brief Takes the lock shared, waiting while a writer holds or waits for it.
+	   */
+	  void lock_shared()
+	  {
+		  while (true)
+		  {
+			  readers_.fetch_add(1);
+			  if (!writing_.load()) return;
+
+			  // Step back for the writer and wait until it is done.
+			  readers_.fetch_sub(1);
+			  std::lock_guard<std::mutex> wait(writerMutex_);
+		  }
+	  }
+
+	  /**
+	   * @brief Releases the shared lock.
+	   */
+	  void unlock_shared()
+	  {
+		  readers_.fetch_sub(1, std::memory_order_release);
+	  }
+
+   private:
+	  std::mutex               writerMutex_;     ///< Held by the writer; readers wait on it.
+	  std::atomic<bool>        writing_{false};  ///< Set while a writer holds or waits for the lock.
+	  std::atomic<std::size_t> readers_{0};      ///< The number of readers holding the lock.
+  };
+
+} // namespace Logify
+
+namespace Logify::forking
+{
+
+  /**
+   * @brief Registers a listener, installing the fork handlers on the first call. Does nothing on Windows.
+   *
+   * Listeners are prepared in the order of registration and resumed in the reverse order.
+   * @param listener The listener to register.
+   */
+  void registerListener(ForkListener* listener);
+
+  /**
+   * @brief Unregisters a listener. Must be called before the listener is destroyed.
+   *
+   * Waits if a fork is in progress, so the listener is not destroyed while it holds its locks.
+   * @param listener The listener to unregister.
+   */
+  void unregisterListener(ForkListener* listener) noexcept;
+
+  /**
+   * @brief Retrieves the number of forks between the start of the program and the current process.
+   *
+   * Caches of per-process values, such as process and thread IDs, compare it to notice a fork.
+   */
+  [[nodiscard]] std::uint64_t generation() noexcept;
+
+  /**
+   * @brief Gives up an object of the parent that the child can neither use nor destroy.
+   *
+   * The parent's threads do not exist in the child: their std::thread objects can be neither
+   * joined, detached nor destroyed, and the mutexes and condition variables they used may be
+   * held or waited on forever. Such an object, or whatever holds it, is moved to storage that
+   * is never freed, leaving the given object empty. This leaks the object once per fork.
+   * @param object The object of the parent, empty afterwards.
+   */
+  template<typename T>
+  void abandon(T& object) noexcept
+  {
+	  (void) new (std::nothrow) T(std::move(object));
+  }
+
+  /**
+   * @brief Gives up the object owned by a pointer, like abandon(T&), without moving it.
+   * @param object The pointer to the object of the parent, null afterwards.
+   */
+  template<typename T>
+  void abandon(std::unique_ptr<T>& object) noexcept
+  {
+	  (void) object.release();
+  }
+
+} // namespace Logify::forking
@@ -0,0 +1,145 @@
+/*
+ * Logify Logger Library - Internal Formatting Helpers
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file provides small formatting helpers shared by the output streams of
+ * the Logify library: level names, allocation-free number encoding and the rendering
+ * of typed fields as text or JSON.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Logify/Logger.h"
+#include "Logify/Field.h"
+#include "LogRecord.h"
+#include <charconv>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+
+namespace Logify::format
+{
+
+  /**
+   * @brief Converts a LogLevel to its fixed-width (5 characters) label, as used in text output.
+   * @param level The log level to convert.
+   * @return The padded label, e.g. "INFO ".
+   */
+  constexpr std::string_view levelLabel(LogLevel level)
+  {
+	  switch (level)
+	  {
+		  case LogLevel::TRACE:
+			  return "TRACE";
+		  case LogLevel::DEBUG:
+			  return "DEBUG";
+		  case LogLevel::INFO:
+			  return "INFO ";
+		  case LogLevel::WARN:
+			  return "WARN ";
+		  case LogLevel::ERROR:
+			  return "ERROR";
+		  case LogLevel::FATAL:
+			  return "FATAL";
+		  default:
+			  return "?";
+	  }
+  }
+
+  /**
+   * @brief Converts a LogLevel to its name without padding, as used in structured output.
+   * @param level The log level to convert.
+   * @return The level name, e.g. "INFO".
+   */
+  constexpr std::string_view levelName(LogLevel level)
+  {
+	  std::string_view label = levelLabel(level);
+	  return label.substr(0, label.find_last_not_of(' ') + 1);
+  }
+
+  /**
+   * @brief Converts a level name to a LogLevel, ignoring case and surrounding whitespace.
+   * @param name The name, e.g. "DEBUG" or "debug\n".
+   * @return The level, or std::nullopt if the name is not one of the level names.
+   */
+  std::optional<LogLevel> parseLevel(std::string_view name);
+
+  /**
+   * @brief Appends the decimal representation of a number using std::to_chars.
+   * @param out The string to append to.
+   * @param value The number to append.
+   */
+  template<typename T>
+  void appendNumber(std::string& out, T value)
+  {
+	  char buffer[32];
+	  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	  out.append(buffer, result.ptr);
+  }
+
+  /**
+   * @brief Appends the value of a field as text.
+   *
+   * Strings are quoted (and escaped) only if they are empty or contain spaces, quotes,
+   * '=' or control characters, so that the key=value output stays unambiguous.
+   * @param out The string to append to.
+   * @param field The field whose value to append.
+   */
+  void appendFieldValue(std::string& out, const Field& field);
+
+  /**
+   * @brief Appends fields as " key=value" pairs, as used by text output.
+   * @param out The string to append to.
+   * @param fields The fields to append.
+   */
+  void appendKeyValues(std::string& out, std::span<const Field> fields);
+
+  /**
+   * @brief Appends the value of a field as a JSON value of its native type.
+   *
+   * Non-finite floating-point numbers, which JSON cannot represent, are written as null.
+   * @param out The string to append to.
+   * @param field The field whose value to append.
+   */
+  void appendJsonValue(std::string& out, const Field& field);
+
+  /**
+   * @brief Appends fields as the members of a JSON object, without the enclosing braces.
+   * @param out The string to append to.
+   * @param fields The fields to append.
+   */
+  void appendJsonMembers(std::string& out, std::span<const Field> fields);
+
+  /**
+   * @brief Appends a log record as a line of text, as written to consoles and output streams.
+   *
+   * The line has the form "[timestamp][ID:pid/tid][LEVEL]: message key=value...\n".
+   * @param out The string to append to.
+   * @param record The log record to append.
+   */
+  void appendTextLine(std::string& out, const LogRecord& record);
+
+  /**
+   * @brief Appends a log record as a line of JSON, as written to JSON Lines files.
+   *
+   * The object has the members "ts" (nanoseconds since the epoch), "pid", "tid", "level",
+   * "message" and, if there are any, "fields".
+   * @param out The string to append to.
+   * @param record The log record to append.
+   */
+  void appendJsonLine(std::string& out, const LogRecord& record);
+
+} // namespace Logify::format
@@ -0,0 +1,129 @@
+/*
+ * Logify Logger Library - Internal Level Control
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file declares the ways of changing the level of a running Logger from
+ * outside the program: the LOGIFY_LEVEL environment variable, a watched level file and
+ * the SIGUSR1/SIGUSR2 signals. All of them store into the atomic level that the logging
+ * calls read anyway, so none adds work to a logging call.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Logify/Logger.h"
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+
+
+namespace Logify::levels
+{
+
+  /**
+   * @brief Reads the level named by the LOGIFY_LEVEL environment variable.
+   * @return The level, or std::nullopt if the variable is not set or names no level.
+   */
+  [[nodiscard]] std::optional<LogLevel> fromEnvironment();
+
+  /**
+   * @brief Installs the handlers of SIGUSR1 and SIGUSR2. Does nothing if already installed, or on Windows.
+   *
+   * SIGUSR1 lowers the level of every registered target by one step, e.g. from INFO to DEBUG;
+   * SIGUSR2 raises it by one step.
+   */
+  void installSignals();
+
+  /**
+   * @brief Registers a level changed by the signals. At most 64 levels are registered at a time.
+   * @param level The level to change.
+   */
+  void registerTarget(std::atomic<LogLevel>* level) noexcept;
+
+  /**
+   * @brief Unregisters a level, waiting for the signal handlers that may still be changing it.
+   *
+   * Must be called before the level is destroyed.
+   * @param level The level to unregister.
+   */
+  void unregisterTarget(std::atomic<LogLevel>* level) noexcept;
+
+
+  /**
+   * @class LevelFileWatcher
+   * @brief Sets a level from a file holding a level name, e.g. "DEBUG", whenever the file is written.
+   *
+   * On Linux, a background thread waits for inotify events of the file's directory, so that the
+   * file may also be replaced by renaming another file over it. Elsewhere, the thread checks the
+   * modification time of the file every PollInterval. A file that is missing or names no level
+   * leaves the level unchanged.
+   */
+  class LevelFileWatcher
+  {
+   public:
+	  static constexpr std::chrono::milliseconds PollInterval{100};  ///< How often the thread checks for changes or stopping.
+
+	  /**
+	   * @brief Applies the level in the file, if any, and starts watching it.
+	   * @param path The path of the file.
+	   * @param level The level to set.
+	   * @throws std::runtime_error If the directory of the file cannot be watched.
+	   */
+	  LevelFileWatcher(std::string path, std::atomic<LogLevel>& level);
+
+	  /**
+	   * @brief Stops watching the file.
+	   */
+	  ~LevelFileWatcher();
+
+	  LevelFileWatcher(const LevelFileWatcher&)            = delete;
+	  LevelFileWatcher& operator=(const LevelFileWatcher&) = delete;
+
+	  /**
+	   * @brief Watches the file from the child of a fork, with a new thread and its own inotify instance.
+	   *
+	   * Called on the first use of the logger in the child, not from the fork handler. An inotify
+	   * instance inherited from the parent would share its events with the parent.
+	   * @throws std::runtime_error If the directory of the file cannot be watched.
+	   */
+	  void resumeAfterFork();
+
+   private:
+	  /**
+	   * @brief Creates the inotify instance, on Linux, and starts the thread.
+	   * @throws std::runtime_error If the directory of the file cannot be watched.
+	   */
+	  void start();
+
+	  /**
+	   * @brief The loop of the background thread: waits for changes of the file and applies them.
+	   */
+	  void run();
+
+	  /**
+	   * @brief Reads the file and sets the level it names, if any.
+	   */
+	  void apply();
+
+   private:
+	  std::string            path_;       ///< The path of the file.
+	  std::string            fileName_;   ///< The name of the file within its directory.
+	  std::atomic<LogLevel>& level_;      ///< The level to set.
+	  int                    notifyFd_;   ///< The inotify instance, or -1.
+	  std::atomic<bool>      stopping_;   ///< Set to stop the thread.
+	  std::thread            thread_;     ///< The background thread.
+  };
+
+} // namespace Logify::levels
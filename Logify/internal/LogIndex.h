@@ -0,0 +1,109 @@
+/*
+ * Logify Logger Library - Internal Time Index
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the layout of the sparse time index that FileStream writes
+ * next to each log file ("app_0000.log.idx" for "app_0000.log"), and the lookup of the
+ * byte ranges of a time range in it. The index is shared by the library, which appends
+ * to it while writing, and the logify-query tool, which reads it.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Logify
+{
+
+  /**
+   * @struct IndexEntry
+   * @brief An entry of a time index: a part of the log file and the time range of its records.
+   *
+   * The index file is a sequence of these entries in native byte order, in the order of the parts
+   * in the file. An entry is written once its part spans at least the index interval, so the parts
+   * are a few kilobytes of log file each. The records of a part are usually in time order, but
+   * older records may be written after newer ones; the earliest and latest times cover these too.
+   */
+  struct IndexEntry
+  {
+	  std::int64_t  earliest;  ///< The earliest time of the records of the part, in nanoseconds since the epoch.
+	  std::int64_t  latest;    ///< The latest time of the records of the part, in nanoseconds since the epoch.
+	  std::uint64_t begin;     ///< The position of the first record of the part in the log file.
+	  std::uint64_t end;       ///< The position after the last record of the part.
+  };
+
+  static_assert(sizeof(IndexEntry) == 32, "The index entries are written as 32 bytes");
+
+  /**
+   * @brief Retrieves the path of the index of a log file.
+   * @param filePath The path of the log file, e.g. "app_0000.log".
+   * @return The path of its index, e.g. "app_0000.log.idx".
+   */
+  inline std::string indexPath(const std::string& filePath)
+  {
+	  return filePath + ".idx";
+  }
+
+  /**
+   * @brief Finds the parts of a log file that may hold the records of a time range.
+   *
+   * Selects every part whose time range overlaps the range, and the parts of the file no entry
+   * covers, such as the records written since the last entry; adjacent parts are merged. The
+   * result may hold up to one index interval of records outside the range around each match.
+   * @param entries The entries of the index.
+   * @param count The number of entries.
+   * @param from The start of the time range in nanoseconds since the epoch.
+   * @param to The end of the time range (inclusive) in nanoseconds since the epoch.
+   * @param fileSize The size of the log file.
+   * @return The start and end offsets of the parts, in file order; empty if no record can be in the range.
+   */
+  inline std::vector<std::pair<std::uint64_t, std::uint64_t>> findByteRanges(
+	  const IndexEntry* entries,
+	  std::size_t count,
+	  std::int64_t from,
+	  std::int64_t to,
+	  std::uint64_t fileSize
+  )
+  {
+	  std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+	  auto add = [&ranges, fileSize](std::uint64_t begin, std::uint64_t end) {
+		  begin = std::min(begin, fileSize);
+		  end   = std::min(end, fileSize);
+		  if (begin >= end) return;
+		  if (!ranges.empty() && begin <= ranges.back().second) ranges.back().second = std::max(ranges.back().second, end);
+		  else ranges.emplace_back(begin, end);
+	  };
+
+	  // The parts between entries were not indexed, e.g. written after a crash; they are always read.
+	  std::uint64_t covered = 0;
+	  for (std::size_t i = 0; i < count; ++i)
+	  {
+		  const IndexEntry& entry = entries[i];
+		  if (entry.begin > covered) add(covered, entry.begin);
+		  if (entry.earliest <= to && entry.latest >= from) add(entry.begin, entry.end);
+		  covered = std::max(covered, entry.end);
+	  }
+
+	  // The records written since the last entry are not indexed yet.
+	  add(covered, fileSize);
+	  return ranges;
+  }
+
+} // namespace Logify
@@ -0,0 +1,52 @@
+/*
+ * Logify Logger Library - Internal Log Record
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the LogRecord struct, the unit handed from the Logger to
+ * its output streams. A record carries the raw values of a log message so that each
+ * destination can render them in its own format.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Logify/Logger.h"
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+
+namespace Logify
+{
+
+  /**
+   * @struct LogRecord
+   * @brief A single log message together with its metadata.
+   *
+   * The record does not own its strings; they must outlive the call that writes the record.
+   */
+  struct LogRecord
+  {
+	  LogLevel                              level;      ///< The severity level of the message.
+	  std::uint64_t                         ticks;      ///< The TickClock reading taken when the message was logged.
+	  std::chrono::system_clock::time_point time;       ///< The wall-clock time of ticks, set when the record is formatted.
+	  std::string_view                      timestamp;  ///< The time formatted with the Logger's time format.
+	  std::uint32_t                         pid;        ///< The process ID.
+	  std::uint64_t                         tid;        ///< The OS thread ID.
+	  std::string_view                      message;    ///< The message text.
+	  std::span<const Field>                fields;     ///< The typed key/value fields of the message.
+	  std::size_t                           indent;     ///< The scope indentation level.
+  };
+
+} // namespace Logify
@@ -0,0 +1,61 @@
+/*
+ * Logify Logger Library - Internal Log Segments
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file declares the functions that find the rotated files ("segments") of a
+ * log file stream on disk, such as "app_0000.log", "app_0001.log", ... for "app.log", or
+ * "app_2026-10-18_0000.log" for streams rotated by time.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+namespace Logify
+{
+
+  /**
+   * @struct LogSegment
+   * @brief A rotated file of a log file stream.
+   */
+  struct LogSegment
+  {
+	  std::string           period;  ///< The time period in the file name, e.g. "2026-10-18", or empty.
+	  int                   index;   ///< The rotation index in the file name.
+	  std::filesystem::path path;    ///< The path of the file.
+
+	  /**
+	   * @brief Orders segments from oldest to newest: by period, then by index.
+	   */
+	  [[nodiscard]] bool isOlderThan(const std::string& otherPeriod, int otherIndex) const
+	  {
+		  return std::tie(period, index) < std::tie(otherPeriod, otherIndex);
+	  }
+  };
+
+  /**
+   * @brief Finds the segments of a log file stream with a single directory scan.
+   *
+   * Only the names in the directory are read; no file is opened or queried.
+   * @param baseName The file name of the stream without extension, e.g. "logs/app".
+   * @param extension The extension of the files without the dot, e.g. "log".
+   * @return The segments, in no particular order.
+   */
+  std::vector<LogSegment> findLogSegments(const std::string& baseName, const std::string& extension);
+
+} // namespace Logify
@@ -24,30 +24,29 @@
 
 
 #include "Logify/Logger.h"
-#include "FileStream.h"
-#include <vector>
+#include "Sink.h"
+#include "LogRecord.h"
+#include "RecordQueue.h"
+#include "ShardedCounters.h"
+#include "CrashHandler.h"
+#include "ForkHandler.h"
+#include "LevelControl.h"
+#include "FlightRecorder.h"
+#include "RecordRing.h"
+#include "SharedRing.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
+#include <vector>
+#include <shared_mutex>
 #include <thread>
 
 
 namespace Logify
 {
 
-  /**
-   * @brief ANSI color codes for console output.
-   *
-   * These constants are used to colorize log messages when output to a console
-   * that supports ANSI color codes.
-   */
-  namespace ConsoleColors
-  {
-	static constexpr const char* Grey   = "\033[90m";  ///< Grey color for low-importance messages.
-	static constexpr const char* White  = "\033[97m";  ///< White color for standard messages.
-	static constexpr const char* Yellow = "\033[93m";  ///< Yellow color for warning messages.
-	static constexpr const char* Red    = "\033[91m";  ///< Red color for error messages.
-	static constexpr const char* Reset  = "\033[0m";   ///< Reset color formatting to default.
-  } // namespace ConsoleColors
-
   /**
    * @class Logger::Impl
    * @brief The internal implementation class for Logger.
@@ -56,7 +55,7 @@ namespace Logify
    * message formatting, output to streams, and file management. It is designed to be
    * used internally by the Logger class and is not intended for direct use by library users.
    */
-  class Logger::Impl
+  class Logger::Impl : public CrashListener, public ForkListener
   {
    public:
 	  /**
@@ -66,55 +65,170 @@ namespace Logify
 	   */
 	  explicit Impl(LogLevel level, std::string format = "%d.%m.%Y %H:%M:%S");
 
+	  /**
+	   * @brief Destroys the Logger::Impl, writing all queued records before the sinks are closed.
+	   */
+	  ~Impl();
+
 	  /**
 	   * @brief Determines if a message of a given log level should be logged.
+	   *
+	   * Checks the Logger's level and the lowest minimum level of its sinks, without taking any lock.
 	   * @param level The log level to check.
 	   * @return True if the message should be logged, otherwise false.
 	   */
 	  [[nodiscard]] bool shouldLog(LogLevel level) const;
 
 	  /**
-	   * @brief Converts a LogLevel to its string representation.
-	   * @param level The log level to convert.
-	   * @return A string representing the log level.
+	   * @brief Formats a point in time according to the timeFormat_, in the timeZone_.
+	   *
+	   * No time zone function of the C library is called, except when local time enters a new
+	   * daylight saving time period.
+	   * @param time The point in time to format.
+	   * @return A string representing the given time.
+	   */
+	  [[nodiscard]] std::string formatTime(std::chrono::system_clock::time_point time) const;
+
+	  /**
+	   * @brief Adds a sink to the logger.
+	   * @param sink The sink to add.
+	   */
+	  void addSink(std::unique_ptr<Sink> sink);
+
+	  /**
+	   * @brief Writes a log record to every sink that accepts its level.
+	   *
+	   * Sinks whose minimum level is above the record's level are skipped before locking;
+	   * the others are written one by one, each under its own lock.
+	   * @param record The log record to write.
+	   */
+	  void dispatch(const LogRecord& record);
+
+	  /**
+	   * @brief Writes the queued records, then the data buffered by every sink.
+	   *
+	   * Returns once everything logged before the call has been handed to the operating system.
+	   */
+	  void flushAll();
+
+	  /**
+	   * @brief Writes the records of the flight recorder to every sink, regardless of the sinks' levels.
+	   */
+	  void dumpFlightRecorder();
+
+	  /**
+	   * @struct ThreadScope
+	   * @brief The ScopedLogger scopes of one thread for this logger, and the records held in them.
+	   */
+	  struct ThreadScope
+	  {
+		  ThreadScope(std::uint64_t owner, std::weak_ptr<const Impl> alive, std::size_t capacity)
+			  : loggerId(owner), logger(std::move(alive)), depth(0), records(capacity)
+		  {}
+
+		  std::uint64_t             loggerId; ///< The identifier of the logger whose scopes these are; never reused.
+		  std::weak_ptr<const Impl> logger;   ///< Expires when the logger is destroyed.
+		  std::size_t               depth;    ///< Number of open scopes; records are held while above zero.
+		  RecordRing                records;  ///< The held records, the oldest overwritten when full.
+		  std::vector<QueuedRecord> taken;    ///< The records taken out for writing, whose slots are reused.
+	  };
+
+	  /**
+	   * @brief Counts a ScopedLogger scope entered by the calling thread, if scope buffering is enabled.
+	   */
+	  void enterScope();
+
+	  /**
+	   * @brief Counts a scope left by the calling thread; the held records are discarded with the outermost scope.
+	   */
+	  void leaveScope();
+
+	  /**
+	   * @brief Retrieves the scopes of the calling thread if it is inside one, otherwise nullptr.
+	   */
+	  ThreadScope* currentScope();
+
+	  /**
+	   * @brief Writes the records held in the calling thread's scopes to every sink, regardless of their levels.
+	   * @param scope The scopes of the calling thread.
+	   */
+	  void flushScope(ThreadScope& scope);
+
+	  /**
+	   * @brief Writes the buffered data of the sinks and the queued records from the crash handler.
+	   *
+	   * Takes no lock, as the crashed thread may hold any of them.
+	   */
+	  void writeAfterCrash() noexcept override;
+
+	  /**
+	   * @brief Takes the locks of followFork(), the flight recorder, the sink list and every sink before a fork.
+	   *
+	   * The sinks write their buffered data first, so that the child does not write it again.
+	   */
+	  void prepareFork() noexcept override;
+
+	  /**
+	   * @brief Releases the locks taken by prepareFork() in the parent.
+	   */
+	  void parentAfterFork() noexcept override;
+
+	  /**
+	   * @brief Releases the locks taken by prepareFork() in the child.
+	   *
+	   * The sinks move to files and connections of their own. No thread is started here: the
+	   * background threads are replaced by followFork() on the first use of the logger.
+	   */
+	  void childAfterFork() noexcept override;
+
+	  /**
+	   * @brief Replaces the parent's background threads on the first use of the logger in the child of a fork.
+	   *
+	   * Called by every function of Logger that logs or controls the background threads; otherwise
+	   * a single comparison with forking::generation().
 	   */
-	  [[nodiscard]] static std::string levelToString(LogLevel level);
+	  void followFork()
+	  {
+		  if (generation_.load(std::memory_order_acquire) != forking::generation()) resumeAfterFork();
+	  }
 
 	  /**
-	   * @brief Retrieves the appropriate color code for a given log level.
-	   * @param level The log level.
-	   * @return A string containing the ANSI color code for the log level.
+	   * @brief Starts the background writer with a new queue, stopping the previous one first.
+	   * @param capacity The maximum number of queued records.
+	   * @param policy What to do when the queue is full.
+	   * @param keepLevel The lowest level never dropped by OverflowPolicy::DropBelowLevel.
 	   */
-	  [[nodiscard]] static std::string getColorCode(LogLevel level);
+	  void startWriter(std::size_t capacity, OverflowPolicy policy, LogLevel keepLevel);
 
 	  /**
-	   * @brief Gets the current time formatted according to the timeFormat_.
-	   * @return A string representing the current time.
+	   * @brief Stops the background writer after it has written all queued records.
 	   */
-	  [[nodiscard]] std::string getCurrentTime() const;
+	  void stopWriter();
 
 	  /**
-	   * @brief Writes log messages to all registered file streams.
-	   * @param timestamp The formatted timestamp of the log message.
-	   * @param pid The process ID.
-	   * @param tid The thread ID.
-	   * @param level The log level of the message.
-	   * @param message The log message.
+	   * @brief Starts collecting the records of a shared memory ring, stopping the previous collector first.
+	   * @param name The name of the shared memory segment.
+	   * @param capacity The number of cells if the segment is created.
 	   */
-	  void writeToFileStreams(
-		  const std::string& timestamp,
-		  std::uint32_t pid,
-		  std::thread::id tid,
-		  Logify::LogLevel level,
-		  const std::string& message
-	  );
+	  void startCollector(const std::string& name, std::size_t capacity);
 
 	  /**
-	   * @brief Retrieves the current process ID.
+	   * @brief Stops the collector after it has written the records committed to the ring so far.
+	   */
+	  void stopCollector();
+
+	  /**
+	   * @brief Retrieves the current process ID, cached per thread until the next fork.
 	   * @return The process ID as an unsigned 32-bit integer.
 	   */
 	  static std::uint32_t getPID();
 
+	  /**
+	   * @brief Retrieves the OS identifier of the calling thread, cached until the next fork.
+	   * @return The thread ID as an unsigned 64-bit integer.
+	   */
+	  static std::uint64_t getTID();
+
 	  /**
 	   * @brief Increase the indentation.
 	   */
@@ -125,15 +239,96 @@ namespace Logify
 	   */
 	  void deindent();
 
+   private:
+	  /**
+	   * @brief Recomputes the lowest minimum level of all sinks. Called with sinksMutex_ held exclusively.
+	   */
+	  void updateSinkLevel();
+
+	  /**
+	   * @brief Gives up the parent's background threads and starts the child's own. Called by followFork().
+	   *
+	   * The records queued in the parent stay with the parent, which writes them; so does the
+	   * shared memory ring of a collector. A new writer starts with an empty queue.
+	   */
+	  void resumeAfterFork();
+
+	  /**
+	   * @brief The loop of the background writer thread: takes batches from the queue into batch_ and writes them.
+	   * @param queue The queue to drain until it is closed and empty.
+	   */
+	  void writerLoop(RecordQueue& queue);
+
+	  /**
+	   * @brief The loop of the collector thread: takes records from the ring and writes them to the sinks.
+	   * @param ring The ring to collect from until collecting_ is cleared and the ring is empty.
+	   */
+	  void collectorLoop(SharedRing& ring);
+
+	  /**
+	   * @brief Finds the scopes of the calling thread for this logger.
+	   * @param create Whether to add them if the thread has none yet.
+	   * @return The scopes, or nullptr if the thread has none and create is false.
+	   */
+	  ThreadScope* findScope(bool create);
+
+	  /**
+	   * @brief Formats records and writes them to every sink, regardless of the sinks' levels.
+	   *
+	   * Waits for the queue first, so the records follow the ones logged before them.
+	   * @param records The records to write, oldest first.
+	   * @param count The number of records to write from the start of the vector.
+	   */
+	  void writePastLevels(const std::vector<QueuedRecord>& records, std::size_t count);
+
+	  /**
+	   * @brief Logs how many records were dropped since the last report, if any.
+	   * @param reported The total number of drops already reported; updated by the call.
+	   */
+	  void reportDrops(std::uint64_t& reported);
+
+	  /**
+	   * @brief Logs how many records the producers of a shared memory ring dropped since the last report, if any.
+	   * @param ring The ring collected from.
+	   * @param reported The number of drops already reported; updated by the call.
+	   */
+	  void reportRingDrops(const SharedRing& ring, std::uint64_t& reported);
+
    private:
 	  friend class Logger; ///< Allows Logger class to directly access the private members of Impl.
-	  LogLevel                                 currentLogLevel_;  ///< The current logging level of the Logger.
-	  std::vector<std::ostream*>               outputStreams_;    ///< Vector of output streams for logging.
-	  std::string                              timeFormat_;       ///< Format string for timestamps in log messages.
-	  std::mutex                               mutex_;            ///< Mutex for thread-safe access to Logger methods.
-	  std::vector<std::unique_ptr<FileStream>> fileStreams_;      ///< Vector of file streams for logging to files.
-	  size_t                                   indent_;
-	  bool                                     useIndent_;
+	  std::uint64_t                             id_;               ///< Unique identifier, for the thread-local scope lookup.
+	  std::shared_ptr<const Impl>               self_;             ///< Owns nothing; its weak pointers expire with this logger.
+	  std::atomic<LogLevel>                     currentLogLevel_;  ///< The current logging level of the Logger.
+	  std::atomic<LogLevel>                     sinkLevel_;        ///< The lowest minimum level of all sinks.
+	  std::string                               timeFormat_;       ///< Format string for timestamps in log messages.
+	  TimeZone                                  timeZone_;         ///< The time zone of the timestamps.
+	  std::vector<std::unique_ptr<Sink>>        sinks_;            ///< The output streams, consoles and files to write to.
+	  ForkSafeSharedMutex                       sinksMutex_;       ///< Shared by logging threads, exclusive for adding/removing sinks.
+	  std::atomic<size_t>                       indent_;
+	  std::atomic<bool>                         useIndent_;
+	  std::unique_ptr<RecordQueue>              queue_;            ///< The queue of the asynchronous mode, if enabled.
+	  std::thread                               writer_;           ///< The background writer of the asynchronous mode.
+	  std::vector<QueuedRecord>                 batch_;            ///< The records taken from the queue by the writer.
+	  std::atomic<std::size_t>                  batchNext_;        ///< Index of the next record of batch_ to write.
+	  std::atomic<std::size_t>                  batchEnd_;         ///< Number of records in the current batch_.
+	  QueueCounters                             queueCounters_;    ///< Dropped records and queue depth of all queues.
+	  ShardedCounters<6>                        accepted_;         ///< Messages that passed the level checks, per level.
+	  ShardedCounters<6>                        filtered_;         ///< Messages discarded by the level checks, per level.
+	  std::unique_ptr<FlightRecorder>           recorder_;         ///< Keeps the filtered records, if enabled.
+	  LogLevel                                  dumpLevel_;        ///< The lowest level that dumps the flight recorder.
+	  std::vector<QueuedRecord>                 dumped_;           ///< The records taken from the recorder, reused.
+	  std::mutex                                dumpMutex_;        ///< Serializes the dumps of the flight recorder.
+	  bool                                      scopeBuffering_;   ///< Whether records are held inside scopes.
+	  LogLevel                                  bufferedLevel_;    ///< The highest level held inside scopes.
+	  LogLevel                                  triggerLevel_;     ///< The lowest level that writes the held records.
+	  std::size_t                               scopeCapacity_;    ///< The number of records held per thread.
+	  std::unique_ptr<SharedRing>               collectorRing_;    ///< The shared memory ring collected from, if any.
+	  std::thread                               collector_;        ///< The thread writing the records of collectorRing_.
+	  std::atomic<bool>                         collecting_;       ///< Cleared to stop the collector.
+	  std::atomic<std::uint64_t>                collected_;        ///< The ring position up to which records are written.
+	  std::unique_ptr<levels::LevelFileWatcher> levelWatcher_;     ///< Sets currentLogLevel_ from a file, if enabled.
+	  std::atomic<std::uint64_t>                generation_;       ///< The fork generation whose threads the logger runs.
+	  std::mutex                                resumeMutex_;      ///< Serializes followFork(); held across a fork.
   };
 
 
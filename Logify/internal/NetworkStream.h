@@ -0,0 +1,167 @@
+/*
+ * Logify Logger Library - Internal Network Stream
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the NetworkStream class, the sink that sends formatted log
+ * records to a log aggregator over a Unix domain socket or TCP. Logging threads only
+ * append to an in-memory backlog; a background thread of the stream owns the socket,
+ * sends the backlog in batches and reconnects with backoff.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Sink.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace Logify
+{
+
+  /**
+   * @class NetworkStream
+   * @brief Sends log records as text or JSON lines to a Unix domain socket or TCP peer.
+   *
+   * The records are appended to chunks of up to ChunkSize bytes. The sender thread takes all
+   * pending chunks at once and hands them to the socket with one vectored send per batch, so
+   * the number of system calls falls as the logging rate rises. The backlog is bounded; records
+   * that do not fit are dropped and counted as write errors, as are the records discarded
+   * because the connection was lost in the middle of them.
+   */
+  class NetworkStream : public Sink
+  {
+   public:
+	  static constexpr std::size_t ChunkSize = 64 * 1024;  ///< The size at which a new chunk is started.
+
+	  /**
+	   * @brief Constructs a NetworkStream and starts its sender thread, which connects in the background.
+	   * @param address "unix:<path>" or "tcp:<host>:<port>".
+	   * @param options The format, level and buffering of the stream.
+	   * @throws std::invalid_argument If the address has neither form.
+	   */
+	  NetworkStream(const std::string& address, const NetworkStreamOptions& options);
+
+	  /**
+	   * @brief Sends what is still pending, for at most ShutdownTimeout, and stops the sender thread.
+	   */
+	  ~NetworkStream() override;
+
+	  /**
+	   * @brief Retrieves the name of this sink: its address.
+	   */
+	  [[nodiscard]] std::string name() const override;
+
+   protected:
+	  /**
+	   * @brief Formats a log record and appends it to the backlog, or drops it if the backlog is full.
+	   * @param record The log record to write.
+	   */
+	  void write(const LogRecord& record) override;
+
+	  /**
+	   * @brief Waits until the records appended so far are sent, unless the peer is unreachable.
+	   */
+	  void sync() override;
+
+	  /**
+	   * @brief Takes the lock shared with the sender before a fork.
+	   */
+	  void prepareFork() override;
+
+	  /**
+	   * @brief Releases the lock taken by prepareFork() in the parent.
+	   */
+	  void parentAfterFork() override;
+
+	  /**
+	   * @brief Starts the stream of a forked child afresh: without the parent's sender and with an empty backlog.
+	   *
+	   * The records pending at the fork are sent by the parent; the child closes its copy of the
+	   * parent's connection, so that the peer sees the connection end when the parent ends it.
+	   * The first write of the child starts a new sender, which opens a connection of its own.
+	   */
+	  void childAfterFork() override;
+
+   private:
+	  /**
+	   * @struct Chunk
+	   * @brief Formatted records waiting to be sent.
+	   */
+	  struct Chunk
+	  {
+		  std::string data;     ///< The formatted records.
+		  std::size_t records;  ///< The number of records in data.
+	  };
+
+	  /**
+	   * @brief Starts the sender thread, with the condition variables it waits on.
+	   */
+	  void startSender();
+
+	  /**
+	   * @brief The loop of the sender thread: connects, sends the pending chunks and reconnects.
+	   */
+	  void senderLoop();
+
+	  /**
+	   * @brief Marks sent or discarded bytes as no longer pending and wakes the threads waiting in sync().
+	   * @param bytes The number of bytes.
+	   * @param finished The chunks that are done with, kept for reuse; emptied by the call.
+	   */
+	  void release(std::size_t bytes, std::vector<Chunk>& finished);
+
+	  /**
+	   * @brief Discards the chunks the sender has not sent, counting their records as write errors.
+	   * @param sending The chunks taken by the sender; emptied by the call.
+	   * @param offset The bytes of the first chunk already sent.
+	   */
+	  void discard(std::deque<Chunk>& sending, std::size_t offset);
+
+	  /**
+	   * @brief Clears connection_, before the sender closes its socket.
+	   */
+	  void forgetConnection();
+
+   private:
+	  std::string             address_;          ///< The address as given.
+	  bool                    isUnix_;           ///< Whether the address is a Unix domain socket.
+	  std::string             host_;             ///< The path of the Unix domain socket, or the TCP host.
+	  std::string             port_;             ///< The TCP port.
+	  NetworkStreamOptions    options_;          ///< The settings of the stream.
+	  std::string             buffer_;           ///< Reused buffer holding the formatted record.
+
+	  std::mutex                               pendingMutex_;     ///< Protects the members below; never held while sending.
+	  std::unique_ptr<std::condition_variable> wakeUp_;           ///< Signaled when chunks are pending or the stream stops.
+	  std::unique_ptr<std::condition_variable> progress_;         ///< Signaled when bytes were sent or the connection changed.
+	  std::deque<Chunk>                        chunks_;           ///< The chunks not yet taken by the sender.
+	  std::vector<Chunk>                       spare_;            ///< Sent chunks kept for reuse, with their capacity.
+	  std::size_t                              pendingBytes_;     ///< Bytes appended and not yet sent, including those being sent.
+	  std::uint64_t                            appendedBytes_;    ///< Bytes appended since the stream was created.
+	  std::uint64_t                            releasedBytes_;    ///< Bytes sent or discarded since the stream was created.
+	  bool                                     reachable_;        ///< Whether the last connection attempt succeeded.
+	  bool                                     senderIdle_;       ///< Whether the sender waits for chunks.
+	  bool                                     stopping_;         ///< Set to stop the sender.
+	  std::int64_t                             connection_;       ///< The sender's connected socket, or -1; closed by a forked child.
+
+	  std::thread                              sender_;           ///< The sender thread; not running in a forked child until its first write.
+  };
+
+} // namespace Logify
@@ -0,0 +1,71 @@
+/*
+ * Logify Logger Library - Internal Output Stream Sink
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the OutputStream class, an internal component of the Logify
+ * library that writes log messages to a user-provided std::ostream.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Sink.h"
+#include <ostream>
+#include <string>
+
+
+namespace Logify
+{
+
+  /**
+   * @class OutputStream
+   * @brief Writes log records as text lines to a std::ostream owned by the user.
+   *
+   * If the stream is std::cout or std::cerr, the lines are wrapped in ANSI color codes.
+   */
+  class OutputStream : public Sink
+  {
+   public:
+	  /**
+	   * @brief Constructs an OutputStream writing to the given stream.
+	   * @param out The output stream to write to. Must outlive this object.
+	   * @param minLevel The lowest level of the messages written to the stream.
+	   */
+	  OutputStream(std::ostream& out, LogLevel minLevel);
+
+	  /**
+	   * @brief Checks whether this sink writes to the given stream.
+	   * @param out The output stream to compare with.
+	   * @return True if this sink writes to out, otherwise false.
+	   */
+	  [[nodiscard]] bool writesTo(const std::ostream& out) const;
+
+	  /**
+	   * @brief Retrieves the name of this sink: "cout", "cerr" or "ostream".
+	   */
+	  [[nodiscard]] std::string name() const override;
+
+   protected:
+	  /**
+	   * @brief Writes a log record to the stream.
+	   * @param record The log record to write.
+	   */
+	  void write(const LogRecord& record) override;
+
+   private:
+	  std::ostream* stream_;     ///< The output stream to write to.
+	  bool          isConsole_;  ///< Whether the stream is std::cout or std::cerr.
+	  std::string   buffer_;     ///< Reused buffer holding the formatted record.
+  };
+
+} // namespace Logify
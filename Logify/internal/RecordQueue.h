@@ -0,0 +1,340 @@
+/*
+ * Logify Logger Library - Internal Record Queue
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the RecordQueue class, the bounded queue between logging
+ * threads and the background writer of an asynchronous Logger. The queue owns copies
+ * of the queued records in fixed-size slots stored inline in its ring, and applies the
+ * configured overflow policy when it is full, counting every dropped record per log level
+ * and the largest number of queued records.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Logify/Logger.h"
+#include "LogRecord.h"
+#include "SpillArena.h"
+#include "TickClock.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace Logify
+{
+
+  /**
+   * @class QueuedRecord
+   * @brief An owning copy of a LogRecord in a fixed-size, cache-line-aligned slot.
+   *
+   * The fields, the message and the keys and string values of the fields are copied into
+   * the inline storage of the slot. Records that do not fit are copied into a SpillArena
+   * instead, so copying a record never allocates per record.
+   */
+  class alignas(64) QueuedRecord
+  {
+   public:
+	  static constexpr std::size_t SlotSize   = 256;  ///< The size of a slot, four cache lines.
+	  static constexpr std::size_t InlineSize = 192;  ///< The bytes of record data stored in the slot itself.
+
+	  QueuedRecord() = default;
+
+	  /**
+	   * @brief Moves a record into a new slot, leaving the other slot empty.
+	   */
+	  QueuedRecord(QueuedRecord&& other) noexcept;
+
+	  /**
+	   * @brief Releases this slot's record and moves another record in, leaving the other slot empty.
+	   */
+	  QueuedRecord& operator=(QueuedRecord&& other) noexcept;
+
+	  /**
+	   * @brief Releases the spilled data of the record, if any.
+	   */
+	  ~QueuedRecord();
+
+	  /**
+	   * @brief Copies a log record into this slot. The wall-clock time and the timestamp are not copied.
+	   * @param record The log record to copy.
+	   * @param arena The arena holding the data if it does not fit into the slot.
+	   */
+	  void assign(const LogRecord& record, SpillArena& arena);
+
+	  /**
+	   * @brief Creates a LogRecord view of this slot.
+	   * @param time The wall-clock time of the record, from time().
+	   * @param timestamp The formatted timestamp to use for the record.
+	   * @param fields Storage for the fields of the record; must outlive the returned record.
+	   * @return A LogRecord referring to the data of this slot.
+	   */
+	  [[nodiscard]] LogRecord view(
+		  std::chrono::system_clock::time_point time,
+		  std::string_view timestamp,
+		  std::vector<Field>& fields
+	  ) const;
+
+	  /**
+	   * @brief Calls a function with each field of the queued record, without allocating.
+	   * @param visit The function to call with a const Field&; the field refers to the data of this slot.
+	   */
+	  template<typename Visitor>
+	  void forEachField(Visitor&& visit) const
+	  {
+		  const char*      data = this->data();
+		  std::string_view text = this->text();
+		  for (std::size_t i = 0; i < fieldCount_; ++i)
+		  {
+			  StoredField stored;
+			  std::memcpy(&stored, data + i * sizeof(StoredField), sizeof(StoredField));
+
+			  std::string_view key = text.substr(stored.keyOffset, stored.keySize);
+			  switch (stored.type)
+			  {
+				  case Field::Type::Int:
+					  visit(Field(key, stored.intValue));
+					  break;
+				  case Field::Type::UInt:
+					  visit(Field(key, stored.uintValue));
+					  break;
+				  case Field::Type::Double:
+					  visit(Field(key, stored.doubleValue));
+					  break;
+				  case Field::Type::Bool:
+					  visit(Field(key, stored.boolValue));
+					  break;
+				  case Field::Type::String:
+					  visit(Field(key, text.substr(stored.valueOffset, stored.valueSize)));
+					  break;
+			  }
+		  }
+	  }
+
+	  /**
+	   * @brief Retrieves the log level of the queued record.
+	   */
+	  [[nodiscard]] LogLevel level() const { return level_; }
+
+	  /**
+	   * @brief Retrieves the TickClock reading taken when the queued record was logged.
+	   */
+	  [[nodiscard]] std::uint64_t ticks() const { return ticks_; }
+
+	  /**
+	   * @brief Converts the ticks of the queued record to the wall-clock time. Async-signal-safe.
+	   */
+	  [[nodiscard]] std::chrono::system_clock::time_point time() const { return TickClock::toTime(ticks_); }
+
+	  /**
+	   * @brief Retrieves the process ID of the queued record.
+	   */
+	  [[nodiscard]] std::uint32_t pid() const { return pid_; }
+
+	  /**
+	   * @brief Retrieves the OS thread ID of the queued record.
+	   */
+	  [[nodiscard]] std::uint64_t tid() const { return tid_; }
+
+	  /**
+	   * @brief Retrieves the scope indentation level of the queued record.
+	   */
+	  [[nodiscard]] std::size_t indent() const { return indent_; }
+
+	  /**
+	   * @brief Retrieves the message of the queued record.
+	   */
+	  [[nodiscard]] std::string_view message() const { return text().substr(0, messageSize_); }
+
+   private:
+	  /**
+	   * @struct StoredField
+	   * @brief A field whose key and string value are stored as offsets into the text of the record.
+	   */
+	  struct StoredField
+	  {
+		  Field::Type   type;
+		  std::uint32_t keyOffset;
+		  std::uint32_t keySize;
+		  std::uint32_t valueOffset;  ///< Offset of the string value, if type is Field::Type::String.
+		  std::uint32_t valueSize;    ///< Size of the string value, if type is Field::Type::String.
+		  union
+		  {
+			  std::int64_t  intValue;
+			  std::uint64_t uintValue;
+			  double        doubleValue;
+			  bool          boolValue;
+		  };
+	  };
+
+	  /**
+	   * @brief Retrieves the record data: the stored fields, then the text.
+	   */
+	  [[nodiscard]] const char* data() const { return spilled_ ? spilled_ : inline_; }
+
+	  /**
+	   * @brief Retrieves the text of the record: the message, then the field keys and string values.
+	   */
+	  [[nodiscard]] std::string_view text() const
+	  {
+		  std::size_t fieldsSize = fieldCount_ * sizeof(StoredField);
+		  return {data() + fieldsSize, size_ - fieldsSize};
+	  }
+
+	  /**
+	   * @brief Takes over the record of another slot, leaving it empty.
+	   */
+	  void take(QueuedRecord& other) noexcept;
+
+	  /**
+	   * @brief Releases the spilled data, if any, and empties the slot.
+	   */
+	  void release() noexcept;
+
+	  LogLevel                              level_       = LogLevel::INFO;  ///< The log level.
+	  std::uint16_t                         fieldCount_  = 0;               ///< Number of stored fields at the start of the data.
+	  std::uint32_t                         pid_         = 0;               ///< The process ID.
+	  std::uint32_t                         messageSize_ = 0;               ///< Size of the message at the start of the text.
+	  std::uint32_t                         size_        = 0;               ///< Size of the data.
+	  std::uint64_t                         ticks_       = 0;               ///< The TickClock reading of the record.
+	  std::uint64_t                         tid_         = 0;               ///< The OS thread ID.
+	  std::size_t                           indent_      = 0;               ///< The scope indentation level.
+	  char*                                 spilled_     = nullptr;         ///< The data in the arena, if it did not fit inline.
+	  SpillChunk*                           chunk_       = nullptr;         ///< The arena chunk holding spilled_.
+	  alignas(8) char                       inline_[InlineSize];            ///< The data, if it fits.
+  };
+
+  static_assert(sizeof(QueuedRecord) == QueuedRecord::SlotSize, "QueuedRecord must fill its slot exactly");
+
+  /**
+   * @struct QueueCounters
+   * @brief The counters updated by a RecordQueue, owned by the Logger so they outlive the queue.
+   */
+  struct QueueCounters
+  {
+	  std::array<std::atomic<std::uint64_t>, 6> dropped;    ///< Number of dropped records per level.
+	  std::atomic<std::size_t>                  highWater;  ///< The largest number of records queued at once.
+  };
+
+  /**
+   * @class RecordQueue
+   * @brief A bounded multi-producer queue of log records with configurable overflow handling.
+   */
+  class RecordQueue
+  {
+   public:
+	  /**
+	   * @brief Constructs a RecordQueue.
+	   * @param capacity The maximum number of queued records (at least 1).
+	   * @param policy What to do with a new record when the queue is full.
+	   * @param keepLevel For OverflowPolicy::DropBelowLevel, the lowest level that is never dropped.
+	   * @param counters The counters of dropped records and queue depth; must outlive the queue.
+	   */
+	  RecordQueue(std::size_t capacity, OverflowPolicy policy, LogLevel keepLevel, QueueCounters& counters);
+
+	  /**
+	   * @brief Adds a copy of a record to the queue, applying the overflow policy if it is full.
+	   * @param record The record to add.
+	   * @return True if the record was queued, false if it was dropped.
+	   */
+	  bool push(const LogRecord& record);
+
+	  /**
+	   * @brief Moves queued records into a batch, waiting up to the timeout for the first one.
+	   *
+	   * The records are moved into the slots of the batch, releasing the records written before.
+	   * @param batch The vector receiving the records; it is resized to the number of records taken.
+	   * @param maxRecords The maximum number of records to take.
+	   * @param timeout The maximum time to wait if the queue is empty.
+	   * @return The number of records taken.
+	   */
+	  std::size_t pop(std::vector<QueuedRecord>& batch, std::size_t maxRecords, std::chrono::milliseconds timeout);
+
+	  /**
+	   * @brief Reports that records taken with pop() have been written.
+	   * @param count The number of records written.
+	   */
+	  void markWritten(std::size_t count);
+
+	  /**
+	   * @brief Blocks until every record queued before this call has been written or dropped.
+	   */
+	  void waitUntilWritten();
+
+	  /**
+	   * @brief Closes the queue: pop() stops waiting and returns immediately once the queue is empty.
+	   */
+	  void close();
+
+	  /**
+	   * @brief Checks whether the queue is closed and empty.
+	   */
+	  [[nodiscard]] bool isDrained();
+
+	  /**
+	   * @brief Retrieves the maximum number of queued records.
+	   */
+	  [[nodiscard]] std::size_t capacity() const { return ring_.size(); }
+
+	  /**
+	   * @brief Retrieves what is done with a new record when the queue is full.
+	   */
+	  [[nodiscard]] OverflowPolicy policy() const { return policy_; }
+
+	  /**
+	   * @brief Retrieves the lowest level never dropped by OverflowPolicy::DropBelowLevel.
+	   */
+	  [[nodiscard]] LogLevel keepLevel() const { return keepLevel_; }
+
+	  /**
+	   * @brief Calls a function with each queued record, oldest first, without taking the lock.
+	   *
+	   * Only for the crash handler, when other threads may hold the lock forever. The result is
+	   * undefined if another thread changes the queue at the same time.
+	   * @param visit The function to call with a const QueuedRecord&.
+	   */
+	  template<typename Visitor>
+	  void visitUnlocked(Visitor&& visit) const
+	  {
+		  for (std::size_t i = 0; i < size_; ++i) visit(ring_[(head_ + i) % ring_.size()]);
+	  }
+
+   private:
+	  /**
+	   * @brief Counts a dropped record. Called with mutex_ held.
+	   */
+	  void countDrop(LogLevel level);
+
+   private:
+	  std::vector<QueuedRecord>                 ring_;       ///< The slots of the queue, reused in a circle.
+	  std::size_t                               head_;       ///< Index of the oldest queued record.
+	  std::size_t                               size_;       ///< Number of queued records.
+	  OverflowPolicy                            policy_;     ///< What to do when the queue is full.
+	  LogLevel                                  keepLevel_;  ///< Lowest level never dropped by DropBelowLevel.
+	  bool                                      closed_;     ///< Whether close() was called.
+	  std::uint64_t                             queued_;     ///< Number of records pushed (including overwritten ones).
+	  std::uint64_t                             written_;    ///< Number of records written or overwritten.
+	  std::mutex                                mutex_;      ///< Protects all of the above.
+	  std::condition_variable                   notEmpty_;   ///< Signaled when a record is pushed or the queue closes.
+	  std::condition_variable                   notFull_;    ///< Signaled when records are taken from the queue.
+	  std::condition_variable                   wroteSome_;  ///< Signaled when records are written.
+	  QueueCounters&                            counters_;   ///< Dropped records and queue depth.
+  };
+
+} // namespace Logify
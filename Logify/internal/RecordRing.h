@@ -0,0 +1,108 @@
+/*
+ * Logify Logger Library - Internal Record Ring
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the RecordRing class, a fixed number of reusable record slots
+ * that overwrites its oldest record when full. It holds records that may never be
+ * written, such as those of the flight recorder and of scope buffers, without formatting
+ * them.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "LogRecord.h"
+#include "RecordQueue.h"
+#include "SpillArena.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace Logify
+{
+
+  /**
+   * @class RecordRing
+   * @brief A ring of record slots that keeps the most recent records. Not thread-safe.
+   *
+   * Adding a record copies its message and fields into the inline storage of a slot, or
+   * into the ring's own arena if they do not fit. Records leave the ring in the order they
+   * were added, so the arena's chunks are recycled as the ring wraps around.
+   */
+  class RecordRing
+  {
+   public:
+	  /**
+	   * @brief Constructs a RecordRing.
+	   * @param capacity The number of records kept (at least 1).
+	   */
+	  explicit RecordRing(std::size_t capacity)
+		  : slots_(std::max<std::size_t>(capacity, 1)), next_(0), size_(0)
+	  {}
+
+	  /**
+	   * @brief Copies a record into the ring, overwriting the oldest record if it is full.
+	   * @param record The record to keep. The formatted timestamp is not copied.
+	   */
+	  void push(const LogRecord& record)
+	  {
+		  slots_[next_].assign(record, arena_);
+		  next_ = (next_ + 1) % slots_.size();
+		  size_ = std::min(size_ + 1, slots_.size());
+	  }
+
+	  /**
+	   * @brief Moves the records, oldest first, to the end of a vector and empties the ring.
+	   *
+	   * The records are moved into the elements of the vector from the given count on,
+	   * releasing the records previously taken into them.
+	   * @param records The vector receiving the records; grown if needed.
+	   * @param count The number of records already in the vector; updated by the call.
+	   */
+	  void takeInto(std::vector<QueuedRecord>& records, std::size_t& count)
+	  {
+		  std::size_t capacity = slots_.size();
+		  for (std::size_t i = 0; i < size_; ++i)
+		  {
+			  if (count == records.size()) records.emplace_back();
+			  records[count++] = std::move(slots_[(next_ + capacity - size_ + i) % capacity]);
+		  }
+		  size_ = 0;
+	  }
+
+	  /**
+	   * @brief Discards the records; their spilled data is released when the slots are reused.
+	   */
+	  void clear()
+	  {
+		  size_ = 0;
+	  }
+
+	  /**
+	   * @brief Checks whether the ring holds no records.
+	   */
+	  [[nodiscard]] bool empty() const
+	  {
+		  return size_ == 0;
+	  }
+
+   private:
+	  SpillArena                arena_;  ///< Holds the data of records that do not fit into a slot.
+	  std::vector<QueuedRecord> slots_;  ///< The slots of the ring, reused in a circle.
+	  std::size_t               next_;   ///< Index of the slot written next.
+	  std::size_t               size_;   ///< Number of records in the ring.
+  };
+
+} // namespace Logify
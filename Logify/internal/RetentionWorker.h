@@ -0,0 +1,109 @@
+/*
+ * Logify Logger Library - Internal Retention Worker
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the RetentionWorker class, the background thread of a log
+ * file stream that deletes the oldest rotated files beyond the configured limits on
+ * count, total size and age. Deleting files on a slow file system thus never delays
+ * a logging call.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace Logify
+{
+
+  /**
+   * @struct RetentionLimits
+   * @brief The limits on the rotated files of a log file stream; zero means no limit.
+   */
+  struct RetentionLimits
+  {
+	  std::size_t          maxFiles      = 0;  ///< The maximum number of files kept.
+	  std::uint64_t        maxTotalBytes = 0;  ///< The maximum total size of the files kept.
+	  std::chrono::seconds maxAge{0};          ///< Files last written longer ago are deleted.
+
+	  /**
+	   * @brief Checks whether any limit is set.
+	   */
+	  [[nodiscard]] bool any() const
+	  {
+		  return maxFiles > 0 || maxTotalBytes > 0 || maxAge.count() > 0;
+	  }
+  };
+
+  /**
+   * @class RetentionWorker
+   * @brief Deletes the oldest rotated files of a log file stream on a background thread.
+   */
+  class RetentionWorker
+  {
+   public:
+	  /**
+	   * @brief Constructs a RetentionWorker and starts its thread.
+	   * @param baseName The file name of the stream without extension, e.g. "logs/app".
+	   * @param extension The extension of the files without the dot, e.g. "log".
+	   * @param limits The limits to apply.
+	   */
+	  RetentionWorker(std::string baseName, std::string extension, RetentionLimits limits);
+
+	  /**
+	   * @brief Applies a scheduled cleanup, if any, and stops the thread.
+	   */
+	  ~RetentionWorker();
+
+	  RetentionWorker(const RetentionWorker&)            = delete;
+	  RetentionWorker& operator=(const RetentionWorker&) = delete;
+
+	  /**
+	   * @brief Schedules a cleanup and returns immediately.
+	   * @param currentPeriod The time period of the file being written, or empty.
+	   * @param currentIndex The index of the file being written, which is never deleted.
+	   */
+	  void schedule(const std::string& currentPeriod, int currentIndex);
+
+   private:
+	  /**
+	   * @brief The loop of the background thread: waits for scheduled cleanups and applies them.
+	   */
+	  void run();
+
+	  /**
+	   * @brief Deletes the files beyond the limits, oldest (lowest period and index) first.
+	   * @param currentPeriod The time period of the file being written.
+	   * @param currentIndex The index of the file being written.
+	   */
+	  void applyLimits(const std::string& currentPeriod, int currentIndex) const;
+
+   private:
+	  std::string             baseName_;      ///< The file name of the stream without extension.
+	  std::string             extension_;     ///< The extension of the files.
+	  RetentionLimits         limits_;        ///< The limits to apply.
+	  std::string             pendingPeriod_; ///< The current period of the scheduled cleanup.
+	  int                     pendingIndex_;  ///< The current index of the scheduled cleanup, or -1.
+	  bool                    stopping_;      ///< Whether the destructor asked the thread to stop.
+	  std::mutex              mutex_;         ///< Protects the pending cleanup and stopping_.
+	  std::condition_variable wakeUp_;        ///< Signaled when a cleanup is scheduled or the worker stops.
+	  std::thread             thread_;        ///< The background thread.
+  };
+
+} // namespace Logify
@@ -0,0 +1,101 @@
+/*
+ * Logify Logger Library - Internal Sharded Counters
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the ShardedCounters class, a set of lock-free counters
+ * split into cache-line-sized shards. Each thread increments the counters of its own
+ * shard, so logging threads do not contend on a shared cache line; reading a counter
+ * sums it over all shards.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Logify
+{
+
+  /**
+   * @brief Retrieves the shard index of the calling thread.
+   *
+   * Threads are assigned indices round-robin on their first call; the result is below shardCount.
+   * @param shardCount The number of shards; must be a power of two.
+   * @return The shard index of the calling thread.
+   */
+  inline std::size_t threadShardIndex(std::size_t shardCount)
+  {
+	  static std::atomic<std::size_t> nextIndex{0};
+	  thread_local const std::size_t  index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+	  return index & (shardCount - 1);
+  }
+
+  /**
+   * @class ShardedCounters
+   * @brief A fixed number of 64-bit counters, sharded per thread.
+   * @tparam Count The number of counters.
+   */
+  template<std::size_t Count>
+  class ShardedCounters
+  {
+   public:
+	  static constexpr std::size_t ShardCount = 16;  ///< The number of shards (a power of two).
+
+	  ShardedCounters()
+	  {
+		  for (auto& shard : shards_)
+		  {
+			  for (auto& value : shard.values) value.store(0, std::memory_order_relaxed);
+		  }
+	  }
+
+	  /**
+	   * @brief Adds a value to a counter in the calling thread's shard.
+	   * @param counter The index of the counter.
+	   * @param value The value to add (default is 1).
+	   */
+	  void add(std::size_t counter, std::uint64_t value = 1)
+	  {
+		  shards_[threadShardIndex(ShardCount)].values[counter].fetch_add(value, std::memory_order_relaxed);
+	  }
+
+	  /**
+	   * @brief Reads a counter by summing it over all shards.
+	   * @param counter The index of the counter.
+	   * @return The current value of the counter.
+	   */
+	  [[nodiscard]] std::uint64_t sum(std::size_t counter) const
+	  {
+		  std::uint64_t total = 0;
+		  for (const auto& shard : shards_) total += shard.values[counter].load(std::memory_order_relaxed);
+		  return total;
+	  }
+
+   private:
+	  /**
+	   * @struct Shard
+	   * @brief The counters of one shard, aligned to their own cache line(s).
+	   */
+	  struct alignas(64) Shard
+	  {
+		  std::array<std::atomic<std::uint64_t>, Count> values;
+	  };
+
+	  std::array<Shard, ShardCount> shards_;  ///< The shards of the counters.
+  };
+
+} // namespace Logify
@@ -0,0 +1,72 @@
+/*
+ * Logify Logger Library - Internal Shared Memory Stream
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the SharedMemoryStream class, the sink that publishes log records
+ * into a SharedRing, from where the collector of another process (or of the same one) writes
+ * them to its own sinks.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Sink.h"
+#include "SharedRing.h"
+#include <string>
+
+
+namespace Logify
+{
+
+  /**
+   * @class SharedMemoryStream
+   * @brief Publishes log records, unformatted, into a named shared memory ring.
+   *
+   * The records keep their wall-clock time, process ID and thread ID; the collector formats
+   * them. Records dropped because the ring was full are counted as write errors.
+   */
+  class SharedMemoryStream : public Sink
+  {
+   public:
+	  /**
+	   * @brief Opens or creates the shared memory ring.
+	   * @param name The name of the shared memory segment.
+	   * @param capacity The number of 256-byte cells if the segment is created.
+	   * @param minLevel The lowest level of the messages published.
+	   * @throws std::runtime_error If the segment cannot be opened.
+	   */
+	  SharedMemoryStream(const std::string& name, std::size_t capacity, LogLevel minLevel);
+
+	  /**
+	   * @brief Retrieves the name of this sink: "shm:" followed by the name of the segment.
+	   */
+	  [[nodiscard]] std::string name() const override;
+
+	  /**
+	   * @brief Publishes a queued record from a fatal signal handler; publishing takes no lock.
+	   * @param record The queued record to publish.
+	   */
+	  void writeAfterCrash(const QueuedRecord& record) noexcept override;
+
+   protected:
+	  /**
+	   * @brief Publishes a log record into the ring.
+	   * @param record The log record to publish.
+	   */
+	  void write(const LogRecord& record) override;
+
+   private:
+	  SharedRing ring_;  ///< The ring the records are published into.
+  };
+
+} // namespace Logify
@@ -0,0 +1,188 @@
+/*
+ * Logify Logger Library - Internal Shared Memory Ring
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the SharedRing class, a ring of log records in a named shared
+ * memory segment. Any number of threads in any number of processes publish records into
+ * it without locks, and a single collector takes them out and writes them to its sinks,
+ * so the processes of a host can share one set of log files.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "LogRecord.h"
+#include "RecordQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace Logify
+{
+
+  /**
+   * @class SharedRing
+   * @brief A multi-producer, single-consumer ring of records in shared memory.
+   *
+   * The ring is a sequence of 256-byte cells, each with a sequence number telling whose turn
+   * it is: a producer reserves the cells of a record by advancing the shared write position
+   * with a compare-and-swap, copies the record into them, and commits it by advancing the
+   * sequence of its first cell. The collector takes committed records in order and hands
+   * their cells back to the producers of the next round. A producer that finds the ring full
+   * drops its record and counts it.
+   *
+   * A record reserved but not committed within AbandonAfter, for example because its process
+   * was killed while publishing, is skipped by the collector so the ring keeps moving. Its cells
+   * go to the producers of the next round. A producer that was only stalled (stopped, traced or
+   * swapped out) must not write into them any more. So before it writes into each of its cells,
+   * it checks that the cell's sequence is still its reservation, and it drops its record if not.
+   * One window remains. A producer can stall for longer than AbandonAfter between this check and
+   * the end of its copy into that cell. If it then resumes, it can still damage the one cell it
+   * was writing, in a record of the next round.
+   */
+  class SharedRing
+  {
+   public:
+	  static constexpr std::size_t CellSize = 256;  ///< The size of a cell, including its sequence number.
+
+	  /// How long the collector waits for a reserved record to be committed before skipping it.
+	  static constexpr std::chrono::milliseconds AbandonAfter{1000};
+
+	  /**
+	   * @brief Opens the named segment, creating and initializing it if it does not exist yet.
+	   *
+	   * An existing segment keeps the capacity it was created with.
+	   * @param name The name of the segment, without a leading slash.
+	   * @param capacity The number of cells of a new segment, rounded up to a power of two.
+	   * @throws std::runtime_error If the segment cannot be created, opened or mapped, or was
+	   *         created by an incompatible version.
+	   */
+	  SharedRing(const std::string& name, std::size_t capacity);
+
+	  /**
+	   * @brief Unmaps the segment. The segment itself persists until it is removed.
+	   */
+	  ~SharedRing();
+
+	  SharedRing(const SharedRing&)            = delete;
+	  SharedRing& operator=(const SharedRing&) = delete;
+
+	  /**
+	   * @brief Removes the named segment; processes that have it open keep using it.
+	   * @param name The name of the segment, without a leading slash.
+	   */
+	  static void remove(const std::string& name);
+
+	  /**
+	   * @brief Publishes a record. Lock-free, and async-signal-safe.
+	   *
+	   * Records larger than a quarter of the ring lose their fields and the end of their message.
+	   * @param record The record to publish.
+	   * @return The number of bytes published, or 0 if the ring was full and the record was dropped.
+	   */
+	  std::size_t publish(const LogRecord& record) noexcept;
+
+	  /**
+	   * @brief Publishes a queued record, like publish(const LogRecord&); for the crash handler.
+	   */
+	  std::size_t publish(const QueuedRecord& record) noexcept;
+
+	  /**
+	   * @brief Takes committed records out of the ring, in order. Only one thread may collect.
+	   * @param visit The function called with each record, as a LogRecord without timestamp.
+	   * @param maxRecords The maximum number of records to take.
+	   * @return The number of records taken.
+	   */
+	  template<typename Visitor>
+	  std::size_t collect(Visitor&& visit, std::size_t maxRecords)
+	  {
+		  std::size_t count = 0;
+		  while (count < maxRecords && takeNext())
+		  {
+			  visit(decoded_);
+			  ++count;
+		  }
+		  return count;
+	  }
+
+	  /**
+	   * @brief Retrieves the position up to which records have been reserved by producers.
+	   */
+	  [[nodiscard]] std::uint64_t writePosition() const;
+
+	  /**
+	   * @brief Retrieves the position up to which the collector has taken records.
+	   */
+	  [[nodiscard]] std::uint64_t readPosition() const;
+
+	  /**
+	   * @brief Retrieves the number of records dropped by all producers because the ring was full.
+	   */
+	  [[nodiscard]] std::uint64_t dropped() const;
+
+	  /**
+	   * @brief Retrieves the name of the segment.
+	   */
+	  [[nodiscard]] const std::string& name() const { return name_; }
+
+   private:
+	  struct Header;
+	  struct Cell;
+	  struct RecordHeader;
+
+	  /**
+	   * @brief Reserves the cells for a record, copies the record into them and commits it.
+	   * @param header The fixed part of the record; its sizes are set by the call.
+	   * @param message The message of the record.
+	   * @param forEachField Calls the function it is given with each field of the record.
+	   */
+	  template<typename FieldRange>
+	  std::size_t publishRecord(RecordHeader& header, std::string_view message, FieldRange&& forEachField) noexcept;
+
+	  /**
+	   * @brief Takes the next committed record into decoded_, skipping abandoned reservations.
+	   * @return True if a record was taken, false if none is committed yet.
+	   */
+	  bool takeNext();
+
+	  /**
+	   * @brief Unmaps the segment, if mapped.
+	   */
+	  void unmap() noexcept;
+
+	  /**
+	   * @brief Retrieves the cell at a position, modulo the capacity.
+	   */
+	  Cell& cell(std::uint64_t position) const;
+
+   private:
+	  std::string               name_;          ///< The name of the segment.
+	  void*                     memory_;        ///< The mapped segment.
+	  std::size_t               mappedSize_;    ///< The size of the mapping.
+	  Header*                   header_;        ///< The header at the start of the segment.
+	  Cell*                     cells_;         ///< The cells following the header.
+	  std::uint64_t             capacity_;      ///< The number of cells, a power of two.
+	  std::uint64_t             maxCells_;      ///< The most cells a single record may take.
+	  std::string               buffer_;        ///< The collector's copy of the record being taken.
+	  std::vector<Field>        fields_;        ///< The fields of the record being taken.
+	  LogRecord                 decoded_;       ///< The record being taken, referring to buffer_.
+	  std::uint64_t             stallLimit_;    ///< Reservations below this position may be abandoned.
+	  std::chrono::steady_clock::time_point stallSince_;  ///< When the collector found the ring stalled.
+  };
+
+} // namespace Logify
@@ -0,0 +1,113 @@
+/*
+ * Logify Logger Library - Internal SIMD Text Kernels
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file declares the byte-scanning kernels used by the formatting code of
+ * the Logify library. Each kernel has a scalar fallback and, on x86-64, SSE2 and AVX2
+ * implementations. The best implementation is selected once, on first use, based on the
+ * features reported by cpuid.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace Logify::simd
+{
+
+  /**
+   * @struct KernelTable
+   * @brief The set of scanning kernels selected for the running CPU.
+   *
+   * Every scanning kernel returns the index of the first matching byte in the given range,
+   * or the size of the range if no byte matches.
+   */
+  struct KernelTable
+  {
+	  std::size_t (* findHtmlSpecial)(const char* data, std::size_t size);         ///< Finds one of `<>&"'`.
+	  std::size_t (* findJsonSpecial)(const char* data, std::size_t size);         ///< Finds `"`, `\` or a control byte.
+	  std::size_t (* findByte)(const char* data, std::size_t size, char byte);     ///< Finds a given byte.
+	  const char* name;                                                            ///< Name of the implementation.
+  };
+
+  /**
+   * @brief Retrieves the kernel table for the running CPU.
+   *
+   * The table is selected on the first call and reused for the lifetime of the process.
+   * @return A reference to the selected kernel table.
+   */
+  const KernelTable& kernels();
+
+  /**
+   * @brief Finds the first byte that must be escaped in HTML text.
+   * @return The index of the first such byte, or size if there is none.
+   */
+  inline std::size_t findHtmlSpecial(const char* data, std::size_t size)
+  {
+	  return kernels().findHtmlSpecial(data, size);
+  }
+
+  /**
+   * @brief Finds the first byte that must be escaped in a JSON string.
+   * @return The index of the first such byte, or size if there is none.
+   */
+  inline std::size_t findJsonSpecial(const char* data, std::size_t size)
+  {
+	  return kernels().findJsonSpecial(data, size);
+  }
+
+  /**
+   * @brief Finds the first occurrence of a byte.
+   * @return The index of the first occurrence, or size if there is none.
+   */
+  inline std::size_t findByte(const char* data, std::size_t size, char byte)
+  {
+	  return kernels().findByte(data, size, byte);
+  }
+
+  /**
+   * @brief Appends text to a string, escaping the characters that are special in HTML.
+   * @param out The string to append to.
+   * @param text The text to escape.
+   */
+  void appendHtmlEscaped(std::string& out, std::string_view text);
+
+  /**
+   * @brief Appends text to a string, escaping it for use inside a JSON string literal.
+   * @param out The string to append to.
+   * @param text The text to escape.
+   */
+  void appendJsonEscaped(std::string& out, std::string_view text);
+
+  /**
+   * @brief Appends text to a string, inserting the indentation after every newline.
+   * @param out The string to append to.
+   * @param text The (possibly multi-line) text to append.
+   * @param indentation The indentation to insert at the start of every continuation line.
+   */
+  void appendIndented(std::string& out, std::string_view text, std::string_view indentation);
+
+  /**
+   * @brief Appends text to a string, replacing every occurrence of a substring.
+   * @param out The string to append to.
+   * @param text The original text.
+   * @param from The substring to replace. Must not be empty.
+   * @param to The substring to replace with.
+   */
+  void appendReplaced(std::string& out, std::string_view text, std::string_view from, std::string_view to);
+
+} // namespace Logify::simd
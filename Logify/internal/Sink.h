@@ -0,0 +1,237 @@
+/*
+ * Logify Logger Library - Internal Sink Interface
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the Sink class, the common base of every destination a
+ * Logger writes to (output streams, consoles and files). Each sink carries its own
+ * mutex and minimum log level, so that logging threads only contend on the sinks
+ * that actually write their messages. Each sink also counts the bytes it writes, its
+ * flushes, write errors and file rotations for Logger::stats().
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Logify/Logger.h"
+#include "LogRecord.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+
+namespace Logify
+{
+
+  class QueuedRecord;
+
+  /**
+   * @class Sink
+   * @brief Base class of all log destinations, with a per-sink lock and minimum level.
+   *
+   * Derived classes implement write(); the Logger calls submit(), which serializes the
+   * writes to this sink only.
+   */
+  class Sink
+  {
+   public:
+	  /**
+	   * @brief Constructs a Sink with the given minimum log level.
+	   * @param minLevel The lowest level of the messages written by this sink.
+	   */
+	  explicit Sink(LogLevel minLevel)
+		  : minLevel_(minLevel), bytesWritten_(0), flushes_(0), writeErrors_(0), rotations_(0)
+	  {}
+
+	  /**
+	   * @brief Destroys the Sink.
+	   */
+	  virtual ~Sink() = default;
+
+	  Sink(const Sink&)            = delete;
+	  Sink& operator=(const Sink&) = delete;
+
+	  /**
+	   * @brief Checks whether this sink writes messages of the given level. Takes no lock.
+	   * @param level The log level to check.
+	   * @return True if the sink writes messages of this level, otherwise false.
+	   */
+	  [[nodiscard]] bool accepts(LogLevel level) const
+	  {
+		  return level >= minLevel_;
+	  }
+
+	  /**
+	   * @brief Retrieves the minimum log level of this sink.
+	   * @return The lowest level of the messages written by this sink.
+	   */
+	  [[nodiscard]] LogLevel minLevel() const
+	  {
+		  return minLevel_;
+	  }
+
+	  /**
+	   * @brief Writes a log record while holding this sink's lock.
+	   * @param record The log record to write.
+	   */
+	  void submit(const LogRecord& record)
+	  {
+		  std::lock_guard<std::mutex> lock(mutex_);
+		  write(record);
+	  }
+
+	  /**
+	   * @brief Writes the data buffered by this sink to its destination, while holding the sink's lock.
+	   */
+	  void flush()
+	  {
+		  std::lock_guard<std::mutex> lock(mutex_);
+		  sync();
+	  }
+
+	  /**
+	   * @brief Takes this sink's lock before a fork, after writing its buffered data.
+	   *
+	   * Called by the forking thread while no record is being written to the sink, so that
+	   * the child inherits neither a held lock nor data the parent writes as well.
+	   */
+	  void lockForFork()
+	  {
+		  mutex_.lock();
+		  prepareFork();
+	  }
+
+	  /**
+	   * @brief Releases the lock taken by lockForFork() in the parent.
+	   */
+	  void unlockInParent()
+	  {
+		  parentAfterFork();
+		  mutex_.unlock();
+	  }
+
+	  /**
+	   * @brief Releases the lock taken by lockForFork() in the child, after giving up the parent's background work.
+	   */
+	  void unlockInChild()
+	  {
+		  childAfterFork();
+		  mutex_.unlock();
+	  }
+
+	  /**
+	   * @brief Writes the data buffered by this sink from a fatal signal handler.
+	   *
+	   * Takes no lock and only makes async-signal-safe calls on already open file descriptors.
+	   * The default does nothing, for sinks that cannot be written safely.
+	   */
+	  virtual void flushAfterCrash() noexcept
+	  {}
+
+	  /**
+	   * @brief Writes a queued record from a fatal signal handler, like flushAfterCrash().
+	   * @param record The queued record to write.
+	   */
+	  virtual void writeAfterCrash(const QueuedRecord& /*record*/) noexcept
+	  {}
+
+	  /**
+	   * @brief Retrieves a snapshot of this sink's counters. Takes no lock.
+	   * @return The name and counters of this sink.
+	   */
+	  [[nodiscard]] SinkStats stats() const
+	  {
+		  return {
+			  name(),
+			  bytesWritten_.load(std::memory_order_relaxed),
+			  flushes_.load(std::memory_order_relaxed),
+			  writeErrors_.load(std::memory_order_relaxed),
+			  rotations_.load(std::memory_order_relaxed)
+		  };
+	  }
+
+	  /**
+	   * @brief Retrieves a name describing the destination of this sink, used in its statistics.
+	   */
+	  [[nodiscard]] virtual std::string name() const = 0;
+
+   protected:
+	  /**
+	   * @brief Writes a log record to the destination. Called with the sink's lock held.
+	   * @param record The log record to write.
+	   */
+	  virtual void write(const LogRecord& record) = 0;
+
+	  /**
+	   * @brief Writes buffered data to the destination. Called with the sink's lock held.
+	   *
+	   * The default does nothing, for sinks that write every record immediately.
+	   */
+	  virtual void sync()
+	  {}
+
+	  /**
+	   * @brief Prepares the sink for a fork. Called with the sink's lock held.
+	   *
+	   * The default writes the buffered data; sinks with a background thread also take its locks.
+	   */
+	  virtual void prepareFork()
+	  {
+		  sync();
+	  }
+
+	  /**
+	   * @brief Releases what prepareFork() took, in the parent. Called with the sink's lock held.
+	   */
+	  virtual void parentAfterFork()
+	  {}
+
+	  /**
+	   * @brief Releases what prepareFork() took and gives up the parent's background work, in the child.
+	   *
+	   * Called with the sink's lock held, while the child has no other thread. No thread may be
+	   * started here; sinks with a background thread start a new one with their next write.
+	   */
+	  virtual void childAfterFork()
+	  {}
+
+	  /**
+	   * @brief Counts bytes written to the destination. Called from write().
+	   */
+	  void countBytes(std::uint64_t bytes) { bytesWritten_.fetch_add(bytes, std::memory_order_relaxed); }
+
+	  /**
+	   * @brief Counts a flush of buffered data to the operating system. Called from write().
+	   */
+	  void countFlush() { flushes_.fetch_add(1, std::memory_order_relaxed); }
+
+	  /**
+	   * @brief Counts a failed write. Called from write().
+	   */
+	  void countWriteError() { writeErrors_.fetch_add(1, std::memory_order_relaxed); }
+
+	  /**
+	   * @brief Counts a file rotation. Called from write().
+	   */
+	  void countRotation() { rotations_.fetch_add(1, std::memory_order_relaxed); }
+
+   private:
+	  const LogLevel             minLevel_;      ///< The lowest level of the messages written by this sink.
+	  std::mutex                 mutex_;         ///< Serializes the writes to this sink.
+	  std::atomic<std::uint64_t> bytesWritten_;  ///< Number of bytes written.
+	  std::atomic<std::uint64_t> flushes_;       ///< Number of flushes.
+	  std::atomic<std::uint64_t> writeErrors_;   ///< Number of failed writes.
+	  std::atomic<std::uint64_t> rotations_;     ///< Number of file rotations.
+  };
+
+} // namespace Logify
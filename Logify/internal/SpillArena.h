@@ -0,0 +1,149 @@
+/*
+ * Logify Logger Library - Internal Spill Arena
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the SpillArena, the storage of record data that does not fit
+ * into the inline storage of a record slot. An arena carves spilled data out of large
+ * chunks with a bump pointer, and a chunk is recycled as a whole once every record placed
+ * in it has been released, such as after the background writer has written them.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace Logify
+{
+
+  class SpillPool;
+
+  /**
+   * @struct SpillChunk
+   * @brief A block of spilled record data, shared by the records placed in it.
+   *
+   * The chunk counts the records placed in it, plus one while it is its arena's current
+   * chunk; the last release hands it back to the pool of its arena.
+   */
+  struct SpillChunk
+  {
+	  std::atomic<std::size_t>   references;  ///< Records placed in the chunk, plus one while current.
+	  std::size_t                used;        ///< Bytes handed out, only changed by the owning arena.
+	  std::size_t                capacity;    ///< Bytes of data following the header.
+	  std::shared_ptr<SpillPool> pool;        ///< The pool the chunk returns to; empty while it is pooled.
+
+	  /**
+	   * @brief Retrieves the data of the chunk, which follows its header.
+	   */
+	  char* data()
+	  {
+		  return reinterpret_cast<char*>(this + 1);
+	  }
+  };
+
+  /**
+   * @class SpillPool
+   * @brief The free chunks of one arena, refilled by whichever thread releases a chunk last.
+   */
+  class SpillPool
+  {
+   public:
+	  /**
+	   * @brief Frees the pooled chunks.
+	   */
+	  ~SpillPool();
+
+	  /**
+	   * @brief Takes a free chunk of the standard size, or allocates one.
+	   * @param capacity The data size of the chunk.
+	   */
+	  SpillChunk* acquire(std::size_t capacity);
+
+	  /**
+	   * @brief Returns a chunk whose references have all been released.
+	   *
+	   * Chunks of the standard size are kept for reuse; larger ones are freed.
+	   * @param chunk The chunk to return.
+	   */
+	  void recycle(SpillChunk* chunk);
+
+   private:
+	  std::mutex               mutex_;  ///< Protects free_.
+	  std::vector<SpillChunk*> free_;   ///< The chunks ready for reuse.
+  };
+
+  /**
+   * @class SpillArena
+   * @brief Hands out spill storage from its current chunk. Not thread-safe.
+   *
+   * Records whose storage is released in roughly the order it was allocated share an arena,
+   * so chunks are recycled soon after they fill up: the queued records of a thread use the
+   * thread's arena, and each ring of held records uses an arena of its own.
+   */
+  class SpillArena
+  {
+   public:
+	  static constexpr std::size_t ChunkSize = 64 * 1024;  ///< The data size of a standard chunk.
+
+	  /**
+	   * @brief Constructs an empty SpillArena; chunks are allocated on demand.
+	   */
+	  SpillArena();
+
+	  /**
+	   * @brief Releases the current chunk, which lives on until its records are released.
+	   */
+	  ~SpillArena();
+
+	  SpillArena(const SpillArena&)            = delete;
+	  SpillArena& operator=(const SpillArena&) = delete;
+
+	  /**
+	   * @brief Retrieves the arena of the calling thread, used for the records it queues.
+	   */
+	  static SpillArena& forThread();
+
+	  /**
+	   * @brief Allocates spill storage from the current chunk.
+	   *
+	   * Data larger than a quarter of a chunk gets a chunk of its own.
+	   * @param size The number of bytes needed.
+	   * @param chunk Receives the chunk that holds the storage; pass it to release().
+	   * @return The storage, aligned to 8 bytes.
+	   */
+	  char* allocate(std::size_t size, SpillChunk*& chunk);
+
+	  /**
+	   * @brief Releases storage obtained from allocate(), from any thread.
+	   * @param chunk The chunk that holds the storage.
+	   */
+	  static void release(SpillChunk* chunk) noexcept;
+
+   private:
+	  /**
+	   * @brief Takes a chunk from the pool with one reference, returning to this arena's pool.
+	   * @param capacity The data size of the chunk.
+	   */
+	  SpillChunk* take(std::size_t capacity);
+
+   private:
+	  std::shared_ptr<SpillPool> pool_;     ///< The free chunks of this arena.
+	  SpillChunk*                current_;  ///< The chunk storage is carved from, if any.
+  };
+
+} // namespace Logify
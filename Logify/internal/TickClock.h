@@ -0,0 +1,51 @@
+/*
+ * Logify Logger Library - Internal Tick Clock
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the TickClock, the clock read when a message is logged. The
+ * logging thread only reads the raw ticks of the steady clock; the conversion to the
+ * wall-clock time happens when the record is formatted, using an offset between the two
+ * clocks that is re-synchronized periodically to follow adjustments of the system time.
+ *
+ * Note:
+ * This file is part of the internal implementation of the Logify library and is not
+ * intended for direct use by library users.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+
+namespace Logify::TickClock
+{
+
+  /// How long an offset between the steady clock and the wall clock is used before it is measured again.
+  inline constexpr std::chrono::seconds ResyncInterval{1};
+
+  /**
+   * @brief Reads the raw ticks of the steady clock; the only clock access on the logging path.
+   */
+  inline std::uint64_t now() noexcept
+  {
+	  return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  }
+
+  /**
+   * @brief Converts raw ticks to the wall-clock time, re-measuring the offset if it is due.
+   *
+   * Lock-free and async-signal-safe, so the crash handler may call it.
+   * @param ticks Ticks returned by now().
+   * @return The wall-clock time at which the ticks were read.
+   */
+  std::chrono::system_clock::time_point toTime(std::uint64_t ticks) noexcept;
+
+} // namespace Logify::TickClock
@@ -0,0 +1,187 @@
+#include "CivilTime.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace
+{
+  constexpr std::int64_t SecondsPerDay = 86'400;
+
+  // How far the period of an offset is searched for its ends; transitions are at most a year apart.
+  constexpr std::int64_t SearchDays = 400;
+
+  /**
+   * @brief A period in which the local time zone has the same UTC offset.
+   */
+  struct OffsetPeriod
+  {
+	  std::int64_t               from;      ///< First second of the period.
+	  std::int64_t               until;     ///< First second after the period.
+	  Logify::civil::LocalOffset offset;    ///< The offset during the period; zone points to name.
+	  char                       name[16];  ///< The abbreviation of the zone.
+  };
+
+  /**
+   * @brief Asks the C library for the UTC offset of local time at a point in time.
+   */
+  Logify::civil::LocalOffset queryOffset(std::int64_t seconds, char (&name)[16])
+  {
+	  auto    time = static_cast<std::time_t>(seconds);
+	  std::tm local{};
+#ifdef _WIN32
+	  localtime_s(&local, &time);
+	  std::int64_t offset = static_cast<std::int64_t>(_mkgmtime(&local)) - seconds;
+	  _get_tzname(nullptr, name, sizeof(name), local.tm_isdst > 0 ? 1 : 0);
+#else
+	  localtime_r(&time, &local);
+	  std::int64_t offset = local.tm_gmtoff;
+	  std::strncpy(name, local.tm_zone ? local.tm_zone : "", sizeof(name) - 1);
+	  name[sizeof(name) - 1] = '\0';
+#endif
+	  return {offset, local.tm_isdst > 0, nullptr};
+  }
+
+  /**
+   * @brief Finds the first second, going from lo in the direction of step, with a different offset.
+   *
+   * Steps a day at a time, then bisects the day in which the offset changes.
+   * @param lo The start of the search.
+   * @param step +1 to search forward, -1 to search backward.
+   * @param offset The offset at lo.
+   * @return The boundary, or the end of the search range if the offset does not change.
+   */
+  std::int64_t findChange(std::int64_t lo, int step, std::int64_t offset)
+  {
+	  char name[16];
+	  for (std::int64_t day = 1; day <= SearchDays; ++day)
+	  {
+		  std::int64_t hi = lo + step * SecondsPerDay;
+		  if (queryOffset(hi, name).seconds != offset)
+		  {
+			  // The offset at lo is the old one and the offset at hi the new one.
+			  while ((hi - lo) * step > 1)
+			  {
+				  std::int64_t middle = lo + (hi - lo) / 2;
+				  if (queryOffset(middle, name).seconds == offset) lo = middle;
+				  else hi = middle;
+			  }
+			  return hi;
+		  }
+		  lo = hi;
+	  }
+	  return lo;
+  }
+
+  /**
+   * @brief The periods seen so far, with a lock-free lookup of the one used last.
+   */
+  class OffsetCache
+  {
+   public:
+	  OffsetCache()
+	  {
+		  // Read the time zone settings once.
+#ifdef _WIN32
+		  _tzset();
+#else
+		  tzset();
+#endif
+	  }
+
+	  /**
+	   * @brief Takes the lock of the cache, so that no other thread is changing it during a fork.
+	   */
+	  void lock() { mutex_.lock(); }
+
+	  /**
+	   * @brief Releases the lock taken by lock().
+	   */
+	  void unlock() { mutex_.unlock(); }
+
+	  Logify::civil::LocalOffset at(std::int64_t seconds)
+	  {
+		  const OffsetPeriod* period = current_.load(std::memory_order_acquire);
+		  if (period != nullptr && seconds >= period->from && seconds < period->until) return period->offset;
+		  return refresh(seconds);
+	  }
+
+   private:
+	  Logify::civil::LocalOffset refresh(std::int64_t seconds)
+	  {
+		  std::lock_guard<std::mutex> lock(mutex_);
+
+		  // Records are mostly formatted in order, but dumps may go back to an earlier period.
+		  for (const auto& period : periods_)
+		  {
+			  if (seconds >= period->from && seconds < period->until)
+			  {
+				  current_.store(period.get(), std::memory_order_release);
+				  return period->offset;
+			  }
+		  }
+
+		  // A new period: find where its offset starts and stops applying.
+		  auto period         = std::make_unique<OffsetPeriod>();
+		  period->offset      = queryOffset(seconds, period->name);
+		  period->offset.zone = period->name;
+		  period->from        = findChange(seconds, -1, period->offset.seconds) + 1;
+		  period->until       = findChange(seconds, 1, period->offset.seconds);
+
+		  current_.store(period.get(), std::memory_order_release);
+		  return periods_.emplace_back(std::move(period))->offset;
+	  }
+
+	  std::atomic<const OffsetPeriod*>           current_{nullptr};  ///< The period used last.
+	  std::mutex                                 mutex_;             ///< Protects periods_.
+	  std::vector<std::unique_ptr<OffsetPeriod>> periods_;           ///< The periods seen so far; never removed.
+  };
+
+  OffsetCache& offsetCache()
+  {
+	  static OffsetCache cache;
+	  return cache;
+  }
+}
+
+void Logify::civil::breakDown(std::int64_t seconds, std::tm& result) noexcept
+{
+	// Split into days and the time of day, rounding towards the past for times before 1970.
+	std::int64_t days    = seconds / SecondsPerDay;
+	std::int64_t dayTime = seconds % SecondsPerDay;
+	if (dayTime < 0)
+	{
+		dayTime += SecondsPerDay;
+		--days;
+	}
+
+	Date date         = fromDays(days);
+	result.tm_year    = static_cast<int>(date.year - 1900);
+	result.tm_mon     = static_cast<int>(date.month - 1);
+	result.tm_mday    = static_cast<int>(date.day);
+	result.tm_hour    = static_cast<int>(dayTime / 3'600);
+	result.tm_min     = static_cast<int>(dayTime / 60 % 60);
+	result.tm_sec     = static_cast<int>(dayTime % 60);
+	result.tm_yday    = static_cast<int>(days - toDays(date.year, 1, 1));
+
+	// 1970-01-01 was a Thursday.
+	std::int64_t weekday = (days + 4) % 7;
+	result.tm_wday       = static_cast<int>(weekday < 0 ? weekday + 7 : weekday);
+}
+
+Logify::civil::LocalOffset Logify::civil::localOffset(std::int64_t seconds)
+{
+	return offsetCache().at(seconds);
+}
+
+void Logify::civil::lockForFork() noexcept
+{
+	offsetCache().lock();
+}
+
+void Logify::civil::unlockAfterFork() noexcept
+{
+	offsetCache().unlock();
+}
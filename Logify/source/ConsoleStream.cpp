@@ -0,0 +1,86 @@
+#include "ConsoleStream.h"
+#include "Formatting.h"
+#include "CrashWriter.h"
+#include <cerrno>
+
+
+#ifdef _WIN32
+
+#include <io.h>
+
+#else
+#include <unistd.h>
+#endif
+
+
+Logify::ConsoleStream::ConsoleStream(ConsoleTarget target, LogLevel minLevel)
+	: Sink(minLevel), fd_(target == ConsoleTarget::StdErr ? 2 : 1), isTerminal_(false)
+{
+	// Detect once whether the output goes to a terminal, rather than to a file or pipe.
+#ifdef _WIN32
+	isTerminal_ = _isatty(fd_) != 0;
+#else
+	isTerminal_ = isatty(fd_) != 0;
+#endif
+
+	// Precompute the color bytes per level; redirected output is written without colors.
+	if (isTerminal_)
+	{
+		for (int level = 0; level < static_cast<int>(prefixes_.size()); ++level)
+		{
+			prefixes_[level] = ConsoleColors::forLevel(static_cast<LogLevel>(level));
+		}
+		suffix_ = ConsoleColors::Reset;
+	}
+}
+
+std::string Logify::ConsoleStream::name() const
+{
+	return fd_ == 2 ? "stderr" : "stdout";
+}
+
+void Logify::ConsoleStream::writeAfterCrash(const QueuedRecord& record) noexcept
+{
+	CrashWriter writer(fd_);
+	writer.appendTextLine(record, ": ");
+}
+
+void Logify::ConsoleStream::write(const LogRecord& record)
+{
+	// Format the whole record into the reused buffer, so it is written with a single call.
+	buffer_.clear();
+	buffer_ += prefixes_[static_cast<int>(record.level)];
+	format::appendTextLine(buffer_, record);
+	buffer_ += suffix_;
+
+	flushBuffer();
+}
+
+void Logify::ConsoleStream::flushBuffer()
+{
+	const char* data = buffer_.data();
+	std::size_t size = buffer_.size();
+
+	while (size > 0)
+	{
+#ifdef _WIN32
+		int written = _write(fd_, data, static_cast<unsigned int>(size));
+#else
+		ssize_t written = ::write(fd_, data, size);
+#endif
+		if (written < 0)
+		{
+			// Retry if interrupted by a signal; otherwise the console is gone and the record is dropped.
+			if (errno == EINTR) continue;
+			countWriteError();
+			return;
+		}
+
+		data += written;
+		size -= static_cast<std::size_t>(written);
+		countBytes(static_cast<std::uint64_t>(written));
+	}
+
+	// Each record is handed to the operating system with (usually) one system call.
+	countFlush();
+}
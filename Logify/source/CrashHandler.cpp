@@ -0,0 +1,110 @@
+#include "CrashHandler.h"
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+
+
+namespace
+{
+  // The maximum number of listeners (live loggers) written on a crash.
+  constexpr std::size_t MaxListeners = 64;
+
+  // The signals after which the process cannot continue.
+#ifdef _WIN32
+  constexpr std::array<int, 4> FatalSignals{SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+#else
+  constexpr std::array<int, 5> FatalSignals{SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS};
+#endif
+
+  std::array<std::atomic<Logify::CrashListener*>, MaxListeners> listeners{};
+  std::atomic_flag                                              crashed = ATOMIC_FLAG_INIT;
+  std::terminate_handler                                        previousTerminate = nullptr;
+
+#ifdef _WIN32
+  std::array<void (*)(int), FatalSignals.size()> previousHandlers{};
+#else
+  std::array<struct sigaction, FatalSignals.size()> previousActions{};
+#endif
+
+  // Writes the pending records of every listener, once, even if several threads crash.
+  void writePendingRecords() noexcept
+  {
+	  if (crashed.test_and_set()) return;
+
+	  for (auto& slot : listeners)
+	  {
+		  Logify::CrashListener* listener = slot.load();
+		  if (listener != nullptr) listener->writeAfterCrash();
+	  }
+  }
+
+  void onFatalSignal(int signal)
+  {
+	  writePendingRecords();
+
+	  // Restore the previous handler and raise the signal again, so the process dies as it would have.
+	  for (std::size_t i = 0; i < FatalSignals.size(); ++i)
+	  {
+		  if (FatalSignals[i] != signal) continue;
+#ifdef _WIN32
+		  std::signal(signal, previousHandlers[i] == SIG_ERR ? SIG_DFL : previousHandlers[i]);
+#else
+		  sigaction(signal, &previousActions[i], nullptr);
+#endif
+	  }
+	  std::raise(signal);
+  }
+
+  [[noreturn]] void onTerminate()
+  {
+	  writePendingRecords();
+
+	  // Let the previous handler report the exception; it is expected to abort as well.
+	  if (previousTerminate != nullptr) previousTerminate();
+	  std::abort();
+  }
+}
+
+void Logify::crash::install()
+{
+	static std::once_flag installed;
+	std::call_once(installed, []() {
+		// Catch the fatal signals, remembering the previous handlers for re-raising.
+		for (std::size_t i = 0; i < FatalSignals.size(); ++i)
+		{
+#ifdef _WIN32
+			previousHandlers[i] = std::signal(FatalSignals[i], onFatalSignal);
+#else
+			struct sigaction action{};
+			action.sa_handler = onFatalSignal;
+			sigemptyset(&action.sa_mask);
+			sigaction(FatalSignals[i], &action, &previousActions[i]);
+#endif
+		}
+
+		// Catch uncaught exceptions and other calls of std::terminate.
+		previousTerminate = std::set_terminate(onTerminate);
+	});
+}
+
+void Logify::crash::registerListener(CrashListener* listener) noexcept
+{
+	// Take the first free slot; without one, the listener is not written on a crash.
+	for (auto& slot : listeners)
+	{
+		CrashListener* expected = nullptr;
+		if (slot.compare_exchange_strong(expected, listener)) return;
+	}
+}
+
+void Logify::crash::unregisterListener(CrashListener* listener) noexcept
+{
+	for (auto& slot : listeners)
+	{
+		CrashListener* expected = listener;
+		if (slot.compare_exchange_strong(expected, nullptr)) return;
+	}
+}
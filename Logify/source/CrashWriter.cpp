@@ -0,0 +1,319 @@
+#include "CrashWriter.h"
+#include "Formatting.h"
+#include "CivilTime.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+
+#ifdef _WIN32
+
+#include <io.h>
+
+#else
+#include <unistd.h>
+#endif
+
+
+bool Logify::writeAll(int fd, const char* data, std::size_t size) noexcept
+{
+	while (size > 0)
+	{
+#ifdef _WIN32
+		int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+		ssize_t written = ::write(fd, data, size);
+#endif
+		if (written < 0)
+		{
+			// Retry if interrupted by a signal; any other error loses the rest of the data.
+			if (errno == EINTR) continue;
+			return false;
+		}
+
+		data += written;
+		size -= static_cast<std::size_t>(written);
+	}
+	return true;
+}
+
+bool Logify::writeAllAt(int fd, const char* data, std::size_t size, std::uint64_t offset) noexcept
+{
+#ifdef _WIN32
+	// Without pwrite, move the file position and write from there.
+	if (_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0) return false;
+	return writeAll(fd, data, size);
+#else
+	while (size > 0)
+	{
+		ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+		if (written < 0)
+		{
+			// Retry if interrupted by a signal; any other error loses the rest of the data.
+			if (errno == EINTR) continue;
+			return false;
+		}
+
+		data += written;
+		size -= static_cast<std::size_t>(written);
+		offset += static_cast<std::uint64_t>(written);
+	}
+	return true;
+#endif
+}
+
+void Logify::CrashWriter::append(std::string_view text) noexcept
+{
+	while (!text.empty())
+	{
+		// Copy as much as fits, writing the buffer whenever it is full.
+		if (size_ == sizeof(buffer_)) flush();
+
+		std::size_t count = std::min(text.size(), sizeof(buffer_) - size_);
+		std::memcpy(buffer_ + size_, text.data(), count);
+		size_ += count;
+		text.remove_prefix(count);
+	}
+}
+
+void Logify::CrashWriter::appendTimestamp(std::chrono::system_clock::time_point time) noexcept
+{
+	using namespace std::chrono;
+
+	// Split the time into days and the time of day, without any library call that may take a lock.
+	auto milliseconds = duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+	auto days         = milliseconds / 86'400'000;
+	auto dayMillis    = milliseconds % 86'400'000;
+	if (dayMillis < 0)
+	{
+		dayMillis += 86'400'000;
+		--days;
+	}
+
+	// Convert the days since 1970-01-01 to a civil date (proleptic Gregorian calendar).
+	civil::Date date = civil::fromDays(days);
+
+	// Writes a number with leading zeros to the given width.
+	auto appendPadded = [this](long long value, int width) {
+		char digits[8];
+		for (int i = width - 1; i >= 0; --i)
+		{
+			digits[i] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+		append(std::string_view(digits, static_cast<std::size_t>(width)));
+	};
+
+	appendPadded(date.year, 4);
+	append("-");
+	appendPadded(date.month, 2);
+	append("-");
+	appendPadded(date.day, 2);
+	append(" ");
+	appendPadded(dayMillis / 3'600'000, 2);
+	append(":");
+	appendPadded(dayMillis / 60'000 % 60, 2);
+	append(":");
+	appendPadded(dayMillis / 1'000 % 60, 2);
+	append(".");
+	appendPadded(dayMillis % 1'000, 3);
+	append(" UTC");
+}
+
+void Logify::CrashWriter::appendJsonEscaped(std::string_view text) noexcept
+{
+	static constexpr char hex[] = "0123456789abcdef";
+
+	for (char c : text)
+	{
+		switch (c)
+		{
+			case '"':
+				append("\\\"");
+				break;
+			case '\\':
+				append("\\\\");
+				break;
+			case '\n':
+				append("\\n");
+				break;
+			case '\r':
+				append("\\r");
+				break;
+			case '\t':
+				append("\\t");
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					const char escaped[] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF]};
+					append(std::string_view(escaped, sizeof(escaped)));
+				}
+				else
+				{
+					append(std::string_view(&c, 1));
+				}
+				break;
+		}
+	}
+}
+
+void Logify::CrashWriter::appendHtmlEscaped(std::string_view text) noexcept
+{
+	for (char c : text)
+	{
+		switch (c)
+		{
+			case '&':
+				append("&amp;");
+				break;
+			case '<':
+				append("&lt;");
+				break;
+			case '>':
+				append("&gt;");
+				break;
+			case '"':
+				append("&quot;");
+				break;
+			case '\'':
+				append("&#39;");
+				break;
+			case '\n':
+				append("<br>");
+				break;
+			default:
+				append(std::string_view(&c, 1));
+				break;
+		}
+	}
+}
+
+void Logify::CrashWriter::appendTextLine(const QueuedRecord& record, std::string_view separator) noexcept
+{
+	append("[");
+	appendTimestamp(record.time());
+	append("][ID:");
+	appendNumber(record.pid());
+	append("/");
+	appendNumber(record.tid());
+	append("][");
+	append(format::levelLabel(record.level()));
+	append("]");
+	append(separator);
+	append(record.message());
+
+	record.forEachField([this](const Field& field) {
+		append(" ");
+		append(field.key());
+		append("=");
+		appendFieldValue(field);
+	});
+	append("\n");
+}
+
+void Logify::CrashWriter::appendJsonLine(const QueuedRecord& record) noexcept
+{
+	auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(record.time().time_since_epoch());
+
+	append("{\"ts\":");
+	appendNumber(nanoseconds.count());
+	append(",\"pid\":");
+	appendNumber(record.pid());
+	append(",\"tid\":");
+	appendNumber(record.tid());
+	append(",\"level\":\"");
+	append(format::levelName(record.level()));
+	append("\",\"message\":\"");
+	appendJsonEscaped(record.message());
+	append("\"");
+
+	bool first = true;
+	record.forEachField([this, &first](const Field& field) {
+		append(first ? ",\"fields\":{\"" : ",\"");
+		first = false;
+		appendJsonEscaped(field.key());
+		append("\":");
+		appendJsonValue(field);
+	});
+	if (!first) append("}");
+	append("}\n");
+}
+
+void Logify::CrashWriter::appendHtmlRow(const QueuedRecord& record) noexcept
+{
+	std::string_view level = format::levelLabel(record.level());
+
+	append("<tr class=\"log-entry\"><td class=\"timestamp\">");
+	appendTimestamp(record.time());
+	append("</td><td class=\"pid-tid\">[");
+	appendNumber(record.pid());
+	append("/");
+	appendNumber(record.tid());
+	append("]</td><td class=\"level ");
+	append(level);
+	append("\">");
+	append(level);
+	append("</td><td class=\"message ");
+	append(level);
+	append("\">");
+	appendHtmlEscaped(record.message());
+	append("</td><td class=\"fields\">");
+
+	record.forEachField([this](const Field& field) {
+		append("<span class=\"field-key\">");
+		appendHtmlEscaped(field.key());
+		append("</span>=<span class=\"field-value\">");
+		if (field.type() == Field::Type::String) appendHtmlEscaped(field.asString());
+		else appendFieldValue(field);
+		append("</span> ");
+	});
+	append("</td></tr>\n");
+}
+
+void Logify::CrashWriter::flush() noexcept
+{
+	if (size_ == 0) return;
+
+	writeAll(fd_, buffer_, size_);
+	size_ = 0;
+}
+
+void Logify::CrashWriter::appendFieldValue(const Field& field) noexcept
+{
+	switch (field.type())
+	{
+		case Field::Type::Int:
+			appendNumber(field.asInt());
+			break;
+		case Field::Type::UInt:
+			appendNumber(field.asUInt());
+			break;
+		case Field::Type::Double:
+			appendNumber(field.asDouble());
+			break;
+		case Field::Type::Bool:
+			append(field.asBool() ? "true" : "false");
+			break;
+		case Field::Type::String:
+			append("\"");
+			appendJsonEscaped(field.asString());
+			append("\"");
+			break;
+	}
+}
+
+void Logify::CrashWriter::appendJsonValue(const Field& field) noexcept
+{
+	switch (field.type())
+	{
+		case Field::Type::Double:
+			if (std::isfinite(field.asDouble())) appendNumber(field.asDouble());
+			else append("null");
+			break;
+		default:
+			appendFieldValue(field);
+			break;
+	}
+}
@@ -1,12 +1,77 @@
 
 #include "FileStream.h"
+#include "SimdKernels.h"
+#include "Formatting.h"
+#include "CrashWriter.h"
+#include "LogSegments.h"
+#include "ForkHandler.h"
 #include <sstream>
+#include <string_view>
 #include <iomanip>
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
 #include <filesystem>
+#include <fcntl.h>
 
 
-Logify::FileStream::FileStream(const std::string& filename, std::size_t maxFileSize, const ColorScheme& scheme)
-	: maxFileSize_(maxFileSize), fileIndex_(0), colorScheme_(scheme)
+#ifdef _WIN32
+
+#include <io.h>
+#include <process.h>
+#include <sys/stat.h>
+
+#else
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+  // The header cell of the fields column, which HTML files written before fields were added lack.
+  constexpr std::string_view HtmlFieldsColumn = "<th class=\"fields\">";
+
+  // The bytes read from the start of an HTML file to find its header row.
+  constexpr std::size_t HtmlHeaderSize = 8192;
+
+  // Reads up to size bytes at an offset of a file; returns the number of bytes read.
+  std::size_t readAt(int fd, char* data, std::size_t size, std::uint64_t offset)
+  {
+	  std::size_t total = 0;
+	  while (total < size)
+	  {
+#ifdef _WIN32
+		  if (_lseeki64(fd, static_cast<__int64>(offset + total), SEEK_SET) < 0) break;
+		  int count = _read(fd, data + total, static_cast<unsigned int>(size - total));
+#else
+		  ssize_t count = ::pread(fd, data + total, size - total, static_cast<off_t>(offset + total));
+		  if (count < 0 && errno == EINTR) continue;
+#endif
+		  if (count <= 0) break;
+		  total += static_cast<std::size_t>(count);
+	  }
+	  return total;
+  }
+}
+
+
+Logify::FileStream::FileStream(const std::string& filename, const FileStreamOptions& options)
+	:
+	Sink(options.minLevel),
+	maxFileSize_(options.maxFileSize),
+	fileIndex_(0),
+	rotation_(options.rotation),
+	nextRotation_(std::chrono::system_clock::time_point::min()),
+	scanned_(false),
+	fd_(-1),
+	fileSize_(0),
+	preallocate_(options.preallocate),
+	allocatedEnd_(0),
+	indexInterval_(options.indexInterval),
+	indexFd_(-1),
+	indexEntry_{},
+	colorScheme_(options.scheme),
+	limits_{options.maxFiles, options.maxTotalBytes, options.maxAge}
 {
 
 	// Extract the filename and its extension.
@@ -23,67 +88,69 @@ Logify::FileStream::FileStream(const std::string& filename, std::size_t maxFileS
 		extensionName_ = "log";
 	}
 
-	// Determine the type of file extension (LOG or HTML).
+	// Determine the type of file extension (LOG, HTML or JSONL).
 	extension_ = determineExtensionType(extensionName_);
 
-	// Ensure that the file index is incremented until no rotation is needed.
-	while (shouldRotate()) ++fileIndex_;
+	// Start the background deletion of old files if any retention limit is set.
+	if (limits_.any()) retention_ = std::make_unique<RetentionWorker>(logFileName_, extensionName_, limits_);
 
-	// Open the initial file for writing.
-	openFile();
+	// The existing files are not touched here; the file is opened on the first message.
 }
 
 Logify::FileStream::~FileStream()
 {
-	if (fileStream_ && fileStream_->is_open())
-	{
-		// Close HTML tags if the file is in HTML format.
-		if (extension_ == FileExtension::HTML) (*fileStream_) << HTML_ending;
-
-		// Close the file stream.
-		fileStream_->close();
-	}
+	closeFile();
 }
 
-void Logify::FileStream::write(
-	const std::string& timestamp,
-	const std::string& pid,
-	const std::string& tid,
-	const std::string& level,
-	const std::string& message,
-	size_t indent
-)
+void Logify::FileStream::write(const LogRecord& record)
 {
+	// Start a new file when the record's time reaches the next period; a single comparison per message.
+	if (rotation_ != RotationInterval::None && record.time >= nextRotation_) startPeriod(record.time);
+
+	// Open the file on the first message, or retry if it could not be opened before.
+	if (fd_ < 0) openFile();
+
 	// Check if the file needs to be rotated due to exceeding the max file size.
-	if (shouldRotate()) rotateFile();
+	if (fd_ >= 0 && shouldRotate()) rotateFile();
 
-	// Ensure the file stream is open and valid.
-	if (fileStream_ && fileStream_->is_open())
+	// Ensure the file is open.
+	if (fd_ >= 0)
 	{
+		const std::string_view timestamp = record.timestamp;
+		const std::string_view level     = format::levelLabel(record.level);
+		const std::string_view message   = record.message;
+		const size_t           indent    = record.indent;
+
 		// Generate the indentation string
 		std::string indentation(indent * 2, ' ');
+		std::string line;
 
 		if (extension_ == FileExtension::HTML)
 		{
-			// Split the message into code and comment parts
-			std::string codePart   = message;
-			std::string commentPart;
-			size_t      commentPos = message.find("//");
-			size_t      scopePos   = message.find('{');
+			// Split the message into code and comment parts, escaping the text for HTML
+			std::string_view text = message;
+			std::string      codePart;
+			std::string      commentPart;
+			size_t           commentPos = text.find("//");
+			size_t           scopePos   = text.find('{');
 
 			// Scope found
 			if (scopePos != std::string::npos)
 			{
-
-				codePart =
-					"<span class=\"scope\">" + message.substr(0, scopePos) + "</span> {";  // Everything before "//"
-
+				codePart = "<span class=\"scope\">";
+				simd::appendHtmlEscaped(codePart, text.substr(0, scopePos));  // Everything before "{"
+				codePart += "</span> {";
+			}
+			else
+			{
+				simd::appendHtmlEscaped(codePart, text);
 			}
 
 			if (commentPos != std::string::npos)
 			{
-				codePart    = message.substr(0, commentPos);    // Everything before "//"
-				commentPart = message.substr(commentPos);        // "//" and everything after
+				codePart.clear();
+				simd::appendHtmlEscaped(codePart, text.substr(0, commentPos));  // Everything before "//"
+				simd::appendHtmlEscaped(commentPart, text.substr(commentPos));  // "//" and everything after
 			}
 
 			// Replace newlines in the code part with <br> tags for formatting
@@ -96,133 +163,496 @@ void Logify::FileStream::write(
 			// Combine the parts into the final HTML-formatted message
 			std::string message_ = coloredCodePart + coloredCommentPart;
 
+			// Render the fields as key=value pairs for their own column
+			std::string fieldsCell;
+			for (const Field& field : record.fields)
+			{
+				std::string value;
+				format::appendFieldValue(value, field);
+
+				if (!fieldsCell.empty()) fieldsCell += ' ';
+				fieldsCell += "<span class=\"field-key\">";
+				simd::appendHtmlEscaped(fieldsCell, field.key());
+				fieldsCell += "</span>=<span class=\"field-value\">";
+				simd::appendHtmlEscaped(fieldsCell, value);
+				fieldsCell += "</span>";
+			}
+
 			// Create a span for indentation with a fixed width
 			std::string htmlIndentation = "<span style=\"display:inline-block; width:" + std::to_string(indent * 20)
 				+ "px;\"></span>";
 
 
-			// Write the log entry in an HTML table row format.
-			(*fileStream_) << "<tr class=\"log-entry\">"
-						   << "<td class=\"timestamp\">" << timestamp << "</td>"
-						   << "<td class=\"pid-tid\">[" << pid << "/" << tid << "]</td>"
-						   << "<td class=\"level " << level << "\">" << level << "</td>"
-						   << "<td class=\"message " << level << "\">" << htmlIndentation << message_ << "</td>"
-						   << "</tr>\n";
+			// Build the log entry in an HTML table row format.
+			line += "<tr class=\"log-entry\">";
+			line += "<td class=\"timestamp\">";
+			line += timestamp;
+			line += "</td><td class=\"pid-tid\">[";
+			format::appendNumber(line, record.pid);
+			line += '/';
+			format::appendNumber(line, record.tid);
+			line += "]</td><td class=\"level ";
+			line += level;
+			line += "\">";
+			line += level;
+			line += "</td><td class=\"message ";
+			line += level;
+			line += "\">";
+			line += htmlIndentation;
+			line += message_;
+			line += "</td><td class=\"fields\">";
+			line += fieldsCell;
+			line += "</td></tr>\n";
+		}
+		else if (extension_ == FileExtension::JSONL)
+		{
+			line.reserve(96 + message.size());
+			format::appendJsonLine(line, record);
 		}
 		else
 		{
-			// Write the log entry in the default LOG format.
-			(*fileStream_) << "[" << timestamp << "][ID:" << pid << "/" << tid << "][" << level << "] "
-						   << indentation << message
-						   << std::endl;
+			// Indent every line of a multi-line message, not only the first one.
+			std::string body = indentation;
+			simd::appendIndented(body, message, indentation);
+			format::appendKeyValues(body, record.fields);
+
+			// Build the log entry in the default LOG format.
+			line += '[';
+			line += timestamp;
+			line += "][ID:";
+			format::appendNumber(line, record.pid);
+			line += '/';
+			format::appendNumber(line, record.tid);
+			line += "][";
+			line += level;
+			line += "] ";
+			line += body;
+			line += '\n';
 		}
+
+		// Index the entry at the position it will have in the file.
+		if (indexInterval_ > 0) indexRecord(record, writeOffset() + buffer_.size(), line.size());
+
+		// Collect the entry; LOG and JSONL entries are written at once, HTML rows once the buffer is full.
+		buffer_ += line;
+		if (extension_ != FileExtension::HTML || buffer_.size() >= BufferCapacity) flushBuffer();
+	}
+	else
+	{
+		// The file could not be opened; the message is lost.
+		countWriteError();
 	}
 }
 
-bool Logify::FileStream::isFileIntact()
+void Logify::FileStream::sync()
 {
-	std::string filePath   = generateFilePath();
-	bool        fileExists = std::filesystem::exists(filePath);
+	flushBuffer();
+}
 
-	// If the file does not exist, it is considered intact.
-	if (!fileExists) return true;
+void Logify::FileStream::childAfterFork()
+{
+	// Close the inherited descriptors only; truncating or ending the file would change the parent's file.
+#ifdef _WIN32
+	if (fd_ >= 0) _close(fd_);
+	if (indexFd_ >= 0) _close(indexFd_);
+	std::string pid = std::to_string(_getpid());
+#else
+	if (fd_ >= 0) ::close(fd_);
+	if (indexFd_ >= 0) ::close(indexFd_);
+	std::string pid = std::to_string(getpid());
+#endif
+	logFileName_.append(".").append(pid);
+	fd_           = -1;
+	indexFd_      = -1;
+	fileSize_     = 0;
+	allocatedEnd_ = 0;
+	indexEntry_   = {};
+	buffer_.clear();
+
+	// The next message opens the file of the child, continuing an existing one of the same name.
+	fileIndex_ = 0;
+	scanned_   = false;
+
+	// The retention worker's thread does not exist in the child and may have held its lock; the next
+	// file opened starts a worker of the child for the child's files.
+	forking::abandon(retention_);
+}
+
+void Logify::FileStream::flushBuffer()
+{
+	if (buffer_.empty()) return;
 
-	// If the file is HTML, validate the ending tags.
+	bool written;
 	if (extension_ == FileExtension::HTML)
 	{
-		// If the ending tags are not correct, the file is not intact.
-		if (!validateEndTags(filePath, HTML_ending)) return false;
+		// Write the rows and the closing tags in one call, over the closing tags of the previous batch.
+		std::uint64_t offset = writeOffset();
+		buffer_ += HTML_ending;
+		reserveSpace(offset + buffer_.size());
+		written = writeAllAt(fd_, buffer_.data(), buffer_.size(), offset);
+		if (written) fileSize_ = offset + buffer_.size();
+	}
+	else
+	{
+		reserveSpace(fileSize_ + buffer_.size());
+		written = writeAll(fd_, buffer_.data(), buffer_.size());
+		if (written) fileSize_ += buffer_.size();
+	}
+
+	if (written)
+	{
+		countBytes(buffer_.size());
+		countFlush();
+	}
+	else
+	{
+		countWriteError();
+	}
+	buffer_.clear();
+}
+
+void Logify::FileStream::reserveSpace([[maybe_unused]] std::uint64_t size)
+{
+#ifdef __linux__
+	if (preallocate_ == 0 || size <= allocatedEnd_) return;
+
+	// Reserve the next chunk, but not beyond the rotation size unless the data itself goes beyond it.
+	std::uint64_t limit = std::max<std::uint64_t>(maxFileSize_, size);
+	std::uint64_t end   = std::max(std::min<std::uint64_t>(allocatedEnd_ + preallocate_, limit), size);
+
+	// The file size stays the same; only blocks are allocated. Stop trying if the file system cannot do it.
+	auto offset = static_cast<off_t>(allocatedEnd_);
+	auto length = static_cast<off_t>(end - allocatedEnd_);
+	if (::fallocate(fd_, FALLOC_FL_KEEP_SIZE, offset, length) == 0)
+	{
+		allocatedEnd_ = end;
+	}
+	else
+	{
+		preallocate_ = 0;
+	}
+#endif
+}
+
+void Logify::FileStream::indexRecord(const LogRecord& record, std::uint64_t offset, std::size_t size)
+{
+	if (indexFd_ < 0) return;
+
+	// Write the entry of the current part once it spans the interval; the record starts the next part.
+	if (indexEntry_.end > indexEntry_.begin && offset >= indexEntry_.begin + indexInterval_) writeIndexEntry();
+
+	// Widen the time range of the part; dumped records may be older than the ones before them.
+	auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(record.time.time_since_epoch()).count();
+	if (indexEntry_.end == indexEntry_.begin)
+	{
+		indexEntry_ = {time, time, offset, offset + size};
+	}
+	else
+	{
+		indexEntry_.earliest = std::min(indexEntry_.earliest, time);
+		indexEntry_.latest   = std::max(indexEntry_.latest, time);
+		indexEntry_.end      = offset + size;
+	}
+}
+
+void Logify::FileStream::writeIndexEntry() noexcept
+{
+	if (indexFd_ < 0 || indexEntry_.end == indexEntry_.begin) return;
+
+	// Append a single entry; the index is only read by tools, so a lost entry just widens the range read.
+	writeAll(indexFd_, reinterpret_cast<const char*>(&indexEntry_), sizeof(indexEntry_));
+	indexEntry_ = {};
+}
+
+void Logify::FileStream::flushAfterCrash() noexcept
+{
+	if (fd_ < 0) return;
 
-		// Calculate the new size after removing the incorrect tags.
-		std::streamoff newSize = std::filesystem::file_size(filePath) - HTML_ending.length();
+	// Keep the time range of the current part; the records written after it are read in full by the tools.
+	writeIndexEntry();
 
-		// Truncate the file to remove the invalid end.
-		truncateFileEnd(filePath, newSize);
+	// Write the buffered rows as they are; the buffer is not cleared, as no memory may be released here.
+	if (buffer_.empty()) return;
 
-		// The file is now considered intact and ready for writing.
+	if (extension_ == FileExtension::HTML)
+	{
+		// Keep the file complete: the rows go over the closing tags, which are written again after them.
+		std::uint64_t offset = writeOffset();
+		if (!writeAllAt(fd_, buffer_.data(), buffer_.size(), offset)) return;
+		if (!writeAllAt(fd_, HTML_ending.data(), HTML_ending.size(), offset + buffer_.size())) return;
+		fileSize_ = offset + buffer_.size() + HTML_ending.size();
+	}
+	else
+	{
+		writeAll(fd_, buffer_.data(), buffer_.size());
+	}
+}
+
+void Logify::FileStream::writeAfterCrash(const QueuedRecord& record) noexcept
+{
+	if (fd_ < 0) return;
+
+	if (extension_ == FileExtension::HTML)
+	{
+		// Write the row and the closing tags from the start of the previous closing tags.
+		std::uint64_t offset = writeOffset();
+#ifdef _WIN32
+		_lseeki64(fd_, static_cast<__int64>(offset), SEEK_SET);
+#else
+		::lseek(fd_, static_cast<off_t>(offset), SEEK_SET);
+#endif
+		{
+			CrashWriter writer(fd_);
+			writer.appendHtmlRow(record);
+			writer.append(HTML_ending);
+		}
+#ifdef _WIN32
+		fileSize_ = static_cast<std::uint64_t>(std::max<__int64>(_lseeki64(fd_, 0, SEEK_CUR), 0));
+#else
+		fileSize_ = static_cast<std::uint64_t>(std::max<off_t>(::lseek(fd_, 0, SEEK_CUR), 0));
+#endif
+		return;
 	}
 
-	return true;
+	CrashWriter writer(fd_);
+	if (extension_ == FileExtension::JSONL) writer.appendJsonLine(record);
+	else writer.appendTextLine(record, " ");
+}
+
+std::string Logify::FileStream::name() const
+{
+	return logFileName_ + "." + extensionName_;
 }
 
 void Logify::FileStream::openFile()
 {
-	// Attempt to ensure the file is intact up to 5 times.
-	for (int i = 0; i < 5; ++i)
+	// On the first open, continue with the highest existing index, found with a single directory scan.
+	if (!scanned_)
 	{
-		if (isFileIntact()) break;
-		fileIndex_++;
+		fileIndex_ = findLastIndex();
+		scanned_   = true;
 	}
 
 	// Generate the file path using the current file index.
-	std::string filePath   = generateFilePath();
-	bool        fileExists = std::filesystem::exists(filePath);
+	std::string filePath = generateFilePath();
 
-	// Open the file stream for appending.
-	fileStream_ = std::make_unique<std::ofstream>(filePath, std::ios::out | std::ios::app);
-	if (!fileStream_->is_open())
+	// Open the file for appending; HTML files are written at an offset, over their closing tags, and read once.
+	bool append = extension_ != FileExtension::HTML;
+#ifdef _WIN32
+	fd_ = _open(
+		filePath.c_str(),
+		(append ? _O_WRONLY | _O_APPEND : _O_RDWR) | _O_CREAT | _O_BINARY,
+		_S_IREAD | _S_IWRITE
+	);
+#else
+	fd_ = ::open(filePath.c_str(), (append ? O_WRONLY | O_APPEND : O_RDWR) | O_CREAT | O_CLOEXEC, 0644);
+#endif
+	// If the file cannot be opened, the messages are counted as write errors and opening is retried.
+	if (fd_ < 0) return;
+
+	// Start from the current size of the file, which is then tracked without asking the file system.
+#ifdef _WIN32
+	fileSize_ = static_cast<std::uint64_t>(std::max<__int64>(_lseeki64(fd_, 0, SEEK_END), 0));
+#else
+	fileSize_ = static_cast<std::uint64_t>(std::max<off_t>(::lseek(fd_, 0, SEEK_END), 0));
+#endif
+	allocatedEnd_ = fileSize_;
+
+	// An HTML file that cannot be continued is left as it is, and the next index is used instead.
+	if (extension_ == FileExtension::HTML && fileSize_ > 0 && !canContinueHtml())
 	{
-		throw std::runtime_error("Failed to open log file: " + filePath);
+#ifdef _WIN32
+		_close(fd_);
+#else
+		::close(fd_);
+#endif
+		fd_ = -1;
+		++fileIndex_;
+		openFile();
+		return;
 	}
 
-	// If the file is HTML and new, write the initial HTML structure and styles.
-	if (extension_ == FileExtension::HTML && !fileExists)
+	// If the file is HTML and new, write the initial HTML structure and styles, followed by the closing tags.
+	if (extension_ == FileExtension::HTML && fileSize_ == 0)
 	{
-		(*fileStream_) << "<!DOCTYPE html><html><head><style>"
-					   << "body { background-color: " << colorScheme_.background << "; color: "
-					   << colorScheme_.defaultColor << "; font-family: Arial, sans-serif; }"
-					   << "table { width: 100%; border-collapse: collapse; }"
-					   << "th, td { padding: 10px; text-align: left; border-bottom: 1px solid #ddd; }"
-					   << "th.timestamp, td.timestamp { width: fit-content; white-space: nowrap; }"
-					   << "th.pid-tid, td.pid-tid { width: fit-content; white-space: nowrap; }"
-					   << "th.level, td.level { width: fit-content; white-space: nowrap; }"
-					   << "th.message, td.message { width: 90%; word-wrap: break-word; }"
-					   << ".timestamp { color: " << colorScheme_.timestampColor << "; font-style: oblique; }"
-					   << ".pid-tid { color: " << colorScheme_.pidTidColor << "; }"
-					   << ".level.DEBUG { color: " << colorScheme_.debugColor << "; }"
-					   << ".level.INFO { color: " << colorScheme_.infoColor << "; }"
-					   << ".level.WARN { color: " << colorScheme_.warnColor << "; }"
-					   << ".level.ERROR { color: " << colorScheme_.errorColor << "; }"
-					   << ".level.FATAL { color: " << colorScheme_.errorColor << "; }"
-					   << ".message { color: " << colorScheme_.defaultColor << "; }"
-					   << ".message.FATAL { color: " << colorScheme_.errorColor << "; }"
-					   << ".message.ERROR { color: " << colorScheme_.errorColor << "; }"
-					   << ".message.WARN { color: " << colorScheme_.warnColor << "; }"
-					   << ".scope { color: " << colorScheme_.scopeColor << "; font-weight: bold; }"
-					   << "</style></head><body><h2>Logify Logs</h2><table>\n"
-					   << "<tr><th class=\"timestamp\">Timestamp</th><th class=\"pid-tid\">PID/TID</th><th class=\"level\">Level</th><th class=\"message\">Message</th></tr>\n";
+		std::ostringstream header;
+		header << "<!DOCTYPE html><html><head><style>"
+			   << "body { background-color: " << colorScheme_.background << "; color: "
+			   << colorScheme_.defaultColor << "; font-family: Arial, sans-serif; }"
+			   << "table { width: 100%; border-collapse: collapse; }"
+			   << "th, td { padding: 10px; text-align: left; border-bottom: 1px solid #ddd; }"
+			   << "th.timestamp, td.timestamp { width: fit-content; white-space: nowrap; }"
+			   << "th.pid-tid, td.pid-tid { width: fit-content; white-space: nowrap; }"
+			   << "th.level, td.level { width: fit-content; white-space: nowrap; }"
+			   << "th.message, td.message { width: 90%; word-wrap: break-word; }"
+			   << ".timestamp { color: " << colorScheme_.timestampColor << "; font-style: oblique; }"
+			   << ".pid-tid { color: " << colorScheme_.pidTidColor << "; }"
+			   << ".level.DEBUG { color: " << colorScheme_.debugColor << "; }"
+			   << ".level.INFO { color: " << colorScheme_.infoColor << "; }"
+			   << ".level.WARN { color: " << colorScheme_.warnColor << "; }"
+			   << ".level.ERROR { color: " << colorScheme_.errorColor << "; }"
+			   << ".level.FATAL { color: " << colorScheme_.errorColor << "; }"
+			   << ".message { color: " << colorScheme_.defaultColor << "; }"
+			   << ".message.FATAL { color: " << colorScheme_.errorColor << "; }"
+			   << ".message.ERROR { color: " << colorScheme_.errorColor << "; }"
+			   << ".message.WARN { color: " << colorScheme_.warnColor << "; }"
+			   << ".scope { color: " << colorScheme_.scopeColor << "; font-weight: bold; }"
+			   << "th.fields, td.fields { width: fit-content; white-space: nowrap; }"
+			   << ".field-key { color: " << colorScheme_.pidTidColor << "; }"
+			   << ".field-value { color: " << colorScheme_.defaultColor << "; }"
+			   << "</style></head><body><h2>Logify Logs</h2><table>\n"
+			   << "<tr><th class=\"timestamp\">Timestamp</th><th class=\"pid-tid\">PID/TID</th><th class=\"level\">Level</th><th class=\"message\">Message</th><th class=\"fields\">Fields</th></tr>\n";
+		buffer_ += header.str();
+		flushBuffer();
 	}
+
+	// Open the time index of the file; its first new entry is the next record.
+	if (indexInterval_ > 0)
+	{
+		std::string indexFile = indexPath(filePath);
+#ifdef _WIN32
+		indexFd_ = _open(indexFile.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		indexFd_ = ::open(indexFile.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+		indexEntry_ = {};
+	}
+
+	// Delete the files beyond the retention limits, without waiting for it.
+	if (limits_.any())
+	{
+		if (!retention_) retention_ = std::make_unique<RetentionWorker>(logFileName_, extensionName_, limits_);
+		retention_->schedule(period_, fileIndex_);
+	}
+}
+
+void Logify::FileStream::closeFile()
+{
+	if (fd_ < 0) return;
+
+	// Write the remaining entries; HTML files already end with their closing tags.
+	flushBuffer();
+	writeIndexEntry();
+
+#ifdef __linux__
+	// Release the reserved space beyond the data.
+	if (allocatedEnd_ > fileSize_) (void) ::ftruncate(fd_, static_cast<off_t>(fileSize_));
+#endif
+
+	// Close the file and its index.
+#ifdef _WIN32
+	_close(fd_);
+	if (indexFd_ >= 0) _close(indexFd_);
+#else
+	::close(fd_);
+	if (indexFd_ >= 0) ::close(indexFd_);
+#endif
+	fd_      = -1;
+	indexFd_ = -1;
 }
 
 // Generates the file path using the base name, file index, and extension.
 std::string Logify::FileStream::generateFilePath() const
 {
 	std::ostringstream oss;
-	oss << logFileName_ << "_" << std::setw(4) << std::setfill('0') << fileIndex_ << "." << extensionName_;
+	oss << logFileName_ << "_";
+	if (!period_.empty()) oss << period_ << "_";
+	oss << std::setw(4) << std::setfill('0') << fileIndex_ << "." << extensionName_;
 	return oss.str();
 }
 
-// Determines if the file needs to be rotated based on its size.
+// Determines if the file needs to be rotated based on its size, including the buffered entries.
 bool Logify::FileStream::shouldRotate() const
 {
-	std::string filePath = generateFilePath();
-	return std::filesystem::exists(filePath) && std::filesystem::file_size(filePath) >= maxFileSize_;
+	return fileSize_ + buffer_.size() >= maxFileSize_;
 }
 
-// Rotates the log file by closing the current file and opening a new one.
-void Logify::FileStream::rotateFile()
+// Finds the highest index of the existing files of this stream, or 0 if there are none.
+int Logify::FileStream::findLastIndex() const
+{
+	int lastIndex = 0;
+	for (const LogSegment& segment : findLogSegments(logFileName_, extensionName_))
+	{
+		if (segment.period == period_) lastIndex = std::max(lastIndex, segment.index);
+	}
+	return lastIndex;
+}
+
+bool Logify::FileStream::canContinueHtml() const
+{
+	// The closing tags are overwritten by the next rows, so they must be the end of the file; a file of a
+	// process that crashed before writing them, or of another tool, would lose its last bytes.
+	std::string tail(HTML_ending.size(), '\0');
+	if (fileSize_ < tail.size() || readAt(fd_, tail.data(), tail.size(), fileSize_ - tail.size()) != tail.size()) return false;
+	if (tail != HTML_ending) return false;
+
+	// The rows have a fields column, which the header of the table must have too.
+	std::string head(static_cast<std::size_t>(std::min<std::uint64_t>(fileSize_, HtmlHeaderSize)), '\0');
+	head.resize(readAt(fd_, head.data(), head.size(), 0));
+	return head.find(HtmlFieldsColumn) != std::string::npos;
+}
+
+std::uint64_t Logify::FileStream::writeOffset() const noexcept
 {
-	if (fileStream_ && fileStream_->is_open())
+	if (extension_ != FileExtension::HTML) return fileSize_;
+
+	// A new HTML file has no closing tags yet.
+	return fileSize_ - std::min<std::uint64_t>(fileSize_, HTML_ending.size());
+}
+
+void Logify::FileStream::startPeriod(std::chrono::system_clock::time_point time)
+{
+	// Close the file of the previous period, if one was written.
+	if (fd_ >= 0)
 	{
-		// Close the HTML tags if the file is in HTML format.
-		if (extension_ == FileExtension::HTML) (*fileStream_) << HTML_ending;
+		closeFile();
+		countRotation();
+	}
 
-		// Close the current file stream.
-		fileStream_->close();
+	// Convert to local time once per period.
+	std::time_t timeT = std::chrono::system_clock::to_time_t(time);
+	std::tm     local{};
+#ifdef _WIN32
+	localtime_s(&local, &timeT);
+#else
+	localtime_r(&timeT, &local);
+#endif
+
+	// Name the period and truncate the time to its start.
+	char name[32];
+	local.tm_min = 0;
+	local.tm_sec = 0;
+	if (rotation_ == RotationInterval::Hourly)
+	{
+		std::strftime(name, sizeof(name), "%Y-%m-%d_%H", &local);
+		local.tm_hour += 1;
+	}
+	else
+	{
+		std::strftime(name, sizeof(name), "%Y-%m-%d", &local);
+		local.tm_hour = 0;
+		local.tm_mday += 1;
 	}
 
+	// The next period starts at the following boundary; mktime normalizes the date and applies DST.
+	local.tm_isdst = -1;
+	nextRotation_  = std::chrono::system_clock::from_time_t(std::mktime(&local));
+
+	// The files of the new period are numbered from the highest existing index of that period.
+	period_    = name;
+	fileIndex_ = 0;
+	scanned_   = false;
+}
+
+// Rotates the log file by closing the current file and opening a new one.
+void Logify::FileStream::rotateFile()
+{
+	// Close the current file, completing its HTML tags.
+	closeFile();
+
 	// Increment the file index for the new file.
 	++fileIndex_;
+	countRotation();
 	openFile();
 }
 
@@ -242,66 +672,26 @@ Logify::FileExtension Logify::FileStream::determineExtensionType(const std::stri
 	// Return HTML type for "html" or "htm" extensions.
 	if (extension == "html" || extension == "htm") return FileExtension::HTML;
 
+	// Return JSONL type for "jsonl" or "ndjson" extensions.
+	if (extension == "jsonl" || extension == "ndjson") return FileExtension::JSONL;
+
 	// Default to LOG type.
 	return FileExtension::LOG;
 }
 
-bool Logify::FileStream::validateEndTags(const std::string& filePath, const std::string& expectedEnd)
-{
-	/*
-	 * Validates that the file ends with the expected HTML ending tags.
-	 */
-
-	std::ifstream file(filePath, std::ios::in | std::ios::binary);
-	if (!file.is_open()) return false;
-
-	auto size = static_cast<long long>(expectedEnd.size());
-
-	// Seek to the position of the expected end tags.
-	file.seekg(-size, std::ios::end);
-	std::string endTags(size, '\0');
-
-	// Read the end of the file.
-	file.read(&endTags[0], size);
-	file.close();
-
-	// Return true if the tags match.
-	return endTags == expectedEnd;
-}
-
-void Logify::FileStream::truncateFileEnd(const std::string& filePath, std::streamoff truncatePosition)
-{
-	std::ofstream outFile(filePath, std::ios::in | std::ios::out | std::ios::binary);
-	if (!outFile.is_open()) return;
-
-	// Seek to the truncate position.
-	outFile.seekp(truncatePosition);
-	outFile.close();
-
-	// Resize the file to the new size.
-	std::filesystem::resize_file(filePath, truncatePosition);
-}
-
 std::string Logify::FileStream::replace(
-	const std::string& text_,
+	const std::string& text,
 	const std::string& to_replace,
 	const std::string& replace_with
 )
 {
-	std::string text = text_;
+	// Nothing to search for; return the text unchanged.
+	if (to_replace.empty()) return text;
 
-	// Find the first occurrence of the substring to replace.
-	size_t pos = text.find(to_replace);
-
-	// Loop until no more occurrences are found.
-	while (pos != std::string::npos)
-	{
-		// Replace the substring with the desired string
-		text.replace(pos, to_replace.length(), replace_with);
-
-		// Find the next occurrence of the substring
-		pos = text.find(to_replace, pos + replace_with.length());
-	}
+	// Scan the text once, copying the runs between occurrences into the result.
+	std::string result;
+	result.reserve(text.size());
+	simd::appendReplaced(result, text, to_replace, replace_with);
 
-	return text;
+	return result;
 }
@@ -0,0 +1,120 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+
+namespace
+{
+  // Identifiers of the recorders, never reused, so a thread never mistakes a new recorder for a destroyed one.
+  std::atomic<std::uint64_t> nextRecorderId{1};
+}
+
+Logify::FlightRecorder::FlightRecorder(std::size_t recordsPerThread)
+	:
+	id_(nextRecorderId.fetch_add(1, std::memory_order_relaxed)),
+	recordsPerThread_(std::max<std::size_t>(recordsPerThread, 1))
+{}
+
+void Logify::FlightRecorder::record(const LogRecord& record)
+{
+	ThreadRing& ring = threadRing();
+
+	// Copy the record into the oldest slot; only takeRecords() competes for this lock.
+	std::lock_guard<std::mutex> lock(ring.mutex);
+	ring.records.push(record);
+}
+
+void Logify::FlightRecorder::takeRecords(std::vector<QueuedRecord>& records)
+{
+	std::size_t                 count = 0;
+	std::lock_guard<std::mutex> ringsLock(ringsMutex_);
+	for (const auto& ring : rings_)
+	{
+		// Move the records out oldest first, releasing the previously taken ones.
+		std::lock_guard<std::mutex> lock(ring->mutex);
+		ring->records.takeInto(records, count);
+	}
+	records.resize(count);
+
+	// Merge the threads' records into one timeline; each ring is already in order.
+	std::stable_sort(records.begin(), records.end(), [](const QueuedRecord& a, const QueuedRecord& b) {
+		return a.ticks() < b.ticks();
+	});
+}
+
+void Logify::FlightRecorder::lockForFork()
+{
+	// The same order as takeRecords().
+	ringsMutex_.lock();
+	for (const auto& ring : rings_) ring->mutex.lock();
+}
+
+void Logify::FlightRecorder::unlockInParent()
+{
+	for (const auto& ring : rings_) ring->mutex.unlock();
+	ringsMutex_.unlock();
+}
+
+void Logify::FlightRecorder::unlockInChild()
+{
+	for (const auto& ring : rings_)
+	{
+		// Only the forking thread survives; the rings of the others are free.
+		if (ring->owner != std::this_thread::get_id()) ring->owner = std::thread::id();
+		ring->mutex.unlock();
+	}
+	ringsMutex_.unlock();
+}
+
+Logify::FlightRecorder::ThreadRing& Logify::FlightRecorder::threadRing()
+{
+	// The rings the calling thread records into, per recorder; released for reuse when the thread exits.
+	struct OwnedRings
+	{
+		std::vector<std::pair<std::uint64_t, std::shared_ptr<ThreadRing>>> rings;
+
+		~OwnedRings()
+		{
+			for (auto& [id, ring] : rings)
+			{
+				std::lock_guard<std::mutex> lock(ring->mutex);
+				ring->owner = std::thread::id();
+			}
+		}
+	};
+	thread_local OwnedRings owned;
+
+	// A thread usually records for one or two loggers, so a linear search is the fastest lookup.
+	for (const auto& [id, ring] : owned.rings)
+	{
+		if (id == id_) return *ring;
+	}
+
+	// First record of this thread: reuse the ring of an exited thread, or add a new one.
+	std::shared_ptr<ThreadRing> ring;
+	{
+		std::lock_guard<std::mutex> ringsLock(ringsMutex_);
+		for (const auto& candidate : rings_)
+		{
+			std::lock_guard<std::mutex> lock(candidate->mutex);
+			if (candidate->owner == std::thread::id())
+			{
+				candidate->owner = std::this_thread::get_id();
+				ring             = candidate;
+				break;
+			}
+		}
+
+		if (!ring)
+		{
+			ring = std::make_shared<ThreadRing>(recordsPerThread_);
+			rings_.push_back(ring);
+		}
+	}
+
+	// Forget the rings of destroyed recorders, which only this thread still holds.
+	std::erase_if(owned.rings, [](const auto& entry) { return entry.second.use_count() == 1; });
+	owned.rings.emplace_back(id_, ring);
+	return *ring;
+}
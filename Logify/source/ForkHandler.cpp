@@ -0,0 +1,92 @@
+#include "ForkHandler.h"
+#include "CivilTime.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+
+namespace
+{
+  /**
+   * @brief The registered listeners, locked from the preparation of a fork until it is done.
+   */
+  struct Registry
+  {
+	  std::mutex                         mutex;      ///< Protects listeners; held across a fork.
+	  std::vector<Logify::ForkListener*> listeners;  ///< The live listeners, in the order of registration.
+  };
+
+  Registry& registry()
+  {
+	  static Registry instance;
+	  return instance;
+  }
+
+  std::atomic<std::uint64_t> forks{0};
+
+#ifndef _WIN32
+  void prepare()
+  {
+	  Registry& listeners = registry();
+	  listeners.mutex.lock();
+	  for (Logify::ForkListener* listener : listeners.listeners) listener->prepareFork();
+
+	  // The time zone cache is taken last: it is never held while waiting for another lock.
+	  Logify::civil::lockForFork();
+  }
+
+  void resumeParent()
+  {
+	  Logify::civil::unlockAfterFork();
+
+	  Registry& listeners = registry();
+	  for (auto it = listeners.listeners.rbegin(); it != listeners.listeners.rend(); ++it) (*it)->parentAfterFork();
+	  listeners.mutex.unlock();
+  }
+
+  void resumeChild()
+  {
+	  // Count the fork first, so that the listeners already see the IDs of the child.
+	  forks.fetch_add(1, std::memory_order_relaxed);
+	  Logify::civil::unlockAfterFork();
+
+	  Registry& listeners = registry();
+	  for (auto it = listeners.listeners.rbegin(); it != listeners.listeners.rend(); ++it) (*it)->childAfterFork();
+	  listeners.mutex.unlock();
+  }
+#endif
+}
+
+void Logify::forking::registerListener([[maybe_unused]] ForkListener* listener)
+{
+#ifndef _WIN32
+	// The handlers cannot be removed again, so they are installed once and call the listeners registered at the time.
+	static std::once_flag installed;
+	std::call_once(installed, []() { pthread_atfork(prepare, resumeParent, resumeChild); });
+
+	Registry&                   listeners = registry();
+	std::lock_guard<std::mutex> lock(listeners.mutex);
+	listeners.listeners.push_back(listener);
+#endif
+}
+
+void Logify::forking::unregisterListener([[maybe_unused]] ForkListener* listener) noexcept
+{
+#ifndef _WIN32
+	Registry&                   listeners = registry();
+	std::lock_guard<std::mutex> lock(listeners.mutex);
+	auto it = std::find(listeners.listeners.begin(), listeners.listeners.end(), listener);
+	if (it != listeners.listeners.end()) listeners.listeners.erase(it);
+#endif
+}
+
+std::uint64_t Logify::forking::generation() noexcept
+{
+	return forks.load(std::memory_order_relaxed);
+}
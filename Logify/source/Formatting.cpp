@@ -0,0 +1,168 @@
+#include "Formatting.h"
+#include "SimdKernels.h"
+#include <chrono>
+#include <cmath>
+#include <cctype>
+
+
+std::optional<Logify::LogLevel> Logify::format::parseLevel(std::string_view name)
+{
+	// Trim the whitespace around the name, such as the newline at the end of a file.
+	auto isSpace = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+	while (!name.empty() && isSpace(name.front())) name.remove_prefix(1);
+	while (!name.empty() && isSpace(name.back())) name.remove_suffix(1);
+
+	// Compare with each level name, ignoring case.
+	for (int i = static_cast<int>(LogLevel::TRACE); i <= static_cast<int>(LogLevel::FATAL); ++i)
+	{
+		auto             level    = static_cast<LogLevel>(i);
+		std::string_view expected = levelName(level);
+		bool             matches  = name.size() == expected.size();
+		for (std::size_t j = 0; matches && j < name.size(); ++j)
+		{
+			matches = std::toupper(static_cast<unsigned char>(name[j])) == expected[j];
+		}
+		if (matches) return level;
+	}
+	return std::nullopt;
+}
+
+void Logify::format::appendFieldValue(std::string& out, const Field& field)
+{
+	switch (field.type())
+	{
+		case Field::Type::Int:
+			appendNumber(out, field.asInt());
+			break;
+		case Field::Type::UInt:
+			appendNumber(out, field.asUInt());
+			break;
+		case Field::Type::Double:
+			appendNumber(out, field.asDouble());
+			break;
+		case Field::Type::Bool:
+			out += field.asBool() ? "true" : "false";
+			break;
+		case Field::Type::String:
+		{
+			std::string_view value = field.asString();
+
+			// Plain words are written as is; anything that could be misread is quoted.
+			bool plain = !value.empty()
+				&& value.find_first_of(" =") == std::string_view::npos
+				&& simd::findJsonSpecial(value.data(), value.size()) == value.size();
+			if (plain)
+			{
+				out += value;
+			}
+			else
+			{
+				out += '"';
+				simd::appendJsonEscaped(out, value);
+				out += '"';
+			}
+			break;
+		}
+	}
+}
+
+void Logify::format::appendKeyValues(std::string& out, std::span<const Field> fields)
+{
+	for (const Field& field : fields)
+	{
+		out += ' ';
+		out += field.key();
+		out += '=';
+		appendFieldValue(out, field);
+	}
+}
+
+void Logify::format::appendJsonValue(std::string& out, const Field& field)
+{
+	switch (field.type())
+	{
+		case Field::Type::Int:
+			appendNumber(out, field.asInt());
+			break;
+		case Field::Type::UInt:
+			appendNumber(out, field.asUInt());
+			break;
+		case Field::Type::Double:
+			if (std::isfinite(field.asDouble())) appendNumber(out, field.asDouble());
+			else out += "null";
+			break;
+		case Field::Type::Bool:
+			out += field.asBool() ? "true" : "false";
+			break;
+		case Field::Type::String:
+			out += '"';
+			simd::appendJsonEscaped(out, field.asString());
+			out += '"';
+			break;
+	}
+}
+
+void Logify::format::appendJsonMembers(std::string& out, std::span<const Field> fields)
+{
+	bool first = true;
+	for (const Field& field : fields)
+	{
+		if (!first) out += ',';
+		first = false;
+
+		out += '"';
+		simd::appendJsonEscaped(out, field.key());
+		out += "\":";
+		appendJsonValue(out, field);
+	}
+}
+
+void Logify::format::appendTextLine(std::string& out, const LogRecord& record)
+{
+	out += '[';
+	out += record.timestamp;
+	out += "][ID:";
+	appendNumber(out, record.pid);
+	out += '/';
+
+	// Ensure the thread ID is at least 3 characters long by padding with zeros if necessary
+	char tid[32];
+	auto result = std::to_chars(tid, tid + sizeof(tid), record.tid);
+	auto digits = static_cast<std::size_t>(result.ptr - tid);
+	if (digits < 3) out.append(3 - digits, '0');
+	out.append(tid, digits);
+
+	out += "][";
+	out += levelLabel(record.level);
+	out += "]: ";
+	out += record.message;
+	appendKeyValues(out, record.fields);
+	out += '\n';
+}
+
+void Logify::format::appendJsonLine(std::string& out, const LogRecord& record)
+{
+	// Build the JSON object with numeric time, pid and tid, and the escaped message.
+	auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(record.time.time_since_epoch());
+
+	out += "{\"ts\":";
+	appendNumber(out, nanoseconds.count());
+	out += ",\"pid\":";
+	appendNumber(out, record.pid);
+	out += ",\"tid\":";
+	appendNumber(out, record.tid);
+	out += ",\"level\":\"";
+	out += levelName(record.level);
+	out += "\",\"message\":\"";
+	simd::appendJsonEscaped(out, record.message);
+	out += '"';
+
+	// Keep the fields in their native JSON types.
+	if (!record.fields.empty())
+	{
+		out += ",\"fields\":{";
+		appendJsonMembers(out, record.fields);
+		out += '}';
+	}
+	out += "}\n";
+}
@@ -0,0 +1,207 @@
+#include "LevelControl.h"
+#include "ForkHandler.h"
+#include "Formatting.h"
+#include <array>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+  // The maximum number of levels changed by the signals.
+  constexpr std::size_t MaxTargets = 64;
+
+  std::array<std::atomic<std::atomic<Logify::LogLevel>*>, MaxTargets> targets{};
+
+  // The number of signal handlers running, which may still use a target being unregistered.
+  std::atomic<int> runningHandlers{0};
+
+#ifndef _WIN32
+  // Moves every registered level one step down (SIGUSR1) or up (SIGUSR2), with lock-free atomics only.
+  void onLevelSignal(int signal)
+  {
+	  // Counted before the targets are read, so that unregisterTarget() waits for this handler.
+	  runningHandlers.fetch_add(1);
+
+	  int step = signal == SIGUSR1 ? -1 : 1;
+	  for (auto& slot : targets)
+	  {
+		  std::atomic<Logify::LogLevel>* target = slot.load();
+		  if (target == nullptr) continue;
+
+		  int level = static_cast<int>(target->load(std::memory_order_relaxed)) + step;
+		  if (level < static_cast<int>(Logify::LogLevel::TRACE) || level > static_cast<int>(Logify::LogLevel::FATAL)) continue;
+		  target->store(static_cast<Logify::LogLevel>(level), std::memory_order_relaxed);
+	  }
+
+	  runningHandlers.fetch_sub(1);
+  }
+#endif
+}
+
+std::optional<Logify::LogLevel> Logify::levels::fromEnvironment()
+{
+	const char* value = std::getenv("LOGIFY_LEVEL");
+	if (value == nullptr) return std::nullopt;
+	return format::parseLevel(value);
+}
+
+void Logify::levels::installSignals()
+{
+#ifndef _WIN32
+	static std::once_flag installed;
+	std::call_once(installed, []() {
+		struct sigaction action{};
+		action.sa_handler = onLevelSignal;
+		action.sa_flags   = SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGUSR1, &action, nullptr);
+		sigaction(SIGUSR2, &action, nullptr);
+	});
+#endif
+}
+
+void Logify::levels::registerTarget(std::atomic<LogLevel>* level) noexcept
+{
+	// Take the first free slot; without one, the level does not follow the signals.
+	for (auto& slot : targets)
+	{
+		std::atomic<LogLevel>* expected = nullptr;
+		if (slot.compare_exchange_strong(expected, level)) return;
+	}
+}
+
+void Logify::levels::unregisterTarget(std::atomic<LogLevel>* level) noexcept
+{
+	for (auto& slot : targets)
+	{
+		std::atomic<LogLevel>* expected = level;
+		if (!slot.compare_exchange_strong(expected, nullptr)) continue;
+
+		// A handler that read the slot before it was cleared may still change the level; wait for it.
+		// Handlers are short and never block, and one interrupting this thread ends before it resumes.
+		while (runningHandlers.load() != 0) std::this_thread::yield();
+		return;
+	}
+}
+
+Logify::levels::LevelFileWatcher::LevelFileWatcher(std::string path, std::atomic<LogLevel>& level)
+	:
+	path_(std::move(path)),
+	level_(level),
+	notifyFd_(-1),
+	stopping_(false)
+{
+	fileName_ = std::filesystem::path(path_).filename().string();
+	start();
+}
+
+Logify::levels::LevelFileWatcher::~LevelFileWatcher()
+{
+	stopping_.store(true);
+	if (thread_.joinable()) thread_.join();
+#ifdef __linux__
+	if (notifyFd_ >= 0) ::close(notifyFd_);
+#endif
+}
+
+void Logify::levels::LevelFileWatcher::resumeAfterFork()
+{
+	// The parent's thread does not exist here, and its inotify instance stays with the parent.
+	forking::abandon(thread_);
+#ifdef __linux__
+	if (notifyFd_ >= 0) ::close(notifyFd_);
+	notifyFd_ = -1;
+#endif
+	stopping_.store(false);
+	start();
+}
+
+void Logify::levels::LevelFileWatcher::start()
+{
+#ifdef __linux__
+	// Watch the directory rather than the file, which may not exist yet or be replaced by a rename.
+	std::filesystem::path directory = std::filesystem::path(path_).parent_path();
+	if (directory.empty()) directory = ".";
+
+	notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (notifyFd_ < 0 || inotify_add_watch(notifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		if (notifyFd_ >= 0) ::close(notifyFd_);
+		notifyFd_ = -1;
+		throw std::runtime_error("Cannot watch the level file '" + path_ + "'");
+	}
+#endif
+
+	// Apply the file once the watch is set up, so that no change is missed in between.
+	apply();
+	thread_ = std::thread(&LevelFileWatcher::run, this);
+}
+
+void Logify::levels::LevelFileWatcher::run()
+{
+#ifdef __linux__
+	alignas(inotify_event) char buffer[4096];
+
+	while (!stopping_.load())
+	{
+		// Wake up regularly to notice stopping.
+		pollfd entry{notifyFd_, POLLIN, 0};
+		if (poll(&entry, 1, static_cast<int>(PollInterval.count())) <= 0) continue;
+
+		ssize_t size = ::read(notifyFd_, buffer, sizeof(buffer));
+		if (size <= 0) continue;
+
+		// Apply the file once per batch of events, if any of them is about the file.
+		bool changed = false;
+		for (ssize_t offset = 0; offset < size;)
+		{
+			const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			if (event->len > 0 && fileName_ == event->name) changed = true;
+			offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+		}
+		if (changed) apply();
+	}
+#else
+	// Without inotify, compare the modification time of the file at each interval.
+	std::error_code                 error;
+	std::filesystem::file_time_type last = std::filesystem::last_write_time(path_, error);
+
+	while (!stopping_.load())
+	{
+		std::this_thread::sleep_for(PollInterval);
+
+		std::filesystem::file_time_type time = std::filesystem::last_write_time(path_, error);
+		if (error || time == last) continue;
+		last = time;
+		apply();
+	}
+#endif
+}
+
+void Logify::levels::LevelFileWatcher::apply()
+{
+	std::ifstream file(path_);
+	if (!file) return;
+
+	std::ostringstream content;
+	content << file.rdbuf();
+
+	// The logging calls read the level with the same relaxed load.
+	std::optional<LogLevel> level = format::parseLevel(content.str());
+	if (level) level_.store(*level, std::memory_order_relaxed);
+}
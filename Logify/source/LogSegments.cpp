@@ -0,0 +1,65 @@
+#include "LogSegments.h"
+#include <charconv>
+#include <string_view>
+
+
+namespace
+{
+  // Checks that the text has the shape of a period name: "YYYY-MM-DD" or "YYYY-MM-DD_HH".
+  bool isPeriod(std::string_view text)
+  {
+	  constexpr std::string_view Daily  = "dddd-dd-dd";
+	  constexpr std::string_view Hourly = "dddd-dd-dd_dd";
+	  if (text.size() != Daily.size() && text.size() != Hourly.size()) return false;
+
+	  for (std::size_t i = 0; i < text.size(); ++i)
+	  {
+		  char expected = Hourly[i];
+		  if (expected == 'd' ? (text[i] < '0' || text[i] > '9') : text[i] != expected) return false;
+	  }
+	  return true;
+  }
+}
+
+std::vector<Logify::LogSegment> Logify::findLogSegments(const std::string& baseName, const std::string& extension)
+{
+	std::filesystem::path base(baseName);
+	std::filesystem::path directory = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+	std::string           prefix    = base.filename().string() + "_";
+	std::string           suffix    = "." + extension;
+
+	// Read the names in the directory once; a missing directory has no segments.
+	std::vector<LogSegment>                   segments;
+	std::error_code                           error;
+	std::filesystem::directory_iterator       entry(directory, error);
+	const std::filesystem::directory_iterator end;
+	for (; !error && entry != end; entry.increment(error))
+	{
+		std::string name = entry->path().filename().string();
+		if (name.size() <= prefix.size() + suffix.size()) continue;
+		if (!name.starts_with(prefix) || !name.ends_with(suffix)) continue;
+
+		// The part between the prefix and the suffix is the index, after an optional period and '_'.
+		std::string_view middle(name.data() + prefix.size(), name.size() - prefix.size() - suffix.size());
+		std::string_view period;
+		std::size_t      separator = middle.rfind('_');
+		if (separator != std::string_view::npos)
+		{
+			period = middle.substr(0, separator);
+			middle.remove_prefix(separator + 1);
+			// Other text belongs to another stream, e.g. "app_2_0000.log" is not a file of "app.log".
+			if (!isPeriod(period)) continue;
+		}
+
+		// The index must be a number.
+		const char* first  = middle.data();
+		const char* last   = middle.data() + middle.size();
+		int         index  = 0;
+		auto        result = std::from_chars(first, last, index);
+		if (result.ec != std::errc() || result.ptr != last || index < 0) continue;
+
+		segments.push_back({std::string(period), index, entry->path()});
+	}
+
+	return segments;
+}
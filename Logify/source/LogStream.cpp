@@ -0,0 +1,114 @@
+#include "Logify/LogStream.h"
+#include <algorithm>
+#include <streambuf>
+#include <string>
+
+
+namespace
+{
+  /**
+   * @brief A streambuf writing into a string that keeps its size across messages.
+   *
+   * The whole string is the put area, so formatting writes characters directly and only
+   * calls overflow() when the string has to grow.
+   */
+  class StringBuffer : public std::streambuf
+  {
+   public:
+	  StringBuffer()
+	  {
+		  reset();
+	  }
+
+	  /**
+	   * @brief Shrinks the string to the collected message and returns it.
+	   */
+	  const std::string& take()
+	  {
+		  text_.resize(static_cast<std::size_t>(pptr() - pbase()));
+		  return text_;
+	  }
+
+	  /**
+	   * @brief Empties the put area, keeping the storage of the string.
+	   */
+	  void reset()
+	  {
+		  text_.resize(std::max<std::size_t>(text_.capacity(), 128));
+		  setp(text_.data(), text_.data() + text_.size());
+	  }
+
+   protected:
+	  int_type overflow(int_type ch) override
+	  {
+		  // Double the string, keeping what has been written so far.
+		  auto used = pptr() - pbase();
+		  text_.resize(text_.size() * 2);
+		  setp(text_.data(), text_.data() + text_.size());
+		  pbump(static_cast<int>(used));
+
+		  if (!traits_type::eq_int_type(ch, traits_type::eof()))
+		  {
+			  *pptr() = traits_type::to_char_type(ch);
+			  pbump(1);
+		  }
+		  return traits_type::not_eof(ch);
+	  }
+
+   private:
+	  std::string text_;
+  };
+}
+
+struct Logify::LogStream::ThreadStream
+{
+	ThreadStream() : stream(&buffer)
+	{}
+
+	StringBuffer buffer;        ///< The buffer collecting the message.
+	std::ostream stream;        ///< The stream writing into buffer.
+	bool         busy = false;  ///< Whether a LogStream is using the stream.
+};
+
+Logify::LogStream::LogStream(Logify::Logger& logger, Logify::LogLevel level)
+	:
+	logger_(logger),
+	level_(level),
+	state_(nullptr),
+	stream_(nullptr)
+{
+	thread_local ThreadStream threadStream;
+
+	// Use the thread's stream, unless an enclosing message of this thread is still being collected.
+	if (threadStream.busy)
+	{
+		owned_ = std::make_unique<ThreadStream>();
+		state_ = owned_.get();
+	}
+	else
+	{
+		state_ = &threadStream;
+	}
+	state_->busy = true;
+	stream_      = &state_->stream;
+}
+
+Logify::LogStream::~LogStream()
+{
+	// Log the collected message.
+	logger_.log(level_, state_->buffer.take());
+
+	// Reset the buffer and any flags set by manipulators, for the next message.
+	state_->buffer.reset();
+	state_->stream.clear();
+	state_->stream.flags(std::ios_base::dec | std::ios_base::skipws);
+	state_->stream.precision(6);
+	state_->stream.width(0);
+	state_->stream.fill(' ');
+	state_->busy = false;
+}
+
+void Logify::LogStream::countFiltered(Logify::Logger& logger, Logify::LogLevel level)
+{
+	logger.countFiltered(level);
+}
@@ -1,10 +1,14 @@
 
 #include "Logify/Logger.h"
 #include "LoggerImpl.h"
+#include "OutputStream.h"
+#include "ConsoleStream.h"
+#include "FileStream.h"
+#include "SharedMemoryStream.h"
+#include "NetworkStream.h"
+#include "TickClock.h"
 
 #include <algorithm>
-#include <iostream>
-#include <sstream>
 
 
 Logify::Logger::Logger(Logify::LogLevel level) : pImpl_(std::make_unique<Impl>(level))
@@ -16,23 +20,64 @@ Logify::Logger::~Logger() = default;
 Logify::Logger& Logify::Logger::setLogLevel(Logify::LogLevel level)
 {
 	// Update the current log level in the Logger implementation.
-	pImpl_->currentLogLevel_ = level;
+	pImpl_->currentLogLevel_.store(level, std::memory_order_relaxed);
 	return *this;
 }
 
-Logify::Logger& Logify::Logger::addOutputStream(std::ostream& out)
+Logify::Logger& Logify::Logger::watchLevelFile(const std::string& path)
 {
-	// Add the provided output stream to the list of output streams in the Logger implementation.
-	pImpl_->outputStreams_.push_back(&out);
+	// Stop the previous watcher first; the new one applies the file at once.
+	pImpl_->followFork();
+	pImpl_->levelWatcher_.reset();
+	pImpl_->levelWatcher_ = std::make_unique<levels::LevelFileWatcher>(path, pImpl_->currentLogLevel_);
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::stopWatchingLevelFile()
+{
+	pImpl_->followFork();
+	pImpl_->levelWatcher_.reset();
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::enableLevelSignals()
+{
+	// Register the level once, however often this is called.
+	levels::installSignals();
+	levels::unregisterTarget(&pImpl_->currentLogLevel_);
+	levels::registerTarget(&pImpl_->currentLogLevel_);
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::disableLevelSignals()
+{
+	levels::unregisterTarget(&pImpl_->currentLogLevel_);
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::addOutputStream(std::ostream& out, LogLevel minLevel)
+{
+	// Add the provided output stream to the sinks of the Logger implementation.
+	pImpl_->addSink(std::make_unique<OutputStream>(out, minLevel));
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::addConsoleStream(ConsoleTarget target, LogLevel minLevel)
+{
+	// Create a console stream writing directly to the file descriptor of the target.
+	pImpl_->addSink(std::make_unique<ConsoleStream>(target, minLevel));
 	return *this;
 }
 
 Logify::Logger& Logify::Logger::removeOutputStream(std::ostream& out)
 {
-	// Remove the provided output stream from the list of output streams.
-	pImpl_->outputStreams_.erase(
-		std::remove(pImpl_->outputStreams_.begin(), pImpl_->outputStreams_.end(), &out),
-		pImpl_->outputStreams_.end());
+	// Remove the sinks writing to the provided output stream; waits for writes in progress.
+	std::unique_lock<ForkSafeSharedMutex> lock(pImpl_->sinksMutex_);
+	std::erase_if(pImpl_->sinks_, [&out](const std::unique_ptr<Sink>& sink) {
+		auto* stream = dynamic_cast<OutputStream*>(sink.get());
+		return stream != nullptr && stream->writesTo(out);
+	});
+	pImpl_->updateSinkLevel();
 	return *this;
 }
 
@@ -43,99 +88,291 @@ Logify::Logger& Logify::Logger::setTimeFormat(const std::string& format)
 	return *this;
 }
 
+Logify::Logger& Logify::Logger::setTimeZone(Logify::TimeZone zone)
+{
+	pImpl_->timeZone_ = zone;
+	return *this;
+}
+
 Logify::Logger& Logify::Logger::addFileStream(
 	const std::string& filename,
 	std::size_t maxFileSize,
-	const ColorScheme& scheme
+	const ColorScheme& scheme,
+	LogLevel minLevel
+)
+{
+	// Collect the settings into file stream options without retention limits.
+	FileStreamOptions options;
+	options.maxFileSize = maxFileSize;
+	options.scheme      = scheme;
+	options.minLevel    = minLevel;
+	return addFileStream(filename, options);
+}
+
+Logify::Logger& Logify::Logger::addFileStream(const std::string& filename, const FileStreamOptions& options)
+{
+	// Create a new FileStream object with the given filename and options.
+	// Add the FileStream to the sinks managed by the Logger implementation.
+	pImpl_->addSink(std::make_unique<FileStream>(filename, options));
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::addSharedMemoryStream(const std::string& name, std::size_t capacity, LogLevel minLevel)
+{
+	// Open the shared memory ring now, so a failure is reported to the caller.
+	pImpl_->addSink(std::make_unique<SharedMemoryStream>(name, capacity, minLevel));
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::addNetworkStream(const std::string& address, const NetworkStreamOptions& options)
+{
+	// The stream connects from its own thread, so an unreachable peer does not delay the caller.
+	pImpl_->addSink(std::make_unique<NetworkStream>(address, options));
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::enableAsync(std::size_t capacity, OverflowPolicy policy, LogLevel keepLevel)
+{
+	// Start the background writer with a queue of the given capacity and overflow policy.
+	pImpl_->followFork();
+	pImpl_->startWriter(capacity, policy, keepLevel);
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::disableAsync()
+{
+	// Write the queued messages and stop the background writer.
+	pImpl_->followFork();
+	pImpl_->stopWriter();
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::enableFlightRecorder(std::size_t recordsPerThread, LogLevel dumpLevel)
+{
+	// Start keeping the filtered records in new per-thread rings.
+	pImpl_->recorder_  = std::make_unique<FlightRecorder>(recordsPerThread);
+	pImpl_->dumpLevel_ = dumpLevel;
+	return *this;
+}
+
+Logify::Logger& Logify::Logger::disableFlightRecorder()
+{
+	pImpl_->recorder_.reset();
+	return *this;
+}
+
+void Logify::Logger::dumpFlightRecorder()
+{
+	pImpl_->followFork();
+	pImpl_->dumpFlightRecorder();
+}
+
+Logify::Logger& Logify::Logger::enableScopeBuffering(
+	LogLevel bufferedLevel,
+	LogLevel triggerLevel,
+	std::size_t maxRecords
 )
 {
-	// Create a new FileStream object with the given filename, max file size, and color scheme.
-	// Add the FileStream to the list of file streams managed by the Logger implementation.
-	pImpl_->fileStreams_.emplace_back(std::make_unique<FileStream>(filename, maxFileSize, scheme));
+	// Hold the low-level records of the threads' scopes from the next scope on.
+	pImpl_->bufferedLevel_  = bufferedLevel;
+	pImpl_->triggerLevel_   = triggerLevel;
+	pImpl_->scopeCapacity_  = maxRecords;
+	pImpl_->scopeBuffering_ = true;
 	return *this;
 }
 
-void Logify::Logger::log(Logify::LogLevel level, const std::string& message)
+Logify::Logger& Logify::Logger::disableScopeBuffering()
 {
-	// Check if the current log level allows this message to be logged.
-	if (!pImpl_->shouldLog(level)) return;
+	pImpl_->scopeBuffering_ = false;
+	return *this;
+}
 
-	// Get the appropriate color code for the log level.
-	const std::string& colorCode = pImpl_->getColorCode(level);
+Logify::Logger& Logify::Logger::startCollector(const std::string& name, std::size_t capacity)
+{
+	// Write the records of the shared memory ring to the sinks from a collector thread.
+	pImpl_->followFork();
+	pImpl_->startCollector(name, capacity);
+	return *this;
+}
 
-	// Get the current timestamp formatted according to the set time format.
-	const std::string& timestamp = pImpl_->getCurrentTime();
+Logify::Logger& Logify::Logger::stopCollector()
+{
+	pImpl_->followFork();
+	pImpl_->stopCollector();
+	return *this;
+}
+
+void Logify::Logger::flush()
+{
+	// Wait for the background writer to write everything queued so far, then flush the sinks' buffers.
+	pImpl_->followFork();
+	pImpl_->flushAll();
+}
+
+void Logify::Logger::installCrashHandler()
+{
+	crash::install();
+}
+
+void Logify::Logger::removeSharedMemory(const std::string& name)
+{
+	SharedRing::remove(name);
+}
+
+std::uint64_t Logify::Logger::getDroppedCount(LogLevel level) const
+{
+	return pImpl_->queueCounters_.dropped[static_cast<std::size_t>(level)].load(std::memory_order_relaxed);
+}
+
+Logify::LoggerStats Logify::Logger::stats() const
+{
+	LoggerStats stats;
+
+	// Sum the sharded message counters and read the queue counters.
+	for (std::size_t level = 0; level < stats.accepted.size(); ++level)
+	{
+		stats.accepted[level] = pImpl_->accepted_.sum(level);
+		stats.filtered[level] = pImpl_->filtered_.sum(level);
+		stats.dropped[level]  = pImpl_->queueCounters_.dropped[level].load(std::memory_order_relaxed);
+	}
+	stats.queueHighWater = pImpl_->queueCounters_.highWater.load(std::memory_order_relaxed);
+
+	// Collect the counters of each sink and their totals; the shared lock only keeps the list stable.
+	std::shared_lock<ForkSafeSharedMutex> lock(pImpl_->sinksMutex_);
+	stats.sinks.reserve(pImpl_->sinks_.size());
+	for (const auto& sink : pImpl_->sinks_)
+	{
+		const SinkStats& sinkStats = stats.sinks.emplace_back(sink->stats());
+		stats.bytesWritten += sinkStats.bytesWritten;
+		stats.flushes += sinkStats.flushes;
+		stats.writeErrors += sinkStats.writeErrors;
+		stats.rotations += sinkStats.rotations;
+	}
+
+	return stats;
+}
+
+bool Logify::Logger::isEnabled(LogLevel level) const
+{
+	// The checks of log(): the message is written, kept by the flight recorder, or held in a scope.
+	if (pImpl_->shouldLog(level) || pImpl_->recorder_) return true;
+	return pImpl_->scopeBuffering_ && level <= pImpl_->bufferedLevel_ && pImpl_->currentScope() != nullptr;
+}
+
+void Logify::Logger::countFiltered(LogLevel level)
+{
+	pImpl_->followFork();
+	pImpl_->filtered_.add(static_cast<std::size_t>(level));
+}
+
+void Logify::Logger::log(Logify::LogLevel level, const std::string& message, std::initializer_list<Field> fields)
+{
+	// In the child of a fork, the first call replaces the parent's background threads.
+	pImpl_->followFork();
+
+	// Check the Logger's level and the sinks' levels before doing any work; no lock is taken.
+	// The outcome is counted in the calling thread's shard of the counters.
+	auto levelIndex = static_cast<std::size_t>(level);
+	bool write      = pImpl_->shouldLog(level);
+
+	// Inside a ScopedLogger scope with scope buffering, a low-level message is held whatever the levels.
+	Impl::ThreadScope* scope = nullptr;
+	if (pImpl_->scopeBuffering_ && level <= pImpl_->bufferedLevel_) scope = pImpl_->currentScope();
+
+	if (write)
+	{
+		// A held message is counted when its scope writes it, as it may be discarded instead.
+		if (scope == nullptr) pImpl_->accepted_.add(levelIndex);
+	}
+	else
+	{
+		// A filtered message is only kept if the flight recorder is enabled or it is held in a scope.
+		pImpl_->filtered_.add(levelIndex);
+		if (!pImpl_->recorder_ && scope == nullptr) return;
+	}
+
+	// Read the raw clock; the wall-clock time is only derived if the record is formatted.
+	std::uint64_t ticks = TickClock::now();
 
 	// Retrieve the current process ID.
 	std::uint32_t pid = pImpl_->getPID();
 
 	// Get the current thread ID.
-	std::thread::id tid = std::this_thread::get_id();
-	std::stringstream tid_ss;
-	tid_ss << tid;
-	std::string tidStr = tid_ss.str();
-	// Ensure the string is at least 3 characters long by padding with zeros if necessary
-	if (tidStr.size() < 3) tidStr.insert(0, 3 - tidStr.size(), '0');
+	std::uint64_t tid = pImpl_->getTID();
 
+	// Collect the message and its metadata into a record; fields stay typed until a sink renders them.
+	size_t    indent = pImpl_->useIndent_ ? pImpl_->indent_.load() : 0;
+	LogRecord record{level, ticks, {}, {}, pid, tid, message, {fields.begin(), fields.size()}, indent};
 
+	// Hold the message in the thread's scope; it is formatted only if a problem is logged in the scope.
+	if (scope != nullptr)
+	{
+		scope->records.push(record);
+		return;
+	}
 
-	// Construct the log message string using the timestamp, PID, TID, log level, and message content.
-	std::ostringstream oss;
-	oss << "[" << timestamp << "][ID:" << pid << "/" << tidStr << "][" << pImpl_->levelToString(level) << "]: "
-		<< message
-		<< std::endl;
+	// Keep a filtered message in the thread's flight recorder ring; it is formatted only if dumped.
+	if (!write)
+	{
+		pImpl_->recorder_->record(record);
+		return;
+	}
 
-	// Lock the mutex to ensure thread-safe access to the output streams.
-	std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+	// A message that may report an incident is preceded by the messages kept before it.
+	if (level >= pImpl_->dumpLevel_ && pImpl_->recorder_) pImpl_->dumpFlightRecorder();
+	if (level >= pImpl_->triggerLevel_ && pImpl_->scopeBuffering_)
+	{
+		if (Impl::ThreadScope* open = pImpl_->currentScope()) pImpl_->flushScope(*open);
+	}
 
-	// Iterate over each output stream in the Logger implementation.
-	for (auto stream : pImpl_->outputStreams_)
+	// In asynchronous mode, queue a copy; the writer formats the timestamp and writes it.
+	if (pImpl_->queue_)
 	{
-		// Check if the stream is either std::cout or std::cerr (console output).
-		if (stream == &std::cout || stream == &std::cerr)
-		{
-			// If the stream is a console, prepend the color code and append the reset code after the message.
-			*stream << colorCode << oss.str() << ConsoleColors::Reset << std::flush;
-		}
-		else
-		{
-			// For non-console ostreams, simply write the message without color codes.
-			*stream << oss.str() << std::flush;
-		}
+		pImpl_->queue_->push(record);
+	}
+	else
+	{
+		// Convert the ticks and format the time according to the set time format.
+		record.time                  = TickClock::toTime(ticks);
+		const std::string& timestamp = pImpl_->formatTime(record.time);
+		record.timestamp             = timestamp;
+
+		// Write the record to every sink that accepts its level, each under its own lock.
+		pImpl_->dispatch(record);
 	}
 
-	// Write the log message to all file streams managed by the Logger implementation.
-	pImpl_->writeToFileStreams(timestamp, pid, tid, level, message);
+	// A FATAL message may be the last one before the process ends: write it and everything before it now.
+	if (level == LogLevel::FATAL) pImpl_->flushAll();
 }
 
-void Logify::Logger::trace(const std::string& message)
+void Logify::Logger::trace(const std::string& message, std::initializer_list<Field> fields)
 {
-	log(LogLevel::TRACE, message);
+	log(LogLevel::TRACE, message, fields);
 }
 
-void Logify::Logger::debug(const std::string& message)
+void Logify::Logger::debug(const std::string& message, std::initializer_list<Field> fields)
 {
-	log(LogLevel::DEBUG, message);
+	log(LogLevel::DEBUG, message, fields);
 }
 
-void Logify::Logger::info(const std::string& message)
+void Logify::Logger::info(const std::string& message, std::initializer_list<Field> fields)
 {
-	log(LogLevel::INFO, message);
+	log(LogLevel::INFO, message, fields);
 }
 
-void Logify::Logger::warn(const std::string& message)
+void Logify::Logger::warn(const std::string& message, std::initializer_list<Field> fields)
 {
-	log(LogLevel::WARN, message);
+	log(LogLevel::WARN, message, fields);
 }
 
-void Logify::Logger::error(const std::string& message)
+void Logify::Logger::error(const std::string& message, std::initializer_list<Field> fields)
 {
-	log(LogLevel::ERROR, message);
+	log(LogLevel::ERROR, message, fields);
 }
 
-void Logify::Logger::fatal(const std::string& message)
+void Logify::Logger::fatal(const std::string& message, std::initializer_list<Field> fields)
 {
-	log(LogLevel::FATAL, message);
+	log(LogLevel::FATAL, message, fields);
 }
 
 Logify::Logger& Logify::Logger::setIndentation(bool active)
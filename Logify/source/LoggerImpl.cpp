@@ -1,126 +1,528 @@
 
 #include "LoggerImpl.h"
+#include "TickClock.h"
+#include "CivilTime.h"
+#include <algorithm>
 #include <chrono>
+#include <exception>
 #include <iomanip>
 #include <sstream>
 #include <utility>
 
 
+namespace
+{
+  // The maximum number of records the background writer takes from the queue at once.
+  constexpr std::size_t WriterBatchSize = 256;
+
+  // The minimum time between two reports of dropped records, and the writer's idle wake-up period.
+  constexpr std::chrono::milliseconds DropReportInterval{1000};
+
+  // The maximum number of records the collector takes from the shared memory ring at once.
+  constexpr std::size_t CollectorBatchSize = 256;
+
+  // The collector polls the ring, backing off from the shortest to the longest interval while it is empty.
+  constexpr std::chrono::milliseconds CollectorMinPoll{1};
+  constexpr std::chrono::milliseconds CollectorMaxPoll{16};
+
+  // Identifiers of the loggers, never reused, so a thread never mistakes a new logger for a destroyed one.
+  std::atomic<std::uint64_t> nextLoggerId{1};
+}
+
 Logify::Logger::Impl::Impl(Logify::LogLevel level, std::string format)
 	:
+	id_(nextLoggerId.fetch_add(1, std::memory_order_relaxed)),
+	self_(this, [](const Impl*) {}),
 	currentLogLevel_(level),
+	sinkLevel_(LogLevel::FATAL),
 	timeFormat_(std::move(format)),
+	timeZone_(TimeZone::Local),
 	indent_(0),
-	useIndent_(false)
-{}
+	useIndent_(false),
+	batchNext_(0),
+	batchEnd_(0),
+	dumpLevel_(LogLevel::ERROR),
+	scopeBuffering_(false),
+	bufferedLevel_(LogLevel::DEBUG),
+	triggerLevel_(LogLevel::WARN),
+	scopeCapacity_(0),
+	collecting_(false),
+	collected_(0),
+	generation_(forking::generation())
+{
+	for (auto& counter : queueCounters_.dropped) counter.store(0, std::memory_order_relaxed);
+	queueCounters_.highWater.store(0, std::memory_order_relaxed);
+
+	// The level named by LOGIFY_LEVEL, if any, overrides the level given by the program.
+	if (auto configured = levels::fromEnvironment()) currentLogLevel_.store(*configured, std::memory_order_relaxed);
+
+	// Write the pending records of this logger if the crash handler is installed and the process crashes.
+	crash::registerListener(this);
+
+	// Keep logging in the child if the process forks.
+	forking::registerListener(this);
+}
+
+Logify::Logger::Impl::~Impl()
+{
+	crash::unregisterListener(this);
+	forking::unregisterListener(this);
+	levels::unregisterTarget(&currentLogLevel_);
+
+	// In the child of a fork, the threads to stop are the child's own.
+	followFork();
+
+	// Write the collected and queued records while the sinks still exist.
+	stopCollector();
+	stopWriter();
+}
 
 bool Logify::Logger::Impl::shouldLog(Logify::LogLevel level) const
 {
-	return level >= currentLogLevel_;
+	return level >= currentLogLevel_.load(std::memory_order_relaxed)
+		&& level >= sinkLevel_.load(std::memory_order_relaxed);
 }
 
-std::string Logify::Logger::Impl::levelToString(Logify::LogLevel level)
+std::string Logify::Logger::Impl::formatTime(std::chrono::system_clock::time_point now) const
 {
-	// Map each log level to its corresponding string name. TODO Customizable
-	switch (level)
+	// Split the time into seconds and milliseconds, rounding towards the past.
+	auto totalMillis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+	auto seconds     = totalMillis / 1000;
+	auto millis      = totalMillis % 1000;
+	if (millis < 0)
 	{
-		case LogLevel::TRACE:
-			return "TRACE";
-		case LogLevel::DEBUG:
-			return "DEBUG";
-		case LogLevel::INFO:
-			return "INFO ";
-		case LogLevel::WARN:
-			return "WARN ";
-		case LogLevel::ERROR:
-			return "ERROR";
-		case LogLevel::FATAL:
-			return "FATAL";
-		default:
-			return "?";
+		millis += 1000;
+		--seconds;
 	}
+
+	// Shift to local time by the cached UTC offset and break it down without the C library's time zone functions.
+	civil::LocalOffset offset{0, false, "UTC"};
+	if (timeZone_ == TimeZone::Local) offset = civil::localOffset(seconds);
+
+	std::tm localTime{};
+	civil::breakDown(seconds + offset.seconds, localTime);
+	localTime.tm_isdst = offset.daylight ? 1 : 0;
+#ifndef _WIN32
+	// Let %z and %Z print the zone without strftime consulting the time zone settings.
+	localTime.tm_gmtoff = static_cast<long>(offset.seconds);
+	localTime.tm_zone   = const_cast<char*>(offset.zone);
+#endif
+
+	// Format the time according to the provided format string.
+	std::ostringstream oss;
+	oss << std::put_time(&localTime, timeFormat_.c_str());
+
+	// Append milliseconds with precision
+	oss << '.' << std::setfill('0') << std::setw(3) << millis;
+
+	return oss.str();
 }
 
-std::string Logify::Logger::Impl::getColorCode(Logify::LogLevel level)
+void Logify::Logger::Impl::addSink(std::unique_ptr<Sink> sink)
 {
-	// Map each log level to its corresponding ANSI color code.
-	switch (level)
+	std::unique_lock<ForkSafeSharedMutex> lock(sinksMutex_);
+	sinks_.emplace_back(std::move(sink));
+	updateSinkLevel();
+}
+
+void Logify::Logger::Impl::dispatch(const LogRecord& record)
+{
+	// Logging threads share the sink list; they only serialize on the sinks they write to.
+	std::shared_lock<ForkSafeSharedMutex> lock(sinksMutex_);
+
+	for (const auto& sink : sinks_)
 	{
-		case LogLevel::TRACE:
-		case LogLevel::DEBUG:
-			return ConsoleColors::Grey;
-		case LogLevel::INFO:
-			return ConsoleColors::White;
-		case LogLevel::WARN:
-			return ConsoleColors::Yellow;
-		case LogLevel::ERROR:
-		case LogLevel::FATAL:
-			return ConsoleColors::Red;
-		default:
-			return ConsoleColors::White;
+		// Check the sink's level before taking its lock.
+		if (sink->accepts(record.level)) sink->submit(record);
 	}
 }
 
-std::string Logify::Logger::Impl::getCurrentTime() const
+void Logify::Logger::Impl::flushAll()
+{
+	// Wait for the collector and the background writer, then write what the sinks still buffer.
+	if (collectorRing_)
+	{
+		std::uint64_t published = collectorRing_->writePosition();
+		while (collecting_.load() && collected_.load(std::memory_order_acquire) < published)
+		{
+			std::this_thread::sleep_for(CollectorMinPoll);
+		}
+	}
+	if (queue_) queue_->waitUntilWritten();
+
+	std::shared_lock<ForkSafeSharedMutex> lock(sinksMutex_);
+	for (const auto& sink : sinks_) sink->flush();
+}
+
+void Logify::Logger::Impl::dumpFlightRecorder()
 {
-	// Get the current system time and convert to time_t for formatting.
-	auto now   = std::chrono::system_clock::now();
-	auto timeT = std::chrono::system_clock::to_time_t(now);
+	if (!recorder_) return;
 
-	// Structure to hold the local time result.
-	std::tm localTime;
+	// One dump at a time; the slots of the taken records are reused by the next dump.
+	std::lock_guard<std::mutex> lock(dumpMutex_);
+	recorder_->takeRecords(dumped_);
+	writePastLevels(dumped_, dumped_.size());
+}
+
+void Logify::Logger::Impl::enterScope()
+{
+	if (scopeBuffering_) ++findScope(true)->depth;
+}
+
+void Logify::Logger::Impl::leaveScope()
+{
+	if (!scopeBuffering_) return;
+
+	// The held records of a scope that ended without a problem are discarded with the outermost scope.
+	ThreadScope* scope = findScope(false);
+	if (scope != nullptr && scope->depth > 0 && --scope->depth == 0) scope->records.clear();
+}
+
+Logify::Logger::Impl::ThreadScope* Logify::Logger::Impl::currentScope()
+{
+	ThreadScope* scope = findScope(false);
+	return scope != nullptr && scope->depth > 0 ? scope : nullptr;
+}
+
+void Logify::Logger::Impl::flushScope(ThreadScope& scope)
+{
+	if (scope.records.empty()) return;
 
-#ifdef _MSC_VER
-	// Use localtime_s on MSVC for safety (This is MSVC specific).
-	errno_t err = localtime_s(&localTime, &timeT);
-	if (err != 0) {
-		throw std::runtime_error("Failed to convert time to local time.");
+	std::size_t count = 0;
+	scope.records.takeInto(scope.taken, count);
+
+	// The held records that passed the levels are counted as accepted only now that they are written.
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		LogLevel level = scope.taken[i].level();
+		if (shouldLog(level)) accepted_.add(static_cast<std::size_t>(level));
 	}
-#else
-	// Use the thread-safe version in GCC and Clang
-	std::tm* localTimePtr = std::localtime(&timeT);
-	if (localTimePtr == nullptr)
+	writePastLevels(scope.taken, count);
+}
+
+Logify::Logger::Impl::ThreadScope* Logify::Logger::Impl::findScope(bool create)
+{
+	// The scopes of the calling thread, per logger; a thread rarely uses more than one logger.
+	thread_local std::vector<std::unique_ptr<ThreadScope>> scopes;
+	for (const auto& scope : scopes)
 	{
-		throw std::runtime_error("Failed to convert time to local time.");
+		if (scope->loggerId == id_) return scope.get();
 	}
-	localTime = *localTimePtr;
-#endif
 
-	// Extract milliseconds
-	auto duration = now.time_since_epoch();
-	auto millis   = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() % 1000;
+	if (!create) return nullptr;
 
-	// Format the time according to the provided format string.
-	std::ostringstream oss;
-	oss << std::put_time(&localTime, timeFormat_.c_str());
+	// Forget the scopes of destroyed loggers, with their held records.
+	std::erase_if(scopes, [](const auto& scope) { return scope->logger.expired(); });
+	return scopes.emplace_back(std::make_unique<ThreadScope>(id_, self_, scopeCapacity_)).get();
+}
 
-	// Append milliseconds with precision
-	oss << '.' << std::setfill('0') << std::setw(3) << millis;
+void Logify::Logger::Impl::writePastLevels(const std::vector<QueuedRecord>& records, std::size_t count)
+{
+	if (count == 0) return;
 
-	return oss.str();
+	// Write the queued records first, so these records are not interleaved with older ones.
+	if (queue_) queue_->waitUntilWritten();
+
+	// Format the records only now, with their original times, and write them past the sinks' levels.
+	std::vector<Field>                    fields;
+	std::shared_lock<ForkSafeSharedMutex> sinksLock(sinksMutex_);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto        time      = records[i].time();
+		std::string timestamp = formatTime(time);
+		LogRecord   record    = records[i].view(time, timestamp, fields);
+		for (const auto& sink : sinks_) sink->submit(record);
+	}
 }
 
-void Logify::Logger::Impl::writeToFileStreams(
-	const std::string& timestamp,
-	std::uint32_t pid,
-	std::thread::id tid,
-	Logify::LogLevel level,
-	const std::string& message
-)
+void Logify::Logger::Impl::writeAfterCrash() noexcept
 {
-	// Convert the thread ID to a string.
-	std::ostringstream oss;
-	oss << tid;
-	std::string tidStr = oss.str();
+	// Buffered entries are older than any queued record, so they are written first.
+	for (const auto& sink : sinks_) sink->flushAfterCrash();
+
+	if (!queue_) return;
+
+	auto writeRecord = [this](const QueuedRecord& record) {
+		for (const auto& sink : sinks_)
+		{
+			if (sink->accepts(record.level())) sink->writeAfterCrash(record);
+		}
+	};
+
+	// Write the rest of the writer's current batch, then the records still in the queue.
+	std::size_t end = batchEnd_.load();
+	for (std::size_t i = batchNext_.load(); i < end && i < batch_.size(); ++i) writeRecord(batch_[i]);
+	queue_->visitUnlocked(writeRecord);
+}
 
-	size_t indent = useIndent_ ? indent_ : 0;
+void Logify::Logger::Impl::prepareFork() noexcept
+{
+	// No thread replaces the background threads meanwhile.
+	resumeMutex_.lock();
+
+	// In the order of dumpFlightRecorder(): the dump lock, the rings, then the sinks.
+	dumpMutex_.lock();
+	if (recorder_) recorder_->lockForFork();
+
+	// Wait for the writer, the collector and the logging threads to leave the sinks, then keep them out.
+	sinksMutex_.lock();
+	for (const auto& sink : sinks_) sink->lockForFork();
+}
 
-	// Iterate over each file stream and write the log message to it.
-	for (const auto& fileStream : fileStreams_)
+void Logify::Logger::Impl::parentAfterFork() noexcept
+{
+	for (auto it = sinks_.rbegin(); it != sinks_.rend(); ++it) (*it)->unlockInParent();
+	sinksMutex_.unlock();
+
+	if (recorder_) recorder_->unlockInParent();
+	dumpMutex_.unlock();
+	resumeMutex_.unlock();
+}
+
+void Logify::Logger::Impl::childAfterFork() noexcept
+{
+	// The sinks leave the parent's files and connections to the parent before any record reaches them.
+	for (auto it = sinks_.rbegin(); it != sinks_.rend(); ++it) (*it)->unlockInChild();
+	sinksMutex_.unlock();
+
+	if (recorder_) recorder_->unlockInChild();
+	dumpMutex_.unlock();
+	resumeMutex_.unlock();
+}
+
+void Logify::Logger::Impl::resumeAfterFork()
+{
+	// The first thread using the logger in the child replaces the threads; the others wait for it.
+	std::lock_guard<std::mutex> lock(resumeMutex_);
+	std::uint64_t               generation = forking::generation();
+	if (generation_.load(std::memory_order_relaxed) == generation) return;
+
+	// The parent keeps collecting the ring; the child leaves the ring and its thread alone.
+	if (collectorRing_)
 	{
-		fileStream->write(timestamp, std::to_string(pid), tidStr, levelToString(level), message, indent);
+		forking::abandon(collector_);
+		forking::abandon(collectorRing_);
+		collecting_.store(false);
 	}
+
+	// Watch the level file with a thread of the child; if that fails, the level stays as it is.
+	if (levelWatcher_)
+	{
+		try
+		{
+			levelWatcher_->resumeAfterFork();
+		}
+		catch (const std::exception&)
+		{}
+	}
+
+	if (queue_)
+	{
+		// The queue and the batch hold records of the parent, which the parent writes, and locks
+		// its threads may have held; they are given up with the writer thread.
+		std::size_t    capacity  = queue_->capacity();
+		OverflowPolicy policy    = queue_->policy();
+		LogLevel       keepLevel = queue_->keepLevel();
+
+		forking::abandon(writer_);
+		forking::abandon(queue_);
+		forking::abandon(batch_);
+		batch_.clear();
+		batchNext_.store(0);
+		batchEnd_.store(0);
+
+		// The parent reports its own drops.
+		for (auto& counter : queueCounters_.dropped) counter.store(0, std::memory_order_relaxed);
+
+		startWriter(capacity, policy, keepLevel);
+	}
+
+	generation_.store(generation, std::memory_order_release);
 }
+
+void Logify::Logger::Impl::updateSinkLevel()
+{
+	// Without sinks nothing is written; FATAL keeps the check cheap for all lower levels.
+	LogLevel lowest = LogLevel::FATAL;
+	for (const auto& sink : sinks_)
+	{
+		if (sink->minLevel() < lowest) lowest = sink->minLevel();
+	}
+	sinkLevel_.store(lowest, std::memory_order_relaxed);
+}
+
+void Logify::Logger::Impl::startWriter(std::size_t capacity, OverflowPolicy policy, LogLevel keepLevel)
+{
+	stopWriter();
+
+	queue_  = std::make_unique<RecordQueue>(capacity, policy, keepLevel, queueCounters_);
+	writer_ = std::thread(&Impl::writerLoop, this, std::ref(*queue_));
+}
+
+void Logify::Logger::Impl::stopWriter()
+{
+	if (!queue_) return;
+
+	// The writer exits once the closed queue is empty.
+	queue_->close();
+	if (writer_.joinable()) writer_.join();
+	queue_.reset();
+}
+
+void Logify::Logger::Impl::writerLoop(RecordQueue& queue)
+{
+	std::vector<Field> fields;
+	std::uint64_t      reported       = 0;
+	auto               lastReportTime = std::chrono::steady_clock::now();
+
+	while (true)
+	{
+		batchEnd_.store(0);
+		std::size_t count = queue.pop(batch_, WriterBatchSize, DropReportInterval);
+		batchNext_.store(0);
+		batchEnd_.store(count);
+
+		// Format the timestamps here, off the logging threads, then write each record.
+		// The crash handler writes the records from batchNext_ on if the process crashes meanwhile.
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto        time      = batch_[i].time();
+			std::string timestamp = formatTime(time);
+			dispatch(batch_[i].view(time, timestamp, fields));
+			batchNext_.store(i + 1);
+		}
+		queue.markWritten(count);
+
+		bool done = count == 0 && queue.isDrained();
+
+		// Report drops at most once per interval, and once more before exiting.
+		auto now = std::chrono::steady_clock::now();
+		if (done || now - lastReportTime >= DropReportInterval)
+		{
+			reportDrops(reported);
+			lastReportTime = now;
+		}
+
+		if (done) break;
+	}
+}
+
+void Logify::Logger::Impl::reportDrops(std::uint64_t& reported)
+{
+	std::array<std::uint64_t, 6> counts{};
+	std::uint64_t                total = 0;
+	for (std::size_t i = 0; i < counts.size(); ++i)
+	{
+		counts[i] = queueCounters_.dropped[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+
+	if (total == reported) return;
+
+	// Log the number of drops since the last report, with the per-level totals as fields.
+	std::uint64_t      sinceLastReport = total - reported;
+	std::vector<Field> fields{
+		{"dropped", sinceLastReport},
+		{"trace", counts[0]},
+		{"debug", counts[1]},
+		{"info", counts[2]},
+		{"warn", counts[3]},
+		{"error", counts[4]},
+		{"fatal", counts[5]}
+	};
+	std::string message = "Dropped " + std::to_string(sinceLastReport) + " log records because the queue was full";
+
+	std::uint64_t ticks     = TickClock::now();
+	auto          time      = TickClock::toTime(ticks);
+	std::string   timestamp = formatTime(time);
+	dispatch({LogLevel::WARN, ticks, time, timestamp, getPID(), getTID(), message, fields, 0});
+
+	reported = total;
+}
+
+void Logify::Logger::Impl::startCollector(const std::string& name, std::size_t capacity)
+{
+	stopCollector();
+
+	collectorRing_ = std::make_unique<SharedRing>(name, capacity);
+	collected_.store(collectorRing_->readPosition());
+	collecting_.store(true);
+	collector_ = std::thread(&Impl::collectorLoop, this, std::ref(*collectorRing_));
+}
+
+void Logify::Logger::Impl::stopCollector()
+{
+	if (!collectorRing_) return;
+
+	// The collector exits once it finds the ring empty after being stopped.
+	collecting_.store(false);
+	if (collector_.joinable()) collector_.join();
+	collectorRing_.reset();
+}
+
+void Logify::Logger::Impl::collectorLoop(SharedRing& ring)
+{
+	std::uint64_t reported       = 0;
+	auto          lastReportTime = std::chrono::steady_clock::now();
+	auto          poll           = CollectorMinPoll;
+
+	while (true)
+	{
+		bool stopping = !collecting_.load();
+
+		// The records keep the time, process and thread of their producer; only the timestamp is formatted here.
+		std::size_t count = ring.collect(
+			[this](const LogRecord& collected) {
+				if (collected.level < currentLogLevel_.load(std::memory_order_relaxed)) return;
+				std::string timestamp = formatTime(collected.time);
+				LogRecord   record    = collected;
+				record.timestamp      = timestamp;
+				dispatch(record);
+			},
+			CollectorBatchSize
+		);
+		collected_.store(ring.readPosition(), std::memory_order_release);
+
+		// Report drops at most once per interval, and once more before exiting.
+		bool done = count == 0 && stopping;
+		auto now  = std::chrono::steady_clock::now();
+		if (done || now - lastReportTime >= DropReportInterval)
+		{
+			reportRingDrops(ring, reported);
+			lastReportTime = now;
+		}
+
+		if (done) break;
+
+		// Poll again at once while there are records, then less and less often.
+		if (count > 0)
+		{
+			poll = CollectorMinPoll;
+			continue;
+		}
+		std::this_thread::sleep_for(poll);
+		poll = std::min(poll * 2, CollectorMaxPoll);
+	}
+}
+
+void Logify::Logger::Impl::reportRingDrops(const SharedRing& ring, std::uint64_t& reported)
+{
+	std::uint64_t total = ring.dropped();
+	if (total == reported) return;
+
+	std::uint64_t      sinceLastReport = total - reported;
+	std::vector<Field> fields{{"dropped", sinceLastReport}, {"ring", ring.name()}};
+	std::string        message =
+		"Dropped " + std::to_string(sinceLastReport) + " log records because the shared memory ring was full";
+
+	std::uint64_t ticks     = TickClock::now();
+	auto          time      = TickClock::toTime(ticks);
+	std::string   timestamp = formatTime(time);
+	dispatch({LogLevel::WARN, ticks, time, timestamp, getPID(), getTID(), message, fields, 0});
+
+	reported = total;
+}
+
 void Logify::Logger::Impl::indent()
 {
 	indent_++;
@@ -128,6 +530,7 @@ void Logify::Logger::Impl::indent()
 
 void Logify::Logger::Impl::deindent()
 {
-	if (indent_ == 0) return;
-	indent_--;
+	// Decrement without going below zero, even if scopes on other threads change the value concurrently.
+	size_t current = indent_.load();
+	while (current > 0 && !indent_.compare_exchange_weak(current, current - 1)) {}
 }
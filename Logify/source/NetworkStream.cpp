@@ -0,0 +1,557 @@
+#include "NetworkStream.h"
+#include "Formatting.h"
+#include "ForkHandler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+
+#ifdef _WIN32
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+  // The most buffers handed to the socket with one call.
+  constexpr std::size_t MaxBatchBuffers = 64;
+
+  // How long a connection attempt, flush() and the final sending on destruction may take.
+  constexpr std::chrono::milliseconds ConnectTimeout{1000};
+  constexpr std::chrono::milliseconds FlushTimeout{1000};
+  constexpr std::chrono::milliseconds ShutdownTimeout{1000};
+
+  // How often a sender waiting for the socket to become writable checks whether the stream stops.
+  constexpr int PollMilliseconds = 100;
+
+  // The sent or discarded chunks kept for reuse.
+  constexpr std::size_t MaxSpareChunks = 16;
+
+#ifdef _WIN32
+  using SocketHandle = SOCKET;
+  const SocketHandle InvalidSocket = INVALID_SOCKET;
+
+  void closeSocket(SocketHandle socket)
+  {
+	  closesocket(socket);
+  }
+
+  bool wouldBlock()
+  {
+	  int error = WSAGetLastError();
+	  return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS || error == WSAEINTR;
+  }
+
+  bool setNonBlocking(SocketHandle socket)
+  {
+	  u_long enabled = 1;
+	  return ioctlsocket(socket, FIONBIO, &enabled) == 0;
+  }
+
+  int pollSocket(SocketHandle socket, int milliseconds)
+  {
+	  WSAPOLLFD entry{socket, POLLWRNORM, 0};
+	  return WSAPoll(&entry, 1, milliseconds);
+  }
+#else
+  using SocketHandle = int;
+  constexpr SocketHandle InvalidSocket = -1;
+
+  void closeSocket(SocketHandle socket)
+  {
+	  close(socket);
+  }
+
+  bool wouldBlock()
+  {
+	  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS || errno == EINTR;
+  }
+
+  bool setNonBlocking(SocketHandle socket)
+  {
+	  int flags = fcntl(socket, F_GETFL);
+	  return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+  }
+
+  int pollSocket(SocketHandle socket, int milliseconds)
+  {
+	  pollfd entry{socket, POLLOUT, 0};
+	  return poll(&entry, 1, milliseconds);
+  }
+#endif
+
+  /**
+   * @brief Connects a new non-blocking socket, waiting at most ConnectTimeout.
+   * @return The connected socket, or InvalidSocket.
+   */
+  SocketHandle connectSocket(int family, int protocol, const sockaddr* address, socklen_t size)
+  {
+	  SocketHandle socket = ::socket(family, SOCK_STREAM, protocol);
+	  if (socket == InvalidSocket) return InvalidSocket;
+
+#ifdef SO_NOSIGPIPE
+	  // A peer that went away must not kill the process with SIGPIPE.
+	  int enabled = 1;
+	  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+
+	  bool connected = setNonBlocking(socket) && connect(socket, address, size) == 0;
+	  if (!connected && wouldBlock() && pollSocket(socket, static_cast<int>(ConnectTimeout.count())) > 0)
+	  {
+		  int       error     = 0;
+		  socklen_t errorSize = sizeof(error);
+		  connected = getsockopt(socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &errorSize) == 0
+			  && error == 0;
+	  }
+
+	  if (!connected)
+	  {
+		  closeSocket(socket);
+		  return InvalidSocket;
+	  }
+	  return socket;
+  }
+
+  SocketHandle connectUnix(const std::string& path)
+  {
+	  sockaddr_un address{};
+	  if (path.size() >= sizeof(address.sun_path)) return InvalidSocket;
+	  address.sun_family = AF_UNIX;
+	  std::memcpy(address.sun_path, path.data(), path.size());
+	  return connectSocket(AF_UNIX, 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  }
+
+  SocketHandle connectTcp(const std::string& host, const std::string& port)
+  {
+	  addrinfo  hints{};
+	  addrinfo* results = nullptr;
+	  hints.ai_family   = AF_UNSPEC;
+	  hints.ai_socktype = SOCK_STREAM;
+	  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0) return InvalidSocket;
+
+	  // Try the addresses of the host in turn.
+	  SocketHandle socket = InvalidSocket;
+	  for (addrinfo* result = results; result != nullptr && socket == InvalidSocket; result = result->ai_next)
+	  {
+		  socket = connectSocket(
+			  result->ai_family, result->ai_protocol, result->ai_addr, static_cast<socklen_t>(result->ai_addrlen)
+		  );
+	  }
+	  freeaddrinfo(results);
+
+	  // The records are batched already; do not hold them back any further.
+	  if (socket != InvalidSocket)
+	  {
+		  int enabled = 1;
+		  setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+	  }
+	  return socket;
+  }
+
+  /**
+   * @brief Sends buffers with a single system call.
+   * @return The number of bytes sent, 0 if the socket would block, or -1 if the connection failed.
+   */
+  std::int64_t sendBuffers(SocketHandle socket, const std::vector<std::pair<const char*, std::size_t>>& buffers)
+  {
+#ifdef _WIN32
+	  WSABUF wsaBuffers[MaxBatchBuffers];
+	  DWORD  count = 0;
+	  for (const auto& [data, size] : buffers)
+	  {
+		  wsaBuffers[count].buf = const_cast<char*>(data);
+		  wsaBuffers[count].len = static_cast<ULONG>(size);
+		  ++count;
+	  }
+
+	  DWORD sent = 0;
+	  if (WSASend(socket, wsaBuffers, count, &sent, 0, nullptr, nullptr) == SOCKET_ERROR) return wouldBlock() ? 0 : -1;
+	  return static_cast<std::int64_t>(sent);
+#else
+	  iovec vectors[MaxBatchBuffers];
+	  std::size_t count = 0;
+	  for (const auto& [data, size] : buffers)
+	  {
+		  vectors[count].iov_base = const_cast<char*>(data);
+		  vectors[count].iov_len  = size;
+		  ++count;
+	  }
+
+	  msghdr message{};
+	  message.msg_iov    = vectors;
+	  message.msg_iovlen = count;
+#ifdef MSG_NOSIGNAL
+	  int flags = MSG_NOSIGNAL;
+#else
+	  int flags = 0;
+#endif
+	  ssize_t sent = sendmsg(socket, &message, flags);
+	  if (sent < 0) return wouldBlock() ? 0 : -1;
+	  return static_cast<std::int64_t>(sent);
+#endif
+  }
+
+#ifdef _WIN32
+  // Initializes Winsock once for the process.
+  void startNetworking()
+  {
+	  static const bool started = [] {
+		  WSADATA data;
+		  return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	  }();
+	  (void)started;
+  }
+#endif
+}
+
+Logify::NetworkStream::NetworkStream(const std::string& address, const NetworkStreamOptions& options)
+	:
+	Sink(options.minLevel),
+	address_(address),
+	isUnix_(false),
+	options_(options),
+	pendingBytes_(0),
+	appendedBytes_(0),
+	releasedBytes_(0),
+	reachable_(true),
+	senderIdle_(false),
+	stopping_(false),
+	connection_(-1)
+{
+	// Split the address into the socket path, or the host and port.
+	if (address.starts_with("unix:") && address.size() > 5)
+	{
+		isUnix_ = true;
+		host_   = address.substr(5);
+	}
+	else if (address.starts_with("tcp:"))
+	{
+		std::size_t colon = address.rfind(':');
+		if (colon > 4 && colon + 1 < address.size())
+		{
+			host_ = address.substr(4, colon - 4);
+			port_ = address.substr(colon + 1);
+
+			// IPv6 addresses are written in brackets, e.g. "tcp:[::1]:5140".
+			if (host_.size() > 2 && host_.front() == '[' && host_.back() == ']') host_ = host_.substr(1, host_.size() - 2);
+		}
+	}
+	if (host_.empty())
+	{
+		throw std::invalid_argument(
+			"Invalid network address '" + address + "'; expected unix:<path> or tcp:<host>:<port>"
+		);
+	}
+
+#ifdef _WIN32
+	startNetworking();
+#endif
+
+	startSender();
+}
+
+Logify::NetworkStream::~NetworkStream()
+{
+	// A forked child that never wrote has no sender to stop.
+	if (!sender_.joinable()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(pendingMutex_);
+		stopping_ = true;
+	}
+	wakeUp_->notify_all();
+	sender_.join();
+}
+
+std::string Logify::NetworkStream::name() const
+{
+	return address_;
+}
+
+void Logify::NetworkStream::write(const LogRecord& record)
+{
+	// In the child of a fork, the first record starts the child's sender.
+	if (!sender_.joinable()) startSender();
+
+	// Format the record before taking the lock shared with the sender.
+	buffer_.clear();
+	if (options_.format == NetworkFormat::JsonLines) format::appendJsonLine(buffer_, record);
+	else format::appendTextLine(buffer_, record);
+
+	bool wakeSender = false;
+	{
+		std::lock_guard<std::mutex> lock(pendingMutex_);
+
+		// Keep the backlog bounded while the peer is unreachable or slow.
+		if (pendingBytes_ + buffer_.size() > options_.maxPendingBytes)
+		{
+			countWriteError();
+			return;
+		}
+
+		// Append to the last chunk, or start one, reusing the memory of a sent one.
+		if (chunks_.empty() || chunks_.back().data.size() + buffer_.size() > ChunkSize)
+		{
+			if (!spare_.empty())
+			{
+				chunks_.push_back(std::move(spare_.back()));
+				spare_.pop_back();
+			}
+			else
+			{
+				chunks_.push_back({std::string(), 0});
+				chunks_.back().data.reserve(ChunkSize);
+			}
+		}
+		chunks_.back().data += buffer_;
+		++chunks_.back().records;
+		pendingBytes_ += buffer_.size();
+		appendedBytes_ += buffer_.size();
+		wakeSender = senderIdle_;
+	}
+
+	// A busy sender takes the new chunks with its next batch.
+	if (wakeSender) wakeUp_->notify_one();
+}
+
+void Logify::NetworkStream::sync()
+{
+	// A forked child without a sender has appended nothing since the fork.
+	if (!sender_.joinable()) return;
+
+	// Wait for the bytes appended so far, but not for a peer that cannot be reached.
+	std::unique_lock<std::mutex> lock(pendingMutex_);
+	std::uint64_t                target = appendedBytes_;
+	progress_->wait_for(lock, FlushTimeout, [this, target] {
+		return releasedBytes_ >= target || !reachable_ || stopping_;
+	});
+}
+
+void Logify::NetworkStream::startSender()
+{
+	wakeUp_   = std::make_unique<std::condition_variable>();
+	progress_ = std::make_unique<std::condition_variable>();
+	sender_   = std::thread(&NetworkStream::senderLoop, this);
+}
+
+void Logify::NetworkStream::senderLoop()
+{
+	SocketHandle                                     socket = InvalidSocket;
+	std::deque<Chunk>                                sending;     // The chunks taken, oldest first.
+	std::size_t                                      offset = 0;  // The bytes of the first chunk already sent.
+	std::vector<std::pair<const char*, std::size_t>> buffers;
+	std::vector<Chunk>                               finished;
+	auto                                             delay = options_.minReconnectDelay;
+	std::optional<std::chrono::steady_clock::time_point> deadline;
+
+	while (true)
+	{
+		// Take the pending chunks, waiting for some if everything was sent.
+		{
+			std::unique_lock<std::mutex> lock(pendingMutex_);
+			if (sending.empty())
+			{
+				senderIdle_ = true;
+				wakeUp_->wait(lock, [this] { return stopping_ || !chunks_.empty(); });
+				senderIdle_ = false;
+			}
+			while (!chunks_.empty())
+			{
+				sending.push_back(std::move(chunks_.front()));
+				chunks_.pop_front();
+			}
+			if (stopping_ && !deadline) deadline = std::chrono::steady_clock::now() + ShutdownTimeout;
+		}
+		if (sending.empty()) break;
+
+		// Give up on what is left once the stream has been stopping for too long.
+		if (deadline && std::chrono::steady_clock::now() > *deadline)
+		{
+			discard(sending, offset);
+			break;
+		}
+
+		if (socket == InvalidSocket)
+		{
+			socket = isUnix_ ? connectUnix(host_) : connectTcp(host_, port_);
+			{
+				std::lock_guard<std::mutex> lock(pendingMutex_);
+				reachable_  = socket != InvalidSocket;
+				connection_ = reachable_ ? static_cast<std::int64_t>(socket) : -1;
+			}
+			progress_->notify_all();
+
+			if (socket == InvalidSocket)
+			{
+				// On shutdown there is no second attempt.
+				if (deadline)
+				{
+					discard(sending, offset);
+					break;
+				}
+
+				// Retry after the delay, doubling it for the next failure; records keep being appended meanwhile.
+				std::unique_lock<std::mutex> lock(pendingMutex_);
+				wakeUp_->wait_for(lock, delay, [this] { return stopping_; });
+				delay = std::min(delay * 2, options_.maxReconnectDelay);
+				continue;
+			}
+			delay = options_.minReconnectDelay;
+
+			// The rest of a record cut off by the lost connection would be garbage to the new one.
+			if (offset > 0)
+			{
+				const std::string& data    = sending.front().data;
+				std::size_t        lineEnd = data.find('\n', offset);
+				std::size_t        skipped = (lineEnd == std::string::npos ? data.size() : lineEnd + 1) - offset;
+				offset += skipped;
+				if (offset == data.size())
+				{
+					finished.push_back(std::move(sending.front()));
+					sending.pop_front();
+					offset = 0;
+				}
+				countWriteError();
+				release(skipped, finished);
+				if (sending.empty()) continue;
+			}
+		}
+
+		// Hand as many chunks as possible to the socket with one call.
+		if (pollSocket(socket, PollMilliseconds) == 0) continue;
+
+		buffers.clear();
+		for (std::size_t i = 0; i < sending.size() && buffers.size() < MaxBatchBuffers; ++i)
+		{
+			std::size_t skip = i == 0 ? offset : 0;
+			buffers.emplace_back(sending[i].data.data() + skip, sending[i].data.size() - skip);
+		}
+
+		std::int64_t sent = sendBuffers(socket, buffers);
+		if (sent < 0)
+		{
+			// The connection is lost; reconnect with the unsent data.
+			forgetConnection();
+			closeSocket(socket);
+			socket = InvalidSocket;
+			continue;
+		}
+		if (sent == 0) continue;
+
+		countBytes(static_cast<std::uint64_t>(sent));
+		countFlush();
+
+		// Move past the sent bytes, recycling the chunks that were sent completely.
+		auto left = static_cast<std::size_t>(sent);
+		while (left > 0)
+		{
+			std::size_t available = sending.front().data.size() - offset;
+			if (left < available)
+			{
+				offset += left;
+				break;
+			}
+			left -= available;
+			offset = 0;
+			finished.push_back(std::move(sending.front()));
+			sending.pop_front();
+		}
+		release(static_cast<std::size_t>(sent), finished);
+	}
+
+	if (socket != InvalidSocket)
+	{
+		forgetConnection();
+		closeSocket(socket);
+	}
+}
+
+void Logify::NetworkStream::forgetConnection()
+{
+	// Before closing, so that a child forked meanwhile never closes a descriptor reused for something else.
+	std::lock_guard<std::mutex> lock(pendingMutex_);
+	connection_ = -1;
+}
+
+void Logify::NetworkStream::prepareFork()
+{
+	// Nothing is sent on the child's behalf: what is pending at the fork is sent by the parent.
+	pendingMutex_.lock();
+}
+
+void Logify::NetworkStream::parentAfterFork()
+{
+	pendingMutex_.unlock();
+}
+
+void Logify::NetworkStream::childAfterFork()
+{
+	// The sender does not exist in the child, and its waits may still be counted in the condition
+	// variables; they are given up. Its connection belongs to the parent.
+	forking::abandon(sender_);
+	forking::abandon(wakeUp_);
+	forking::abandon(progress_);
+	if (connection_ >= 0) closeSocket(static_cast<SocketHandle>(connection_));
+	connection_ = -1;
+
+	// Leave the backlog to the parent and start with an empty one.
+	chunks_.clear();
+	pendingBytes_  = 0;
+	releasedBytes_ = appendedBytes_;
+	reachable_     = true;
+	senderIdle_    = false;
+	pendingMutex_.unlock();
+}
+
+void Logify::NetworkStream::release(std::size_t bytes, std::vector<Chunk>& finished)
+{
+	{
+		std::lock_guard<std::mutex> lock(pendingMutex_);
+		pendingBytes_ -= bytes;
+		releasedBytes_ += bytes;
+		for (auto& chunk : finished)
+		{
+			if (spare_.size() >= MaxSpareChunks) break;
+			chunk.data.clear();
+			chunk.records = 0;
+			spare_.push_back(std::move(chunk));
+		}
+	}
+	finished.clear();
+	progress_->notify_all();
+}
+
+void Logify::NetworkStream::discard(std::deque<Chunk>& sending, std::size_t offset)
+{
+	std::size_t bytes = 0;
+	for (const auto& chunk : sending)
+	{
+		// The records of the first chunk that were not sent yet are the lines after the offset.
+		std::size_t records = &chunk == &sending.front() && offset > 0
+			? static_cast<std::size_t>(std::count(chunk.data.begin() + static_cast<std::ptrdiff_t>(offset), chunk.data.end(), '\n'))
+			: chunk.records;
+		for (std::size_t i = 0; i < records; ++i) countWriteError();
+		bytes += chunk.data.size();
+	}
+
+	std::vector<Chunk> finished;
+	release(bytes - offset, finished);
+	sending.clear();
+}
@@ -0,0 +1,52 @@
+#include "OutputStream.h"
+#include "ConsoleStream.h"
+#include "Formatting.h"
+#include <iostream>
+
+
+Logify::OutputStream::OutputStream(std::ostream& out, LogLevel minLevel)
+	: Sink(minLevel), stream_(&out), isConsole_(&out == &std::cout || &out == &std::cerr)
+{}
+
+bool Logify::OutputStream::writesTo(const std::ostream& out) const
+{
+	return stream_ == &out;
+}
+
+std::string Logify::OutputStream::name() const
+{
+	if (stream_ == &std::cout) return "cout";
+	if (stream_ == &std::cerr) return "cerr";
+	return "ostream";
+}
+
+void Logify::OutputStream::write(const LogRecord& record)
+{
+	// Construct the log line using the timestamp, PID, TID, log level, message content and fields.
+	buffer_.clear();
+	format::appendTextLine(buffer_, record);
+
+	// Check if the stream is either std::cout or std::cerr (console output).
+	std::size_t bytes = buffer_.size();
+	if (isConsole_)
+	{
+		// If the stream is a console, prepend the color code and append the reset code after the message.
+		const std::string_view color = ConsoleColors::forLevel(record.level);
+		*stream_ << color << buffer_ << ConsoleColors::Reset << std::flush;
+		bytes += color.size() + std::string_view(ConsoleColors::Reset).size();
+	}
+	else
+	{
+		// For non-console ostreams, simply write the message without color codes.
+		*stream_ << buffer_ << std::flush;
+	}
+
+	// A failed stream stays failed until the user clears it; every message written to it counts as an error.
+	if (stream_->fail())
+	{
+		countWriteError();
+		return;
+	}
+	countBytes(bytes);
+	countFlush();
+}
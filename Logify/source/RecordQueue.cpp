@@ -0,0 +1,277 @@
+#include "RecordQueue.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+
+Logify::QueuedRecord::QueuedRecord(QueuedRecord&& other) noexcept
+{
+	take(other);
+}
+
+Logify::QueuedRecord& Logify::QueuedRecord::operator=(QueuedRecord&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		take(other);
+	}
+	return *this;
+}
+
+Logify::QueuedRecord::~QueuedRecord()
+{
+	release();
+}
+
+void Logify::QueuedRecord::assign(const LogRecord& record, SpillArena& arena)
+{
+	release();
+
+	level_  = record.level;
+	ticks_  = record.ticks;
+	pid_    = record.pid;
+	tid_    = record.tid;
+	indent_ = record.indent;
+
+	// Measure the data: the stored fields, then the message and the keys and string values of the fields.
+	std::size_t fieldCount = std::min<std::size_t>(record.fields.size(), UINT16_MAX);
+	std::size_t fieldsSize = fieldCount * sizeof(StoredField);
+	std::size_t size       = fieldsSize + record.message.size();
+	for (std::size_t i = 0; i < fieldCount; ++i)
+	{
+		const Field& field = record.fields[i];
+		size += field.key().size();
+		if (field.type() == Field::Type::String) size += field.asString().size();
+	}
+
+	// Use the slot's own storage if the data fits, otherwise spill it into the arena.
+	char* data = inline_;
+	if (size > InlineSize) data = spilled_ = arena.allocate(size, chunk_);
+
+	fieldCount_  = static_cast<std::uint16_t>(fieldCount);
+	size_        = static_cast<std::uint32_t>(size);
+	messageSize_ = static_cast<std::uint32_t>(record.message.size());
+
+	// Copy the message, then the keys and string values of the fields, after the stored fields.
+	char* text = data + fieldsSize;
+	std::memcpy(text, record.message.data(), record.message.size());
+	std::uint32_t textSize = messageSize_;
+
+	auto append = [text, &textSize](std::string_view value) {
+		std::memcpy(text + textSize, value.data(), value.size());
+		textSize += static_cast<std::uint32_t>(value.size());
+	};
+
+	for (std::size_t i = 0; i < fieldCount; ++i)
+	{
+		const Field& field = record.fields[i];
+		StoredField  stored{};
+		stored.type      = field.type();
+		stored.keyOffset = textSize;
+		stored.keySize   = static_cast<std::uint32_t>(field.key().size());
+		append(field.key());
+
+		switch (field.type())
+		{
+			case Field::Type::Int:
+				stored.intValue = field.asInt();
+				break;
+			case Field::Type::UInt:
+				stored.uintValue = field.asUInt();
+				break;
+			case Field::Type::Double:
+				stored.doubleValue = field.asDouble();
+				break;
+			case Field::Type::Bool:
+				stored.boolValue = field.asBool();
+				break;
+			case Field::Type::String:
+				stored.valueOffset = textSize;
+				stored.valueSize   = static_cast<std::uint32_t>(field.asString().size());
+				append(field.asString());
+				break;
+		}
+		std::memcpy(data + i * sizeof(StoredField), &stored, sizeof(StoredField));
+	}
+}
+
+Logify::LogRecord Logify::QueuedRecord::view(
+	std::chrono::system_clock::time_point time,
+	std::string_view timestamp,
+	std::vector<Field>& fields
+) const
+{
+	// Rebuild the fields with views into the buffer of this slot.
+	fields.clear();
+	forEachField([&fields](const Field& field) { fields.push_back(field); });
+
+	return {level_, ticks_, time, timestamp, pid_, tid_, message(), fields, indent_};
+}
+
+void Logify::QueuedRecord::take(QueuedRecord& other) noexcept
+{
+	level_       = other.level_;
+	fieldCount_  = other.fieldCount_;
+	pid_         = other.pid_;
+	messageSize_ = other.messageSize_;
+	size_        = other.size_;
+	ticks_       = other.ticks_;
+	tid_         = other.tid_;
+	indent_      = other.indent_;
+
+	// Spilled data changes hands; inline data is copied, only as far as it is used.
+	if (other.spilled_)
+	{
+		spilled_ = std::exchange(other.spilled_, nullptr);
+		chunk_   = std::exchange(other.chunk_, nullptr);
+	}
+	else
+	{
+		std::memcpy(inline_, other.inline_, size_);
+	}
+
+	other.fieldCount_  = 0;
+	other.messageSize_ = 0;
+	other.size_        = 0;
+}
+
+void Logify::QueuedRecord::release() noexcept
+{
+	if (chunk_) SpillArena::release(chunk_);
+	spilled_     = nullptr;
+	chunk_       = nullptr;
+	fieldCount_  = 0;
+	messageSize_ = 0;
+	size_        = 0;
+}
+
+Logify::RecordQueue::RecordQueue(
+	std::size_t capacity,
+	OverflowPolicy policy,
+	LogLevel keepLevel,
+	QueueCounters& counters
+)
+	:
+	ring_(std::max<std::size_t>(capacity, 1)),
+	head_(0),
+	size_(0),
+	policy_(policy),
+	keepLevel_(std::min(keepLevel, LogLevel::ERROR)),  // ERROR and FATAL are always kept.
+	closed_(false),
+	queued_(0),
+	written_(0),
+	counters_(counters)
+{}
+
+bool Logify::RecordQueue::push(const LogRecord& record)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	if (size_ == ring_.size())
+	{
+		switch (policy_)
+		{
+			case OverflowPolicy::DropNewest:
+				countDrop(record.level);
+				return false;
+
+			case OverflowPolicy::OverwriteOldest:
+				// Discard the oldest record to make room; it counts as dropped (and as done for flush()).
+				countDrop(ring_[head_].level());
+				head_ = (head_ + 1) % ring_.size();
+				--size_;
+				++written_;
+				break;
+
+			case OverflowPolicy::DropBelowLevel:
+				if (record.level < keepLevel_)
+				{
+					countDrop(record.level);
+					return false;
+				}
+				notFull_.wait(lock, [this]() { return size_ < ring_.size(); });
+				break;
+
+			case OverflowPolicy::Block:
+			default:
+				notFull_.wait(lock, [this]() { return size_ < ring_.size(); });
+				break;
+		}
+	}
+
+	// Copy the record into the next free slot; only data that does not fit goes to the thread's arena.
+	ring_[(head_ + size_) % ring_.size()].assign(record, SpillArena::forThread());
+	++size_;
+	++queued_;
+
+	// Track the deepest the queue has been; only pushes under the lock update it.
+	if (size_ > counters_.highWater.load(std::memory_order_relaxed))
+	{
+		counters_.highWater.store(size_, std::memory_order_relaxed);
+	}
+
+	lock.unlock();
+	notEmpty_.notify_one();
+	return true;
+}
+
+std::size_t Logify::RecordQueue::pop(
+	std::vector<QueuedRecord>& batch,
+	std::size_t maxRecords,
+	std::chrono::milliseconds timeout
+)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	notEmpty_.wait_for(lock, timeout, [this]() { return size_ > 0 || closed_; });
+
+	// Move the records out; this releases the spilled data of the batch's records written before.
+	std::size_t count = std::min(size_, maxRecords);
+	if (batch.size() < count) batch.resize(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		batch[i] = std::move(ring_[head_]);
+		head_ = (head_ + 1) % ring_.size();
+	}
+	size_ -= count;
+
+	lock.unlock();
+	if (count > 0) notFull_.notify_all();
+	return count;
+}
+
+void Logify::RecordQueue::markWritten(std::size_t count)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		written_ += count;
+	}
+	wroteSome_.notify_all();
+}
+
+void Logify::RecordQueue::waitUntilWritten()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	std::uint64_t target = queued_;
+	wroteSome_.wait(lock, [this, target]() { return written_ >= target || (closed_ && size_ == 0); });
+}
+
+void Logify::RecordQueue::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		closed_ = true;
+	}
+	notEmpty_.notify_all();
+}
+
+bool Logify::RecordQueue::isDrained()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return closed_ && size_ == 0;
+}
+
+void Logify::RecordQueue::countDrop(LogLevel level)
+{
+	counters_.dropped[static_cast<std::size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+}
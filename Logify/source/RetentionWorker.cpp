@@ -0,0 +1,116 @@
+#include "RetentionWorker.h"
+#include "LogSegments.h"
+#include "LogIndex.h"
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+
+Logify::RetentionWorker::RetentionWorker(std::string baseName, std::string extension, RetentionLimits limits)
+	:
+	baseName_(std::move(baseName)),
+	extension_(std::move(extension)),
+	limits_(limits),
+	pendingIndex_(-1),
+	stopping_(false)
+{
+	thread_ = std::thread(&RetentionWorker::run, this);
+}
+
+Logify::RetentionWorker::~RetentionWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	wakeUp_.notify_one();
+	thread_.join();
+}
+
+void Logify::RetentionWorker::schedule(const std::string& currentPeriod, int currentIndex)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		pendingPeriod_ = currentPeriod;
+		pendingIndex_  = currentIndex;
+	}
+	wakeUp_.notify_one();
+}
+
+void Logify::RetentionWorker::run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true)
+	{
+		wakeUp_.wait(lock, [this]() { return pendingIndex_ >= 0 || stopping_; });
+
+		// Several rotations in a row are handled by one cleanup for the latest index.
+		if (pendingIndex_ >= 0)
+		{
+			std::string currentPeriod = pendingPeriod_;
+			int         currentIndex  = std::exchange(pendingIndex_, -1);
+			lock.unlock();
+			applyLimits(currentPeriod, currentIndex);
+			lock.lock();
+			continue;
+		}
+
+		if (stopping_) break;
+	}
+}
+
+void Logify::RetentionWorker::applyLimits(const std::string& currentPeriod, int currentIndex) const
+{
+	namespace fs = std::filesystem;
+
+	struct File
+	{
+		LogSegment         segment;
+		std::uintmax_t     size;
+		fs::file_time_type lastWrite;
+	};
+
+	// Collect the files with their sizes and times; files that vanish meanwhile are skipped.
+	std::vector<File> files;
+	for (LogSegment& segment : findLogSegments(baseName_, extension_))
+	{
+		std::error_code error;
+		auto            size      = fs::file_size(segment.path, error);
+		auto            lastWrite = error ? fs::file_time_type() : fs::last_write_time(segment.path, error);
+		if (!error) files.push_back({std::move(segment), size, lastWrite});
+	}
+
+	// The newest files are kept first; the file being written (and any newer one) is always kept.
+	std::sort(files.begin(), files.end(), [](const File& a, const File& b) {
+		return b.segment.isOlderThan(a.segment.period, a.segment.index);
+	});
+
+	auto          now       = fs::file_time_type::clock::now();
+	std::size_t   keptFiles = 0;
+	std::uint64_t keptBytes = 0;
+	bool          full      = false;  // Once a file exceeds the count or size limit, all older files do too.
+	for (const File& file : files)
+	{
+		bool keep = !file.segment.isOlderThan(currentPeriod, currentIndex);
+		if (!keep)
+		{
+			full = full
+				|| (limits_.maxFiles > 0 && keptFiles + 1 > limits_.maxFiles)
+				|| (limits_.maxTotalBytes > 0 && keptBytes + file.size > limits_.maxTotalBytes);
+			bool tooOld = limits_.maxAge.count() > 0 && now - file.lastWrite > limits_.maxAge;
+			keep = !full && !tooOld;
+		}
+
+		if (keep)
+		{
+			++keptFiles;
+			keptBytes += file.size;
+		}
+		else
+		{
+			std::error_code error;
+			fs::remove(file.segment.path, error);
+			fs::remove(indexPath(file.segment.path.string()), error);
+		}
+	}
+}
@@ -17,6 +17,8 @@ Logify::ScopedLogger::Impl::Impl(Logger& logger, std::string scopeName, LogLevel
 Logify::ScopedLogger::ScopedLogger(Logify::Logger& logger, const std::string& scopeName, Logify::LogLevel level)
 	: pImpl_(std::make_unique<Impl>(logger, scopeName, level))
 {
+	// Enter the scope first, so that with scope buffering a low-level entry line is held with the scope.
+	logger.pImpl_->enterScope();
 	logger.log(level, scopeName + " {");
 	logger.pImpl_->indent();
 }
@@ -37,4 +39,7 @@ Logify::ScopedLogger::~ScopedLogger()
 		pImpl_->level_,
 		"} // End of " + pImpl_->scopeName_ + " - Duration: " + std::to_string(duration) + " ms"
 	);
+
+	// Leave the scope, discarding the held records if it was the outermost one.
+	pImpl_->logger_.pImpl_->leaveScope();
 }
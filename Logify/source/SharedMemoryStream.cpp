@@ -0,0 +1,29 @@
+#include "SharedMemoryStream.h"
+
+
+Logify::SharedMemoryStream::SharedMemoryStream(const std::string& name, std::size_t capacity, LogLevel minLevel)
+	: Sink(minLevel), ring_(name, capacity)
+{}
+
+std::string Logify::SharedMemoryStream::name() const
+{
+	return "shm:" + ring_.name();
+}
+
+void Logify::SharedMemoryStream::writeAfterCrash(const QueuedRecord& record) noexcept
+{
+	ring_.publish(record);
+}
+
+void Logify::SharedMemoryStream::write(const LogRecord& record)
+{
+	// The record is visible to the collector as soon as it is published; there is nothing to flush.
+	std::size_t size = ring_.publish(record);
+	if (size == 0)
+	{
+		countWriteError();
+		return;
+	}
+	countBytes(size);
+	countFlush();
+}
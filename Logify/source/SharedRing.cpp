@@ -0,0 +1,572 @@
+#include "SharedRing.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "The shared ring needs lock-free 64-bit atomics");
+
+/**
+ * @brief The start of the segment: its layout and the positions shared by all processes.
+ */
+struct Logify::SharedRing::Header
+{
+	std::atomic<std::uint32_t> state;     ///< Ready once the creator has initialized the segment.
+	std::uint32_t              version;   ///< The layout version of the segment.
+	std::uint64_t              capacity;  ///< The number of cells.
+	std::uint64_t              cellSize;  ///< The size of a cell.
+
+	alignas(64) std::atomic<std::uint64_t> writePosition;  ///< The next cell to reserve, written by producers.
+	alignas(64) std::atomic<std::uint64_t> readPosition;   ///< The next cell to take, written by the collector.
+	std::atomic<std::uint64_t>             dropped;        ///< Records dropped because the ring was full.
+};
+
+/**
+ * @brief A cell of the ring.
+ *
+ * A free cell of position p has sequence p, and keeps it while reserved. Committing a record
+ * sets the sequence of its first cell to p + 1; taking it sets each of its cells' sequences
+ * to their position plus the capacity, freeing them for the next round.
+ */
+struct alignas(64) Logify::SharedRing::Cell
+{
+	std::atomic<std::uint64_t> sequence;
+	char                       data[SharedRing::CellSize - sizeof(std::atomic<std::uint64_t>)];
+};
+
+/**
+ * @brief The fixed part of a record, followed by the message and the fields.
+ *
+ * Each field is stored as its type (1 byte), key size (4 bytes) and key, then its value:
+ * 8 bytes for numbers, 1 byte for booleans, or the size (4 bytes) and bytes of a string.
+ */
+struct Logify::SharedRing::RecordHeader
+{
+	std::uint32_t size;         ///< The size of the record, including this header.
+	std::uint32_t messageSize;  ///< The size of the message.
+	std::uint32_t pid;          ///< The process ID.
+	std::uint16_t fieldCount;   ///< The number of fields.
+	std::uint8_t  level;        ///< The log level.
+	std::uint8_t  reserved;
+	std::uint64_t tid;          ///< The OS thread ID.
+	std::int64_t  time;         ///< Nanoseconds since the epoch.
+	std::uint64_t indent;       ///< The scope indentation level.
+};
+
+namespace
+{
+  constexpr std::uint32_t ReadyState  = 0x4C4F4731;  // "LOG1"
+  constexpr std::uint32_t Version     = 1;
+  constexpr std::size_t   MinCapacity = 64;
+
+  // How long a process opening the segment waits for its creator to initialize it.
+  constexpr std::chrono::milliseconds InitializeTimeout{2000};
+
+  std::uint64_t roundUpToPowerOfTwo(std::size_t value)
+  {
+	  std::uint64_t power = MinCapacity;
+	  while (power < value) power <<= 1;
+	  return power;
+  }
+
+  std::size_t encodedSize(const Logify::Field& field)
+  {
+	  std::size_t size = 1 + sizeof(std::uint32_t) + field.key().size();
+	  switch (field.type())
+	  {
+		  case Logify::Field::Type::Bool:
+			  return size + 1;
+		  case Logify::Field::Type::String:
+			  return size + sizeof(std::uint32_t) + field.asString().size();
+		  default:
+			  return size + sizeof(std::uint64_t);
+	  }
+  }
+
+  [[noreturn]] void throwSystemError(const std::string& what, int error)
+  {
+	  throw std::runtime_error(what + ": " + std::system_category().message(error));
+  }
+}
+
+Logify::SharedRing::SharedRing(const std::string& name, std::size_t capacity)
+	:
+	name_(name),
+	memory_(nullptr),
+	mappedSize_(0),
+	header_(nullptr),
+	cells_(nullptr),
+	capacity_(roundUpToPowerOfTwo(capacity)),
+	maxCells_(0),
+	decoded_{},
+	stallLimit_(0)
+{
+	std::size_t size    = sizeof(Header) + capacity_ * sizeof(Cell);
+	bool        creator = false;
+
+#ifdef _WIN32
+	// The mapping is backed by the paging file and lives as long as any process has it open.
+	std::string mappingName = "Local\\" + name;
+	HANDLE      mapping     = CreateFileMappingA(
+		INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32), static_cast<DWORD>(size & 0xFFFFFFFF),
+		mappingName.c_str()
+	);
+	if (mapping == nullptr) throwSystemError("Cannot create shared memory " + name, static_cast<int>(GetLastError()));
+	creator = GetLastError() != ERROR_ALREADY_EXISTS;
+
+	memory_ = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	int error = static_cast<int>(GetLastError());
+	CloseHandle(mapping);
+	if (memory_ == nullptr) throwSystemError("Cannot map shared memory " + name, error);
+#else
+	// Exactly one process creates the segment; the others open it and wait until it is initialized.
+	std::string path = "/" + name;
+	int         fd   = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+	if (fd >= 0)
+	{
+		creator = true;
+		if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+		{
+			int error = errno;
+			close(fd);
+			shm_unlink(path.c_str());
+			throwSystemError("Cannot size shared memory " + name, error);
+		}
+	}
+	else if (errno == EEXIST)
+	{
+		fd = shm_open(path.c_str(), O_RDWR, 0);
+		if (fd < 0) throwSystemError("Cannot open shared memory " + name, errno);
+
+		// The creator may not have sized the segment yet.
+		auto        deadline = std::chrono::steady_clock::now() + InitializeTimeout;
+		struct stat status{};
+		while (fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) < sizeof(Header) + sizeof(Cell))
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				close(fd);
+				throw std::runtime_error("Shared memory " + name + " was not initialized by its creator");
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		size = static_cast<std::size_t>(status.st_size);
+	}
+	else
+	{
+		throwSystemError("Cannot create shared memory " + name, errno);
+	}
+
+	memory_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	int error = errno;
+	close(fd);
+	if (memory_ == MAP_FAILED)
+	{
+		memory_ = nullptr;
+		throwSystemError("Cannot map shared memory " + name, error);
+	}
+	mappedSize_ = size;
+#endif
+
+	header_ = static_cast<Header*>(memory_);
+	cells_  = reinterpret_cast<Cell*>(static_cast<char*>(memory_) + sizeof(Header));
+
+	if (creator)
+	{
+		// The new segment is zeroed; give every cell the sequence of its position in the first round.
+		header_->version  = Version;
+		header_->capacity = capacity_;
+		header_->cellSize = sizeof(Cell);
+		for (std::uint64_t i = 0; i < capacity_; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+		header_->state.store(ReadyState, std::memory_order_release);
+	}
+	else
+	{
+		// Wait for the creator, then use the layout it chose.
+		auto deadline = std::chrono::steady_clock::now() + InitializeTimeout;
+		while (header_->state.load(std::memory_order_acquire) != ReadyState)
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				unmap();
+				throw std::runtime_error("Shared memory " + name + " was not initialized by its creator");
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		capacity_ = header_->capacity;
+		bool fits = capacity_ >= MinCapacity && (capacity_ & (capacity_ - 1)) == 0;
+#ifndef _WIN32
+		fits = fits && sizeof(Header) + capacity_ * sizeof(Cell) <= mappedSize_;
+#endif
+		if (header_->version != Version || header_->cellSize != sizeof(Cell) || !fits)
+		{
+			unmap();
+			throw std::runtime_error("Shared memory " + name + " has an incompatible layout");
+		}
+	}
+
+	// Larger records would keep the ring from ever having room for them.
+	maxCells_ = capacity_ / 4;
+	stallLimit_ = header_->readPosition.load(std::memory_order_relaxed);
+}
+
+Logify::SharedRing::~SharedRing()
+{
+	unmap();
+}
+
+void Logify::SharedRing::remove(const std::string& name)
+{
+#ifdef _WIN32
+	// The mapping disappears with the last process that has it open.
+	(void)name;
+#else
+	shm_unlink(("/" + name).c_str());
+#endif
+}
+
+std::size_t Logify::SharedRing::publish(const LogRecord& record) noexcept
+{
+	RecordHeader header{};
+	header.pid    = record.pid;
+	header.level  = static_cast<std::uint8_t>(record.level);
+	header.tid    = record.tid;
+	header.time   = std::chrono::duration_cast<std::chrono::nanoseconds>(record.time.time_since_epoch()).count();
+	header.indent = record.indent;
+
+	return publishRecord(header, record.message, [&record](auto&& visit) {
+		for (const auto& field : record.fields) visit(field);
+	});
+}
+
+std::size_t Logify::SharedRing::publish(const QueuedRecord& record) noexcept
+{
+	RecordHeader header{};
+	header.pid    = record.pid();
+	header.level  = static_cast<std::uint8_t>(record.level());
+	header.tid    = record.tid();
+	header.time   = std::chrono::duration_cast<std::chrono::nanoseconds>(record.time().time_since_epoch()).count();
+	header.indent = record.indent();
+
+	return publishRecord(header, record.message(), [&record](auto&& visit) { record.forEachField(visit); });
+}
+
+template<typename FieldRange>
+std::size_t Logify::SharedRing::publishRecord(
+	RecordHeader& header,
+	std::string_view message,
+	FieldRange&& forEachField
+) noexcept
+{
+	constexpr std::size_t DataSize = sizeof(Cell::data);
+
+	// Measure the record; one too large for the ring keeps the start of its message only.
+	std::size_t fieldsSize = 0;
+	std::size_t fieldCount = 0;
+	forEachField([&](const Field& field) {
+		fieldsSize += encodedSize(field);
+		++fieldCount;
+	});
+
+	std::size_t maxSize = maxCells_ * DataSize;
+	if (sizeof(RecordHeader) + message.size() + fieldsSize > maxSize || fieldCount > UINT16_MAX)
+	{
+		fieldsSize = 0;
+		fieldCount = 0;
+		message    = message.substr(0, maxSize - sizeof(RecordHeader));
+	}
+	header.messageSize = static_cast<std::uint32_t>(message.size());
+	header.fieldCount  = static_cast<std::uint16_t>(fieldCount);
+	header.size        = static_cast<std::uint32_t>(sizeof(RecordHeader) + message.size() + fieldsSize);
+	std::uint64_t cells = (header.size + DataSize - 1) / DataSize;
+
+	// Reserve the cells: the last of them must be free for this round, then all before it are too.
+	std::uint64_t position = header_->writePosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		std::uint64_t last     = position + cells - 1;
+		std::uint64_t sequence = cell(last).sequence.load(std::memory_order_acquire);
+		auto          distance = static_cast<std::int64_t>(sequence - last);
+		if (distance == 0)
+		{
+			if (header_->writePosition.compare_exchange_weak(position, position + cells, std::memory_order_relaxed)) break;
+		}
+		else if (distance < 0)
+		{
+			// The collector has not taken the records of the previous round: the ring is full.
+			header_->dropped.fetch_add(1, std::memory_order_relaxed);
+			return 0;
+		}
+		else
+		{
+			position = header_->writePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Copy the record into the reserved cells, continuing in the next cell at the end of each.
+	// Before writing into a cell, check that it is still reserved: if this producer was stalled for
+	// longer than AbandonAfter, the collector has handed the cell to the next round.
+	std::size_t offset    = 0;
+	bool        abandoned = false;
+	auto append = [&](const void* data, std::size_t size) {
+		const char* bytes = static_cast<const char*>(data);
+		while (size > 0 && !abandoned)
+		{
+			std::size_t   at     = offset % DataSize;
+			std::size_t   count  = std::min(size, DataSize - at);
+			std::uint64_t target = position + offset / DataSize;
+			if (at == 0 && cell(target).sequence.load(std::memory_order_acquire) != target)
+			{
+				abandoned = true;
+				break;
+			}
+			std::memcpy(cell(target).data + at, bytes, count);
+			bytes += count;
+			size -= count;
+			offset += count;
+		}
+	};
+
+	append(&header, sizeof(header));
+	append(message.data(), message.size());
+	if (fieldCount > 0)
+	{
+		forEachField([&](const Field& field) {
+			auto          type    = static_cast<std::uint8_t>(field.type());
+			auto          keySize = static_cast<std::uint32_t>(field.key().size());
+			append(&type, 1);
+			append(&keySize, sizeof(keySize));
+			append(field.key().data(), keySize);
+			switch (field.type())
+			{
+				case Field::Type::Int:
+				{
+					std::int64_t value = field.asInt();
+					append(&value, sizeof(value));
+					break;
+				}
+				case Field::Type::UInt:
+				{
+					std::uint64_t value = field.asUInt();
+					append(&value, sizeof(value));
+					break;
+				}
+				case Field::Type::Double:
+				{
+					double value = field.asDouble();
+					append(&value, sizeof(value));
+					break;
+				}
+				case Field::Type::Bool:
+				{
+					std::uint8_t value = field.asBool() ? 1 : 0;
+					append(&value, 1);
+					break;
+				}
+				case Field::Type::String:
+				{
+					auto valueSize = static_cast<std::uint32_t>(field.asString().size());
+					append(&valueSize, sizeof(valueSize));
+					append(field.asString().data(), valueSize);
+					break;
+				}
+			}
+		});
+	}
+
+	// Commit; this fails only if the collector gave up on the record because it took too long.
+	std::uint64_t reserved = position;
+	if (abandoned || !cell(position).sequence.compare_exchange_strong(reserved, position + 1, std::memory_order_release))
+	{
+		header_->dropped.fetch_add(1, std::memory_order_relaxed);
+		return 0;
+	}
+	return header.size;
+}
+
+bool Logify::SharedRing::takeNext()
+{
+	constexpr std::size_t DataSize = sizeof(Cell::data);
+
+	std::uint64_t position = header_->readPosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Cell&         first    = cell(position);
+		std::uint64_t sequence = first.sequence.load(std::memory_order_acquire);
+		if (sequence == position + 1) break;
+
+		// Nothing reserved here yet: the ring is empty.
+		if (header_->writePosition.load(std::memory_order_acquire) <= position) return false;
+
+		// Reserved but not committed. Remember when this was first seen: every position below the
+		// write position of that moment was reserved by then.
+		auto now = std::chrono::steady_clock::now();
+		if (position >= stallLimit_)
+		{
+			stallLimit_ = header_->writePosition.load(std::memory_order_acquire);
+			stallSince_ = now;
+			return false;
+		}
+		if (now - stallSince_ < AbandonAfter) return false;
+
+		// The producer took too long, probably because its process died: skip the cell.
+		if (first.sequence.compare_exchange_strong(sequence, position + capacity_, std::memory_order_acq_rel))
+		{
+			++position;
+			header_->readPosition.store(position, std::memory_order_release);
+		}
+	}
+
+	// Copy the record out of its cells, then hand the cells to the producers of the next round.
+	RecordHeader header;
+	std::memcpy(&header, cell(position).data, sizeof(header));
+	std::uint64_t cells = (header.size + DataSize - 1) / DataSize;
+	bool          valid = header.size >= sizeof(RecordHeader) && cells <= maxCells_;
+	if (!valid) cells = 1;
+
+	buffer_.resize(valid ? header.size : 0);
+	for (std::size_t offset = 0; offset < buffer_.size(); offset += DataSize)
+	{
+		std::memcpy(
+			buffer_.data() + offset, cell(position + offset / DataSize).data, std::min(DataSize, buffer_.size() - offset)
+		);
+	}
+
+	for (std::uint64_t i = 0; i < cells; ++i)
+	{
+		cell(position + i).sequence.store(position + i + capacity_, std::memory_order_release);
+	}
+	header_->readPosition.store(position + cells, std::memory_order_release);
+
+	// Decode the record, with views into the buffer; a damaged record keeps what can be read of it.
+	fields_.clear();
+	std::string_view data(buffer_);
+	std::size_t      at      = std::min(data.size(), sizeof(RecordHeader));
+	std::string_view message = data.substr(at, valid ? header.messageSize : 0);
+	at += message.size();
+
+	auto read = [&](void* value, std::size_t size) {
+		if (data.size() - at < size) return false;
+		std::memcpy(value, data.data() + at, size);
+		at += size;
+		return true;
+	};
+	auto readString = [&](std::string_view& value, std::uint32_t size) {
+		if (data.size() - at < size) return false;
+		value = data.substr(at, size);
+		at += size;
+		return true;
+	};
+
+	for (std::size_t i = 0; valid && i < header.fieldCount; ++i)
+	{
+		std::uint8_t     type    = 0;
+		std::uint32_t    keySize = 0;
+		std::string_view key;
+		if (!read(&type, 1) || !read(&keySize, sizeof(keySize)) || !readString(key, keySize)) break;
+
+		bool complete = false;
+		switch (static_cast<Field::Type>(type))
+		{
+			case Field::Type::Int:
+			{
+				std::int64_t value = 0;
+				if ((complete = read(&value, sizeof(value)))) fields_.emplace_back(key, value);
+				break;
+			}
+			case Field::Type::UInt:
+			{
+				std::uint64_t value = 0;
+				if ((complete = read(&value, sizeof(value)))) fields_.emplace_back(key, value);
+				break;
+			}
+			case Field::Type::Double:
+			{
+				double value = 0;
+				if ((complete = read(&value, sizeof(value)))) fields_.emplace_back(key, value);
+				break;
+			}
+			case Field::Type::Bool:
+			{
+				std::uint8_t value = 0;
+				if ((complete = read(&value, 1))) fields_.emplace_back(key, value != 0);
+				break;
+			}
+			case Field::Type::String:
+			{
+				std::uint32_t    valueSize = 0;
+				std::string_view value;
+				if ((complete = read(&valueSize, sizeof(valueSize)) && readString(value, valueSize)))
+				{
+					fields_.emplace_back(key, value);
+				}
+				break;
+			}
+		}
+		if (!complete) break;
+	}
+
+	decoded_.level   = valid && header.level <= static_cast<std::uint8_t>(LogLevel::FATAL)
+		? static_cast<LogLevel>(header.level)
+		: LogLevel::WARN;
+	decoded_.ticks   = 0;
+	decoded_.time    = std::chrono::system_clock::time_point(
+		std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(valid ? header.time : 0))
+	);
+	decoded_.pid     = valid ? header.pid : 0;
+	decoded_.tid     = valid ? header.tid : 0;
+	decoded_.message = valid ? message : std::string_view("Damaged record in shared memory");
+	decoded_.fields  = fields_;
+	decoded_.indent  = valid ? header.indent : 0;
+	return true;
+}
+
+std::uint64_t Logify::SharedRing::writePosition() const
+{
+	return header_->writePosition.load(std::memory_order_acquire);
+}
+
+std::uint64_t Logify::SharedRing::readPosition() const
+{
+	return header_->readPosition.load(std::memory_order_acquire);
+}
+
+std::uint64_t Logify::SharedRing::dropped() const
+{
+	return header_->dropped.load(std::memory_order_relaxed);
+}
+
+void Logify::SharedRing::unmap() noexcept
+{
+	if (memory_ == nullptr) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(memory_);
+#else
+	munmap(memory_, mappedSize_);
+#endif
+	memory_ = nullptr;
+}
+
+Logify::SharedRing::Cell& Logify::SharedRing::cell(std::uint64_t position) const
+{
+	return cells_[position & (capacity_ - 1)];
+}
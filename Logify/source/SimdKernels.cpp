@@ -0,0 +1,365 @@
+#include "SimdKernels.h"
+#include <array>
+#include <bit>
+#include <cstring>
+
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LOGIFY_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LOGIFY_TARGET_AVX2
+#else
+#define LOGIFY_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+
+namespace
+{
+
+  // Byte classes used by the scalar kernels and for the tails of the vector kernels.
+  constexpr std::array<bool, 256> makeHtmlTable()
+  {
+	  std::array<bool, 256> table{};
+	  table['<']  = true;
+	  table['>']  = true;
+	  table['&']  = true;
+	  table['"']  = true;
+	  table['\''] = true;
+	  return table;
+  }
+
+  constexpr std::array<bool, 256> makeJsonTable()
+  {
+	  std::array<bool, 256> table{};
+	  for (int c = 0; c < 0x20; ++c) table[c] = true;
+	  table['"']  = true;
+	  table['\\'] = true;
+	  return table;
+  }
+
+  constexpr std::array<bool, 256> HtmlTable = makeHtmlTable();
+  constexpr std::array<bool, 256> JsonTable = makeJsonTable();
+
+  std::size_t findHtmlSpecialScalar(const char* data, std::size_t size)
+  {
+	  for (std::size_t i = 0; i < size; ++i)
+	  {
+		  if (HtmlTable[static_cast<unsigned char>(data[i])]) return i;
+	  }
+	  return size;
+  }
+
+  std::size_t findJsonSpecialScalar(const char* data, std::size_t size)
+  {
+	  for (std::size_t i = 0; i < size; ++i)
+	  {
+		  if (JsonTable[static_cast<unsigned char>(data[i])]) return i;
+	  }
+	  return size;
+  }
+
+  std::size_t findByteScalar(const char* data, std::size_t size, char byte)
+  {
+	  const void* hit = std::memchr(data, byte, size);
+	  return hit ? static_cast<std::size_t>(static_cast<const char*>(hit) - data) : size;
+  }
+
+#ifdef LOGIFY_SIMD_X86
+
+  /*
+   * SSE2 kernels (always available on x86-64).
+   */
+
+  inline __m128i htmlMask16(__m128i chunk)
+  {
+	  __m128i hits = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('<'));
+	  hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('>')));
+	  hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('&')));
+	  hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+	  return _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\'')));
+  }
+
+  inline __m128i jsonMask16(__m128i chunk)
+  {
+	  // Unsigned "chunk <= 0x1F" is expressed as min(chunk, 0x1F) == chunk.
+	  __m128i hits = _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk);
+	  hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+	  return _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+  }
+
+  std::size_t findHtmlSpecialSse2(const char* data, std::size_t size)
+  {
+	  std::size_t i = 0;
+	  for (; i + 16 <= size; i += 16)
+	  {
+		  __m128i  chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		  unsigned mask  = static_cast<unsigned>(_mm_movemask_epi8(htmlMask16(chunk)));
+		  if (mask != 0) return i + std::countr_zero(mask);
+	  }
+	  return i + findHtmlSpecialScalar(data + i, size - i);
+  }
+
+  std::size_t findJsonSpecialSse2(const char* data, std::size_t size)
+  {
+	  std::size_t i = 0;
+	  for (; i + 16 <= size; i += 16)
+	  {
+		  __m128i  chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		  unsigned mask  = static_cast<unsigned>(_mm_movemask_epi8(jsonMask16(chunk)));
+		  if (mask != 0) return i + std::countr_zero(mask);
+	  }
+	  return i + findJsonSpecialScalar(data + i, size - i);
+  }
+
+  std::size_t findByteSse2(const char* data, std::size_t size, char byte)
+  {
+	  const __m128i needle = _mm_set1_epi8(byte);
+	  std::size_t   i      = 0;
+	  for (; i + 16 <= size; i += 16)
+	  {
+		  __m128i  chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		  unsigned mask  = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+		  if (mask != 0) return i + std::countr_zero(mask);
+	  }
+	  return i + findByteScalar(data + i, size - i, byte);
+  }
+
+  /*
+   * AVX2 kernels (selected at runtime when the CPU and the OS support them).
+   */
+
+  LOGIFY_TARGET_AVX2 std::size_t findHtmlSpecialAvx2(const char* data, std::size_t size)
+  {
+	  const __m256i lt   = _mm256_set1_epi8('<');
+	  const __m256i gt   = _mm256_set1_epi8('>');
+	  const __m256i amp  = _mm256_set1_epi8('&');
+	  const __m256i quot = _mm256_set1_epi8('"');
+	  const __m256i apos = _mm256_set1_epi8('\'');
+
+	  std::size_t i = 0;
+	  for (; i + 32 <= size; i += 32)
+	  {
+		  __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		  __m256i hits  = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lt), _mm256_cmpeq_epi8(chunk, gt));
+		  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, amp));
+		  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, quot));
+		  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, apos));
+
+		  unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+		  if (mask != 0) return i + std::countr_zero(mask);
+	  }
+	  return i + findHtmlSpecialSse2(data + i, size - i);
+  }
+
+  LOGIFY_TARGET_AVX2 std::size_t findJsonSpecialAvx2(const char* data, std::size_t size)
+  {
+	  const __m256i control   = _mm256_set1_epi8(0x1F);
+	  const __m256i quote     = _mm256_set1_epi8('"');
+	  const __m256i backslash = _mm256_set1_epi8('\\');
+
+	  std::size_t i = 0;
+	  for (; i + 32 <= size; i += 32)
+	  {
+		  __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		  __m256i hits  = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk);
+		  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, quote));
+		  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, backslash));
+
+		  unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+		  if (mask != 0) return i + std::countr_zero(mask);
+	  }
+	  return i + findJsonSpecialSse2(data + i, size - i);
+  }
+
+  LOGIFY_TARGET_AVX2 std::size_t findByteAvx2(const char* data, std::size_t size, char byte)
+  {
+	  const __m256i needle = _mm256_set1_epi8(byte);
+	  std::size_t   i      = 0;
+	  for (; i + 32 <= size; i += 32)
+	  {
+		  __m256i  chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		  unsigned mask  = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+		  if (mask != 0) return i + std::countr_zero(mask);
+	  }
+	  return i + findByteSse2(data + i, size - i, byte);
+  }
+
+  bool cpuSupportsAvx2()
+  {
+#ifdef _MSC_VER
+	  int info[4];
+	  __cpuid(info, 0);
+	  if (info[0] < 7) return false;
+
+	  // AVX and OSXSAVE are required so that the OS saves the YMM registers.
+	  __cpuid(info, 1);
+	  bool osxsave = (info[2] & (1 << 27)) != 0;
+	  bool avx     = (info[2] & (1 << 28)) != 0;
+	  if (!osxsave || !avx) return false;
+	  if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+	  __cpuidex(info, 7, 0);
+	  return (info[1] & (1 << 5)) != 0;
+#else
+	  // Reads cpuid (and XCR0 for OS support of the YMM state).
+	  __builtin_cpu_init();
+	  return __builtin_cpu_supports("avx2");
+#endif
+  }
+
+#endif // LOGIFY_SIMD_X86
+
+  Logify::simd::KernelTable selectKernels()
+  {
+#ifdef LOGIFY_SIMD_X86
+	  if (cpuSupportsAvx2()) return {findHtmlSpecialAvx2, findJsonSpecialAvx2, findByteAvx2, "avx2"};
+	  return {findHtmlSpecialSse2, findJsonSpecialSse2, findByteSse2, "sse2"};
+#else
+	  return {findHtmlSpecialScalar, findJsonSpecialScalar, findByteScalar, "scalar"};
+#endif
+  }
+
+} // namespace
+
+
+const Logify::simd::KernelTable& Logify::simd::kernels()
+{
+	// Selected once; the initialization of function-local statics is thread-safe.
+	static const KernelTable table = selectKernels();
+	return table;
+}
+
+void Logify::simd::appendHtmlEscaped(std::string& out, std::string_view text)
+{
+	const KernelTable& k = kernels();
+
+	while (!text.empty())
+	{
+		// Copy the run of plain bytes in one go.
+		std::size_t pos = k.findHtmlSpecial(text.data(), text.size());
+		out.append(text.data(), pos);
+		if (pos == text.size()) break;
+
+		switch (text[pos])
+		{
+			case '<':
+				out += "&lt;";
+				break;
+			case '>':
+				out += "&gt;";
+				break;
+			case '&':
+				out += "&amp;";
+				break;
+			case '"':
+				out += "&quot;";
+				break;
+			default:
+				out += "&#39;";
+				break;
+		}
+		text.remove_prefix(pos + 1);
+	}
+}
+
+void Logify::simd::appendJsonEscaped(std::string& out, std::string_view text)
+{
+	static constexpr char hex[] = "0123456789abcdef";
+	const KernelTable& k = kernels();
+
+	while (!text.empty())
+	{
+		// Copy the run of plain bytes in one go.
+		std::size_t pos = k.findJsonSpecial(text.data(), text.size());
+		out.append(text.data(), pos);
+		if (pos == text.size()) break;
+
+		auto c = static_cast<unsigned char>(text[pos]);
+		switch (c)
+		{
+			case '"':
+				out += "\\\"";
+				break;
+			case '\\':
+				out += "\\\\";
+				break;
+			case '\n':
+				out += "\\n";
+				break;
+			case '\r':
+				out += "\\r";
+				break;
+			case '\t':
+				out += "\\t";
+				break;
+			case '\b':
+				out += "\\b";
+				break;
+			case '\f':
+				out += "\\f";
+				break;
+			default:
+				out += "\\u00";
+				out += hex[c >> 4];
+				out += hex[c & 0xF];
+				break;
+		}
+		text.remove_prefix(pos + 1);
+	}
+}
+
+void Logify::simd::appendIndented(std::string& out, std::string_view text, std::string_view indentation)
+{
+	// Without indentation the text is copied as is.
+	if (indentation.empty())
+	{
+		out.append(text);
+		return;
+	}
+
+	const KernelTable& k = kernels();
+
+	while (!text.empty())
+	{
+		std::size_t pos = k.findByte(text.data(), text.size(), '\n');
+		if (pos == text.size())
+		{
+			out.append(text);
+			break;
+		}
+
+		// Copy the line including its newline, then indent the continuation line.
+		out.append(text.data(), pos + 1);
+		text.remove_prefix(pos + 1);
+		if (!text.empty()) out.append(indentation);
+	}
+}
+
+void Logify::simd::appendReplaced(std::string& out, std::string_view text, std::string_view from, std::string_view to)
+{
+	const KernelTable& k = kernels();
+
+	while (text.size() >= from.size())
+	{
+		// Scan for the first byte of the pattern, then confirm the rest.
+		std::size_t pos = k.findByte(text.data(), text.size() - from.size() + 1, from.front());
+		if (pos == text.size() - from.size() + 1) break;
+
+		if (text.compare(pos, from.size(), from) == 0)
+		{
+			out.append(text.data(), pos);
+			out.append(to);
+			text.remove_prefix(pos + from.size());
+		}
+		else
+		{
+			out.append(text.data(), pos + 1);
+			text.remove_prefix(pos + 1);
+		}
+	}
+
+	out.append(text);
+}
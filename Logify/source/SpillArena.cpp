@@ -0,0 +1,115 @@
+#include "SpillArena.h"
+#include <new>
+
+
+namespace
+{
+  Logify::SpillChunk* newChunk(std::size_t capacity)
+  {
+	  // The header and the data are one allocation; the header's size keeps the data 8-byte aligned.
+	  static_assert(sizeof(Logify::SpillChunk) % 8 == 0);
+	  void* memory    = ::operator new(sizeof(Logify::SpillChunk) + capacity);
+	  auto* chunk     = new(memory) Logify::SpillChunk();
+	  chunk->capacity = capacity;
+	  return chunk;
+  }
+
+  void deleteChunk(Logify::SpillChunk* chunk)
+  {
+	  chunk->~SpillChunk();
+	  ::operator delete(chunk);
+  }
+}
+
+Logify::SpillPool::~SpillPool()
+{
+	for (SpillChunk* chunk : free_) deleteChunk(chunk);
+}
+
+Logify::SpillChunk* Logify::SpillPool::acquire(std::size_t capacity)
+{
+	SpillChunk* chunk = nullptr;
+	if (capacity == SpillArena::ChunkSize)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!free_.empty())
+		{
+			chunk = free_.back();
+			free_.pop_back();
+		}
+	}
+
+	if (!chunk) chunk = newChunk(capacity);
+	chunk->used = 0;
+	return chunk;
+}
+
+void Logify::SpillPool::recycle(SpillChunk* chunk)
+{
+	if (chunk->capacity != SpillArena::ChunkSize)
+	{
+		deleteChunk(chunk);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	free_.push_back(chunk);
+}
+
+Logify::SpillArena::SpillArena() : pool_(std::make_shared<SpillPool>()), current_(nullptr)
+{}
+
+Logify::SpillArena::~SpillArena()
+{
+	// Records still using the chunk keep it, and the pool, alive after the arena is gone.
+	if (current_) release(current_);
+}
+
+Logify::SpillArena& Logify::SpillArena::forThread()
+{
+	thread_local SpillArena arena;
+	return arena;
+}
+
+char* Logify::SpillArena::allocate(std::size_t size, SpillChunk*& chunk)
+{
+	size = (size + 7) & ~std::size_t(7);
+
+	// Large data gets a chunk of its own, which is freed rather than pooled when released.
+	if (size > ChunkSize / 4)
+	{
+		chunk       = take(size);
+		chunk->used = size;
+		return chunk->data();
+	}
+
+	// Move on to a fresh chunk when the current one is full; it is recycled once its records are released.
+	if (!current_ || current_->used + size > current_->capacity)
+	{
+		if (current_) release(current_);
+		current_ = take(ChunkSize);
+	}
+
+	chunk = current_;
+	chunk->references.fetch_add(1, std::memory_order_relaxed);
+	char* data = chunk->data() + chunk->used;
+	chunk->used += size;
+	return data;
+}
+
+void Logify::SpillArena::release(SpillChunk* chunk) noexcept
+{
+	if (chunk->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+	// The last reference: hand the chunk back, keeping the pool alive until it has been recycled.
+	std::shared_ptr<SpillPool> pool = std::move(chunk->pool);
+	pool->recycle(chunk);
+}
+
+Logify::SpillChunk* Logify::SpillArena::take(std::size_t capacity)
+{
+	SpillChunk* chunk = pool_->acquire(capacity);
+	chunk->references.store(1, std::memory_order_relaxed);
+	chunk->pool = pool_;
+	return chunk;
+}
@@ -0,0 +1,41 @@
+#include "TickClock.h"
+#include <atomic>
+
+
+namespace
+{
+  // Nanoseconds from the steady clock's epoch to the wall clock's, and the ticks from which it is measured again.
+  std::atomic<std::int64_t>  offset{0};
+  std::atomic<std::uint64_t> resyncAt{0};
+
+  std::int64_t nanoseconds(std::chrono::steady_clock::duration duration)
+  {
+	  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  }
+}
+
+std::chrono::system_clock::time_point Logify::TickClock::toTime(std::uint64_t ticks) noexcept
+{
+	// Measure the offset once per interval; threads racing here store nearly equal values.
+	if (ticks >= resyncAt.load(std::memory_order_acquire))
+	{
+		auto steady = std::chrono::steady_clock::now();
+		auto wall   = std::chrono::system_clock::now();
+		offset.store(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(wall.time_since_epoch()).count()
+				- nanoseconds(steady.time_since_epoch()),
+			std::memory_order_relaxed
+		);
+		resyncAt.store(
+			static_cast<std::uint64_t>((steady + ResyncInterval).time_since_epoch().count()),
+			std::memory_order_release
+		);
+	}
+
+	// The steady ticks plus the offset give the wall-clock time at which they were read.
+	std::int64_t wallNanoseconds =
+		nanoseconds(std::chrono::steady_clock::duration(ticks)) + offset.load(std::memory_order_relaxed);
+	return std::chrono::system_clock::time_point(
+		std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(wallNanoseconds))
+	);
+}
@@ -1,6 +1,7 @@
 
 
 #include "LoggerImpl.h"
+#include "ForkHandler.h"
 #include <cstdint>
 
 
@@ -11,17 +12,50 @@
 
 #else
 #include <unistd.h>
+#include <sys/syscall.h>
 #endif
 
 
-std::uint32_t Logify::Logger::Impl::getPID()
+namespace
 {
+  /**
+   * @brief The IDs of the calling thread and its process, queried again after a fork.
+   */
+  struct ThreadIds
+  {
+	  std::uint64_t generation = 0;  ///< The fork generation the IDs were queried in.
+	  std::uint32_t pid        = 0;  ///< The process ID, or 0 before the first query.
+	  std::uint64_t tid        = 0;  ///< The thread ID.
+  };
+
+  const ThreadIds& threadIds()
+  {
+	  thread_local ThreadIds ids;
+
+	  // The IDs never change for a thread, except for the forking thread, which continues in the child.
+	  std::uint64_t generation = Logify::forking::generation();
+	  if (ids.pid != 0 && ids.generation == generation) return ids;
+
+	  ids.generation = generation;
 #ifdef _WIN32
-	// On Windows, use GetCurrentProcessId() to retrieve the process ID.
-	return static_cast<std::uint32_t>(GetCurrentProcessId());
+	  // On Windows, use GetCurrentProcessId() and GetCurrentThreadId().
+	  ids.pid = static_cast<std::uint32_t>(GetCurrentProcessId());
+	  ids.tid = static_cast<std::uint64_t>(GetCurrentThreadId());
 #else
-	// On Unix-like systems, use getpid() to retrieve the process ID.
-	return static_cast<std::uint32_t>(getpid());
+	  // On Unix-like systems, use getpid(); on Linux, the gettid system call retrieves the kernel thread ID.
+	  ids.pid = static_cast<std::uint32_t>(getpid());
+	  ids.tid = static_cast<std::uint64_t>(syscall(SYS_gettid));
 #endif
+	  return ids;
+  }
 }
 
+std::uint32_t Logify::Logger::Impl::getPID()
+{
+	return threadIds().pid;
+}
+
+std::uint64_t Logify::Logger::Impl::getTID()
+{
+	return threadIds().tid;
+}
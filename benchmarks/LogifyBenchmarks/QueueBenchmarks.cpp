@@ -0,0 +1,129 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+  // Allocations made by the current thread, counted by the replaced operator new below.
+  thread_local std::size_t allocations = 0;
+
+  // A stream buffer that discards everything, so the benchmarks measure the logging side only.
+  class NullBuffer : public std::streambuf
+  {
+   protected:
+	  std::streamsize xsputn(const char*, std::streamsize n) override
+	  {
+		  return n;
+	  }
+
+	  int overflow(int c) override
+	  {
+		  return traits_type::not_eof(c);
+	  }
+  };
+
+  // Message sizes below and above the inline storage of a queue slot, and above a quarter arena chunk.
+  const std::vector<std::size_t> MessageSizes{64, 160, 1000, 8000, 32000};
+}
+
+void* operator new(std::size_t size)
+{
+	++allocations;
+	if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+
+TEST_CASE("Queued record allocations", "[Queue]")
+{
+	using namespace Logify;
+
+	NullBuffer   buffer;
+	std::ostream stream(&buffer);
+
+	std::printf("\n%-14s %-22s\n", "message bytes", "allocations / message");
+	for (std::size_t size : MessageSizes)
+	{
+		Logger logger(LogLevel::INFO);
+		logger.addOutputStream(stream);
+		logger.enableAsync(8192);
+
+		// Warm up, so the queue's slots and the arena's chunks exist, then count the logging thread's allocations.
+		const std::string message(size, 'm');
+		for (int i = 0; i < 20000; ++i) logger.info(message, {{"i", i}});
+		logger.flush();
+
+		constexpr int Messages = 100000;
+		std::size_t   before   = allocations;
+		for (int i = 0; i < Messages; ++i) logger.info(message, {{"i", i}});
+		std::size_t counted = allocations - before;
+		logger.flush();
+
+		std::printf("%-14zu %-22.4f\n", size, static_cast<double>(counted) / Messages);
+
+		// Messages that fit into a slot are queued without allocating; those sharing an arena chunk
+		// only allocate while the pool of chunks grows to the number the writer keeps in flight.
+		if (size <= 160) CHECK(counted == 0);
+		if (size <= 8000) CHECK(counted * 100 < Messages);
+	}
+}
+
+TEST_CASE("Queued record throughput", "[Queue]")
+{
+	using namespace Logify;
+
+	NullBuffer   buffer;
+	std::ostream stream(&buffer);
+
+	for (std::size_t size : MessageSizes)
+	{
+		// Overwriting the oldest record keeps the logging thread from waiting for the writer.
+		Logger logger(LogLevel::INFO);
+		logger.addOutputStream(stream);
+		logger.enableAsync(8192, OverflowPolicy::OverwriteOldest);
+
+		const std::string message(size, 'm');
+		BENCHMARK("queue a " + std::to_string(size) + " byte message")
+		{
+			logger.info(message, {{"size", size}});
+		};
+	}
+}
+
+TEST_CASE("Flight recorder throughput", "[FlightRecorder]")
+{
+	using namespace Logify;
+
+	NullBuffer   buffer;
+	std::ostream stream(&buffer);
+
+	for (std::size_t size : MessageSizes)
+	{
+		Logger logger(LogLevel::INFO);
+		logger.addOutputStream(stream);
+		logger.enableFlightRecorder(1024);
+
+		const std::string message(size, 'm');
+		BENCHMARK("record a " + std::to_string(size) + " byte message")
+		{
+			logger.debug(message, {{"size", size}});
+		};
+	}
+}
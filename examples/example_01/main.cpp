@@ -20,8 +20,8 @@ int main(int argc, char* argv[]) {
 	// Activate Indentation inside scopes
 	logger.setIndentation(true);
 
-	// Add an output stream to the logger, directing logs to the console (std::cout).
-	logger.addOutputStream(std::cout);
+	// Add the console (standard output) to the logger. Colors are used only if it is a terminal.
+	logger.addConsoleStream(Logify::ConsoleTarget::StdOut);
 
 	// Add file streams to the logger, logging to both a text file and an HTML file with rotation.
 	// The HTML file uses a color scheme defined in the library.
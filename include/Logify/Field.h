@@ -0,0 +1,123 @@
+/*
+ * Logify Logger Library
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file declares the Field class used in the Logify logging library.
+ * A Field is a typed key/value pair attached to a log message. Fields are kept in
+ * their native types until an output stream writes the message, so each output
+ * renders them in its own format (key=value text, HTML cells or JSON values).
+ *
+ * Usage:
+ * ```cpp
+ * logger.info("order filled", {{"qty", 100}, {"px", 12.5}, {"sym", "ABC"}});
+ * ```
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+namespace Logify
+{
+
+  /**
+   * @class Field
+   * @brief A typed key/value pair attached to a log message.
+   *
+   * A Field does not own its key or string value. Both must outlive the logging call,
+   * which is always the case for literals and for arguments of the call itself.
+   */
+  class Field
+  {
+   public:
+	  /**
+	   * @enum Type
+	   * @brief The type of the value stored in a Field.
+	   */
+	  enum class Type
+	  {
+		  Int,     ///< Signed integer value.
+		  UInt,    ///< Unsigned integer value.
+		  Double,  ///< Floating-point value.
+		  String,  ///< String value.
+		  Bool     ///< Boolean value.
+	  };
+
+	  /**
+	   * @brief Constructs a field holding a signed integer.
+	   */
+	  template<std::signed_integral T>
+	  constexpr Field(std::string_view key, T value) : key_(key), type_(Type::Int), int_(value)
+	  {}
+
+	  /**
+	   * @brief Constructs a field holding an unsigned integer.
+	   */
+	  template<std::unsigned_integral T> requires (!std::same_as<T, bool>)
+	  constexpr Field(std::string_view key, T value) : key_(key), type_(Type::UInt), uint_(value)
+	  {}
+
+	  /**
+	   * @brief Constructs a field holding a floating-point number.
+	   */
+	  template<std::floating_point T>
+	  constexpr Field(std::string_view key, T value) : key_(key), type_(Type::Double), double_(value)
+	  {}
+
+	  /**
+	   * @brief Constructs a field holding a boolean.
+	   */
+	  constexpr Field(std::string_view key, bool value) : key_(key), type_(Type::Bool), bool_(value)
+	  {}
+
+	  /**
+	   * @brief Constructs a field holding a string.
+	   */
+	  constexpr Field(std::string_view key, std::string_view value) : key_(key), type_(Type::String), string_(value)
+	  {}
+
+	  /**
+	   * @brief Constructs a field holding a null-terminated string.
+	   */
+	  constexpr Field(std::string_view key, const char* value) : Field(key, std::string_view(value))
+	  {}
+
+	  /**
+	   * @brief Constructs a field holding a string.
+	   */
+	  Field(std::string_view key, const std::string& value) : Field(key, std::string_view(value))
+	  {}
+
+	  [[nodiscard]] constexpr std::string_view key() const { return key_; }            ///< The key of the field.
+	  [[nodiscard]] constexpr Type type() const { return type_; }                      ///< The type of the value.
+	  [[nodiscard]] constexpr std::int64_t asInt() const { return int_; }              ///< The value, if Type::Int.
+	  [[nodiscard]] constexpr std::uint64_t asUInt() const { return uint_; }           ///< The value, if Type::UInt.
+	  [[nodiscard]] constexpr double asDouble() const { return double_; }              ///< The value, if Type::Double.
+	  [[nodiscard]] constexpr bool asBool() const { return bool_; }                    ///< The value, if Type::Bool.
+	  [[nodiscard]] constexpr std::string_view asString() const { return string_; }    ///< The value, if Type::String.
+
+   private:
+	  std::string_view key_;   ///< The key of the field.
+	  Type             type_;  ///< The type of the stored value.
+	  union
+	  {
+		  std::int64_t     int_;
+		  std::uint64_t    uint_;
+		  double           double_;
+		  bool             bool_;
+		  std::string_view string_;
+	  };
+  };
+
+} // namespace Logify
@@ -0,0 +1,113 @@
+/*
+ * Logify Logger Library
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * LogStream is a stream-style front end for the Logger. A message is written with the
+ * << operators of std::ostream into a buffer that each thread reuses, and is logged when
+ * the expression ends. When the level is disabled, the operands are not evaluated at all.
+ *
+ * Usage:
+ * Use the LOGIFY_STREAM_* macros with a Logger:
+ *
+ * ```cpp
+ * LOGIFY_STREAM_INFO(logger) << "x=" << x << ", ratio=" << ratio;
+ * ```
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include "Logify/Logify_export.h"
+#include "Logify/Logger.h"
+#include <memory>
+#include <ostream>
+
+// Macro to log a stream-style message at a given level; the operands are only evaluated if the level is enabled
+#define LOGIFY_STREAM(logger, level) \
+    !(logger).isEnabled(level) ? Logify::LogStream::countFiltered((logger), (level)) \
+                               : Logify::LogStream::Voidify() & Logify::LogStream((logger), (level)).stream()
+
+// Macros to log a stream-style message at a fixed level
+#define LOGIFY_STREAM_TRACE(logger) LOGIFY_STREAM(logger, Logify::LogLevel::TRACE)
+#define LOGIFY_STREAM_DEBUG(logger) LOGIFY_STREAM(logger, Logify::LogLevel::DEBUG)
+#define LOGIFY_STREAM_INFO(logger) LOGIFY_STREAM(logger, Logify::LogLevel::INFO)
+#define LOGIFY_STREAM_WARN(logger) LOGIFY_STREAM(logger, Logify::LogLevel::WARN)
+#define LOGIFY_STREAM_ERROR(logger) LOGIFY_STREAM(logger, Logify::LogLevel::ERROR)
+#define LOGIFY_STREAM_FATAL(logger) LOGIFY_STREAM(logger, Logify::LogLevel::FATAL)
+
+
+namespace Logify
+{
+
+  /**
+   * @class LogStream
+   * @brief A temporary that collects one message through std::ostream and logs it when destroyed.
+   *
+   * The stream and its buffer belong to the calling thread and are reused for every message,
+   * so no stream, locale or string is constructed per message once the buffer has grown. The
+   * formatting flags of the stream are reset after each message. A message written while
+   * another one of the same thread is being collected, for example by an operator<< that
+   * logs, uses a stream of its own.
+   */
+  class LogStream
+  {
+   public:
+	  /**
+	   * @brief Constructs a LogStream, claiming the calling thread's stream.
+	   * @param logger The Logger instance the message is logged to.
+	   * @param level The severity level of the message.
+	   */
+	  LOGIFY_API LogStream(Logger& logger, LogLevel level);
+
+	  /**
+	   * @brief Logs the collected message and releases the stream for the next message.
+	   */
+	  LOGIFY_API ~LogStream();
+
+	  LogStream(const LogStream&)            = delete;
+	  LogStream& operator=(const LogStream&) = delete;
+
+	  /**
+	   * @brief Retrieves the stream collecting the message.
+	   */
+	  std::ostream& stream()
+	  {
+		  return *stream_;
+	  }
+
+	  /**
+	   * @brief Counts a message that was skipped because its level is disabled.
+	   * @param logger The Logger instance the message was meant for.
+	   * @param level The severity level of the message.
+	   */
+	  LOGIFY_API static void countFiltered(Logger& logger, LogLevel level);
+
+	  /**
+	   * @struct Voidify
+	   * @brief Turns a stream expression into void, so both branches of the macros' conditional match.
+	   *
+	   * The & operator binds more loosely than <<, so it applies to the finished expression.
+	   */
+	  struct Voidify
+	  {
+		  void operator&(std::ostream&)
+		  {}
+	  };
+
+   private:
+	  struct ThreadStream;                  ///< Forward declaration of the per-thread stream.
+
+	  Logger&                       logger_;  ///< The Logger the message is logged to.
+	  LogLevel                      level_;   ///< The severity level of the message.
+	  ThreadStream*                 state_;   ///< The stream in use, the thread's or owned_.
+	  std::unique_ptr<ThreadStream> owned_;   ///< A stream of its own, if the thread's was in use.
+	  std::ostream*                 stream_;  ///< The std::ostream of state_.
+  };
+
+} // namespace Logify
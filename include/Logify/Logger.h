@@ -23,13 +23,30 @@
 
 #include "Logify/Logify_export.h"
 #include "Logify/ColorScheme.h"
+#include "Logify/Field.h"
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <initializer_list>
 #include <string>
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 namespace Logify
 {
 
+  /**
+   * @brief A callable that produces a log message: either it returns the message (anything a
+   * std::string can be constructed from), or it appends the message to the std::string& it is given.
+   */
+  template<typename F>
+  concept MessageProducer = std::invocable<F&, std::string&>
+	  || (std::invocable<F&> && std::constructible_from<std::string, std::invoke_result_t<F&>>);
+
   /**
    * @enum LogLevel
    * @brief Enumeration representing the severity levels for logging.
@@ -44,6 +61,141 @@ namespace Logify
 	  FATAL = 5
   };
 
+  /**
+   * @enum ConsoleTarget
+   * @brief Enumeration representing the console streams a Logger can write to.
+   */
+  enum class ConsoleTarget
+  {
+	  StdOut,  ///< Standard output (file descriptor 1).
+	  StdErr   ///< Standard error (file descriptor 2).
+  };
+
+  /**
+   * @enum TimeZone
+   * @brief The time zone in which the timestamps of log messages are written.
+   */
+  enum class TimeZone
+  {
+	  Local,  ///< The local time zone of the system, including daylight saving time.
+	  UTC     ///< Coordinated Universal Time.
+  };
+
+  /**
+   * @enum OverflowPolicy
+   * @brief What an asynchronous Logger does with a new message when its queue is full.
+   */
+  enum class OverflowPolicy
+  {
+	  Block,            ///< The logging thread waits until the queue has room.
+	  DropNewest,       ///< The new message is dropped.
+	  OverwriteOldest,  ///< The oldest queued message is dropped to make room for the new one.
+	  DropBelowLevel    ///< Messages below a given level are dropped; the others (always ERROR and FATAL) wait.
+  };
+
+  /**
+   * @enum RotationInterval
+   * @brief When a log file is rotated to a new file besides reaching its maximum size.
+   */
+  enum class RotationInterval
+  {
+	  None,    ///< Files are only rotated by size.
+	  Hourly,  ///< A new file is started every hour of local time, e.g. "app_2026-10-18_13_0000.log".
+	  Daily    ///< A new file is started every day at local midnight, e.g. "app_2026-10-18_0000.log".
+  };
+
+  /**
+   * @struct FileStreamOptions
+   * @brief The settings of a log file added with Logger::addFileStream().
+   *
+   * The retention limits apply to the rotated files of the stream (e.g. "app_0000.log",
+   * "app_0001.log", ... for "app.log"), across all time periods. A limit of zero means no
+   * limit. The file being written is never deleted.
+   *
+   * With preallocate set, disk space is reserved ahead of the data in chunks of that size, up to
+   * maxFileSize, with fallocate(FALLOC_FL_KEEP_SIZE). This reduces file system metadata updates and
+   * fragmentation; the unused space is released when the file is closed or rotated. It has no
+   * effect on other systems or on file systems that do not support it.
+   *
+   * With indexInterval set, a sparse time index is written next to each file ("app_0000.log.idx"),
+   * with an entry for every part of at least that many bytes, giving the earliest and latest time
+   * of its records. The logify-query tool uses it to read only the parts of the files within a
+   * time range, including older records written after newer ones.
+   */
+  struct FileStreamOptions
+  {
+	  std::size_t          maxFileSize   = 10 * 1024 * 1024;        ///< The file size at which the file is rotated.
+	  ColorScheme          scheme        = DefaultDarkScheme;       ///< The color scheme of HTML files.
+	  LogLevel             minLevel      = LogLevel::TRACE;         ///< The lowest level of the messages written.
+	  RotationInterval     rotation      = RotationInterval::None;  ///< Rotation at wall-clock boundaries.
+	  std::size_t          preallocate   = 0;                       ///< Chunk size of disk space reserved ahead (Linux), or 0.
+	  std::size_t          indexInterval = 0;                       ///< Bytes between the entries of the time index, or 0.
+	  std::size_t          maxFiles      = 0;                       ///< The maximum number of files kept.
+	  std::uint64_t        maxTotalBytes = 0;                       ///< The maximum total size of the files kept.
+	  std::chrono::seconds maxAge{0};                               ///< Files last written longer ago are deleted.
+  };
+
+  /**
+   * @enum NetworkFormat
+   * @brief The format of the records sent by a network stream.
+   */
+  enum class NetworkFormat
+  {
+	  Text,      ///< Text lines, as written to consoles and ".log" files.
+	  JsonLines  ///< JSON objects, one per line, as written to ".jsonl" files.
+  };
+
+  /**
+   * @struct NetworkStreamOptions
+   * @brief The settings of a network stream added with Logger::addNetworkStream().
+   *
+   * Records are formatted by the logging thread and sent by a background thread of the stream.
+   * While the peer is unreachable or slower than the application, up to maxPendingBytes of
+   * formatted records are kept in memory; further records are dropped and counted as write
+   * errors. The connection is retried after minReconnectDelay, doubling the delay after each
+   * failed attempt up to maxReconnectDelay.
+   */
+  struct NetworkStreamOptions
+  {
+	  NetworkFormat             format          = NetworkFormat::Text;  ///< The format of the records.
+	  LogLevel                  minLevel        = LogLevel::TRACE;      ///< The lowest level of the messages sent.
+	  std::size_t               maxPendingBytes = 4 * 1024 * 1024;      ///< The most bytes kept while not sent.
+	  std::chrono::milliseconds minReconnectDelay{100};                 ///< The first delay before reconnecting.
+	  std::chrono::milliseconds maxReconnectDelay{5000};                ///< The longest delay before reconnecting.
+  };
+
+  /**
+   * @struct SinkStats
+   * @brief The counters of one output stream or file of a Logger.
+   */
+  struct SinkStats
+  {
+	  std::string   name;          ///< The destination, e.g. "stdout", "ostream" or the log file name.
+	  std::uint64_t bytesWritten;  ///< Number of bytes written, including color codes and markup.
+	  std::uint64_t flushes;       ///< Number of times buffered data was handed to the operating system.
+	  std::uint64_t writeErrors;   ///< Number of messages that could not be written.
+	  std::uint64_t rotations;     ///< Number of file rotations (always 0 for streams and consoles).
+  };
+
+  /**
+   * @struct LoggerStats
+   * @brief A snapshot of the counters of a Logger, returned by Logger::stats().
+   *
+   * The per-level arrays are indexed by the numeric value of LogLevel (TRACE = 0 ... FATAL = 5).
+   */
+  struct LoggerStats
+  {
+	  std::array<std::uint64_t, 6> accepted{};          ///< Messages that passed the level checks, per level; held ones once written.
+	  std::array<std::uint64_t, 6> filtered{};          ///< Messages discarded by the level checks, per level.
+	  std::array<std::uint64_t, 6> dropped{};           ///< Messages dropped because the queue was full, per level.
+	  std::uint64_t                bytesWritten   = 0;  ///< Bytes written by all current sinks.
+	  std::uint64_t                flushes        = 0;  ///< Flushes by all current sinks.
+	  std::uint64_t                writeErrors    = 0;  ///< Write errors of all current sinks.
+	  std::uint64_t                rotations      = 0;  ///< File rotations of all current sinks.
+	  std::size_t                  queueHighWater = 0;  ///< The largest number of messages queued at once.
+	  std::vector<SinkStats>       sinks;               ///< The counters of each current sink, in the order added.
+  };
+
   /**
    * @class Logger
    * @brief A customizable logging class for managing log messages and output streams.
@@ -53,6 +205,8 @@ namespace Logify
    public:
 	  /**
 	   * @brief Constructs a Logger with a specified logging level.
+	   *
+	   * If the LOGIFY_LEVEL environment variable names a level (e.g. "debug"), that level is used instead.
 	   * @param level The initial logging level. Default is LogLevel::INFO.
 	   */
 	  LOGIFY_API explicit Logger(LogLevel level = LogLevel::INFO);
@@ -69,12 +223,62 @@ namespace Logify
 	   */
 	  LOGIFY_API Logger& setLogLevel(LogLevel level);
 
+	  /**
+	   * @brief Sets the logging level from a file holding a level name, now and whenever the file is written.
+	   *
+	   * The file contains a single level name, e.g. "DEBUG". It may be written in place or replaced by
+	   * renaming another file over it; on Linux the change applies at once through inotify, elsewhere
+	   * within 100ms. A missing file or unknown name leaves the level unchanged. Watching another file
+	   * stops watching the previous one.
+	   * @param path The path of the file; its directory must exist.
+	   * @return A reference to the Logger object.
+	   * @throws std::runtime_error If the directory of the file cannot be watched.
+	   */
+	  LOGIFY_API Logger& watchLevelFile(const std::string& path);
+
+	  /**
+	   * @brief Stops watching the level file; the level stays as it is.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& stopWatchingLevelFile();
+
+	  /**
+	   * @brief Lets SIGUSR1 lower the logging level by one step (e.g. INFO to DEBUG) and SIGUSR2 raise it.
+	   *
+	   * Installs process-wide handlers for both signals, replacing any others. At most 64 loggers
+	   * follow the signals at a time. Does nothing on Windows, which has no such signals.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& enableLevelSignals();
+
+	  /**
+	   * @brief Stops this logger from following SIGUSR1 and SIGUSR2; the handlers stay installed.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& disableLevelSignals();
+
 	  /**
 	   * @brief Adds an output stream to the logger.
 	   * @param out The output stream to add.
+	   * @param minLevel The lowest level of the messages written to this stream. Default is LogLevel::TRACE.
 	   * @return A reference to the Logger object.
 	   */
-	  LOGIFY_API Logger& addOutputStream(std::ostream& out);
+	  LOGIFY_API Logger& addOutputStream(std::ostream& out, LogLevel minLevel = LogLevel::TRACE);
+
+	  /**
+	   * @brief Adds a console output to the logger.
+	   *
+	   * The console is written directly through its file descriptor, with one write call per
+	   * message. Colors are only used if the console is a terminal, which is checked once here;
+	   * output redirected to a file or pipe is written as plain text.
+	   * @param target The console stream to write to. Default is ConsoleTarget::StdOut.
+	   * @param minLevel The lowest level of the messages written to the console. Default is LogLevel::TRACE.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& addConsoleStream(
+		  ConsoleTarget target = ConsoleTarget::StdOut,
+		  LogLevel minLevel = LogLevel::TRACE
+	  );
 
 	  /**
 	   * @brief Removes an output stream from the logger.
@@ -90,6 +294,18 @@ namespace Logify
 	   */
 	  LOGIFY_API Logger& setTimeFormat(const std::string& format);
 
+	  /**
+	   * @brief Sets the time zone of the timestamps in log messages (default is TimeZone::Local).
+	   *
+	   * Local times use the UTC offset of the system's time zone, which is looked up once per
+	   * daylight saving time period rather than per message. Changes of the TZ environment
+	   * variable after the first message are not picked up. Call during setup, before other
+	   * threads log.
+	   * @param zone The time zone.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& setTimeZone(TimeZone zone);
+
 	  /**
 	   * @brief Activates or Deactivates the indentation inside scopes (see ScopedLogger)
 	   * @param active true for activating indentation, false otherwise.
@@ -99,62 +315,388 @@ namespace Logify
 
 	  /**
 	   * @brief Adds a file stream to the logger with optional size limits and color scheme.
+	   *
+	   * The file is opened on the first message written to it, continuing the existing file with
+	   * the highest index (e.g. "app_0041.log" for "app.log"). If it cannot be opened, the messages
+	   * are counted as write errors in stats(), and opening is retried with the next message.
 	   * @param filename The name of the file to log to.
 	   * @param maxFileSize The maximum size of the log file before rotation (default is 10MB).
 	   * @param scheme The color scheme to apply (default is DefaultDarkScheme).
+	   * @param minLevel The lowest level of the messages written to the file (default is LogLevel::TRACE).
 	   * @return A reference to the Logger object.
 	   */
 	  LOGIFY_API Logger& addFileStream(
 		  const std::string& filename,
 		  std::size_t maxFileSize = 10 * 1024 * 1024,
-		  const ColorScheme& scheme = DefaultDarkScheme
+		  const ColorScheme& scheme = DefaultDarkScheme,
+		  LogLevel minLevel = LogLevel::TRACE
 	  );
 
+	  /**
+	   * @brief Adds a file stream to the logger with the given options, including retention limits.
+	   *
+	   * When the file is opened and on every rotation, a background thread of the stream deletes
+	   * the oldest rotated files beyond the limits of the options, so no logging call waits for it.
+	   * @param filename The name of the file to log to.
+	   * @param options The rotation size, color scheme, level and retention limits of the file.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& addFileStream(const std::string& filename, const FileStreamOptions& options);
+
+	  /**
+	   * @brief Adds a stream publishing the messages into a named shared memory ring, for a collector to write.
+	   *
+	   * Loggers in any number of processes may publish into the same ring without waiting for each
+	   * other; a single collector (see startCollector() and the logify-collector tool) formats the
+	   * messages and writes them to its own streams, so only that process writes and rotates the log
+	   * files. The ring is created by the first process opening it. When it is full, messages are
+	   * dropped and counted as write errors of this stream in stats(), and the collector logs how
+	   * many were dropped.
+	   * @param name The name of the shared memory segment, e.g. "myapp-logs".
+	   * @param capacity The number of 256-byte cells of the ring, if it is created here (default is 16384).
+	   * @param minLevel The lowest level of the messages published (default is LogLevel::TRACE).
+	   * @return A reference to the Logger object.
+	   * @throws std::runtime_error If the shared memory cannot be created or opened.
+	   */
+	  LOGIFY_API Logger& addSharedMemoryStream(
+		  const std::string& name,
+		  std::size_t capacity = 16384,
+		  LogLevel minLevel = LogLevel::TRACE
+	  );
+
+	  /**
+	   * @brief Adds a stream sending the messages to a log aggregator over a Unix domain socket or TCP.
+	   *
+	   * Logging threads only format the messages into memory; a background thread of the stream
+	   * connects, sends everything pending in batches of up to 64 buffers per system call, and
+	   * reconnects when the connection is lost, so a slow or unreachable peer never blocks logging.
+	   * A message that was partly sent when the connection was lost is not resent. flush() waits
+	   * until the pending messages are sent while connected, for at most a second.
+	   * @param address "unix:" followed by the path of the socket, or "tcp:" followed by host and
+	   *                port, e.g. "unix:/run/aggregator.sock" or "tcp:127.0.0.1:5140".
+	   * @param options The format, level and buffering of the stream.
+	   * @return A reference to the Logger object.
+	   * @throws std::invalid_argument If the address has neither form.
+	   */
+	  LOGIFY_API Logger& addNetworkStream(const std::string& address, const NetworkStreamOptions& options = {});
+
+	  /**
+	   * @brief Switches the logger to asynchronous mode.
+	   *
+	   * Messages are copied into a bounded queue and written to the streams by a background
+	   * thread. When the queue is full, the overflow policy decides whether the logging thread
+	   * waits or a message is dropped. Dropped messages are counted per level, and the writer
+	   * periodically logs a WARN line with the number of messages dropped since its last report.
+	   * Call during setup, before other threads log.
+	   * @param capacity The maximum number of queued messages (default is 8192).
+	   * @param policy What to do when the queue is full (default is OverflowPolicy::Block).
+	   * @param keepLevel For OverflowPolicy::DropBelowLevel, the lowest level that is never dropped.
+	   *                  ERROR and FATAL are never dropped by this policy (default is LogLevel::WARN).
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& enableAsync(
+		  std::size_t capacity = 8192,
+		  OverflowPolicy policy = OverflowPolicy::Block,
+		  LogLevel keepLevel = LogLevel::WARN
+	  );
+
+	  /**
+	   * @brief Switches the logger back to synchronous mode, after writing all queued messages.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& disableAsync();
+
+	  /**
+	   * @brief Keeps the messages filtered out by the levels in memory, to be written after an incident.
+	   *
+	   * Messages below the level of the Logger or of all its streams are copied, unformatted, into
+	   * a ring of the logging thread that keeps its last recordsPerThread messages. When a message
+	   * of dumpLevel or above is logged, or dumpFlightRecorder() is called, the kept messages of all
+	   * threads are formatted with their original timestamps and written to every stream, whatever
+	   * its minimum level, ahead of the triggering message. Call during setup, before other threads log.
+	   * @param recordsPerThread The number of messages kept per thread (default is 1024).
+	   * @param dumpLevel The lowest level of the messages that write the kept ones (default is LogLevel::ERROR).
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& enableFlightRecorder(std::size_t recordsPerThread = 1024, LogLevel dumpLevel = LogLevel::ERROR);
+
+	  /**
+	   * @brief Stops keeping filtered messages and discards the kept ones. Call before other threads log.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& disableFlightRecorder();
+
+	  /**
+	   * @brief Writes the messages kept by the flight recorder to every stream, oldest first, and forgets them.
+	   *
+	   * Does nothing if the flight recorder is not enabled or has no messages.
+	   */
+	  LOGIFY_API void dumpFlightRecorder();
+
+	  /**
+	   * @brief Holds low-level messages logged inside ScopedLogger scopes until a problem is logged in the scope.
+	   *
+	   * Messages at bufferedLevel or below, logged by a thread inside a ScopedLogger scope of this
+	   * logger, are copied into a buffer of the thread instead of being written, even if the levels
+	   * would filter them. A message at triggerLevel or above logged inside the scope first writes
+	   * the held messages to every stream, whatever its level. When the thread leaves its outermost
+	   * scope, the held messages are discarded. At most maxRecords messages are held per thread; the
+	   * oldest are overwritten. Call during setup, before other threads log.
+	   * @param bufferedLevel The highest level held; must be below triggerLevel (default is LogLevel::DEBUG).
+	   * @param triggerLevel The lowest level that writes the held messages (default is LogLevel::WARN).
+	   * @param maxRecords The number of messages held per thread (default is 4096).
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& enableScopeBuffering(
+		  LogLevel bufferedLevel = LogLevel::DEBUG,
+		  LogLevel triggerLevel = LogLevel::WARN,
+		  std::size_t maxRecords = 4096
+	  );
+
+	  /**
+	   * @brief Stops holding messages in scopes. Call when no thread is inside a scope.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& disableScopeBuffering();
+
+	  /**
+	   * @brief Starts a thread writing the messages published into a shared memory ring to this logger's streams.
+	   *
+	   * The messages keep the time, process ID and thread ID of their producer and are formatted
+	   * with this logger's time format; messages below this logger's level are skipped. Only one
+	   * collector may run per ring, and this logger must not publish into the ring it collects.
+	   * Messages still in the ring when the collector stops are written by the next one.
+	   * @param name The name of the shared memory segment.
+	   * @param capacity The number of 256-byte cells of the ring, if it is created here (default is 16384).
+	   * @return A reference to the Logger object.
+	   * @throws std::runtime_error If the shared memory cannot be created or opened.
+	   */
+	  LOGIFY_API Logger& startCollector(const std::string& name, std::size_t capacity = 16384);
+
+	  /**
+	   * @brief Stops the collector after writing the messages published so far.
+	   * @return A reference to the Logger object.
+	   */
+	  LOGIFY_API Logger& stopCollector();
+
+	  /**
+	   * @brief Blocks until all messages logged so far have been written.
+	   *
+	   * Waits for the collector and the queue of the asynchronous mode, then writes the data buffered
+	   * by the file streams.
+	   */
+	  LOGIFY_API void flush();
+
+	  /**
+	   * @brief Installs a process-wide handler that writes pending messages when the process crashes.
+	   *
+	   * On SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL or std::terminate, the messages still queued or
+	   * buffered by every live Logger are written to its files and consoles with async-signal-safe
+	   * write calls on the already open file descriptors, with UTC timestamps. The signal is then
+	   * raised again with the previous handler. Output streams (std::ostream) are not written.
+	   * Installing more than once has no effect.
+	   */
+	  LOGIFY_API static void installCrashHandler();
+
+	  /**
+	   * @brief Removes a shared memory ring; processes that have it open keep using it.
+	   *
+	   * The ring otherwise persists until the system restarts. On Windows, it disappears with the
+	   * last process using it and this does nothing.
+	   * @param name The name of the shared memory segment.
+	   */
+	  LOGIFY_API static void removeSharedMemory(const std::string& name);
+
+	  /**
+	   * @brief Retrieves the number of messages of a level dropped because the queue was full.
+	   * @param level The log level.
+	   * @return The exact number of dropped messages of this level since the Logger was created.
+	   */
+	  LOGIFY_API std::uint64_t getDroppedCount(LogLevel level) const;
+
+	  /**
+	   * @brief Retrieves a snapshot of the logger's counters.
+	   *
+	   * The counters are kept lock-free while logging; the per-level message counters are
+	   * sharded per thread and summed here. The sink counters cover the current sinks only,
+	   * so they do not include streams that have been removed.
+	   * @return The counters of the logger and of each of its sinks.
+	   */
+	  LOGIFY_API LoggerStats stats() const;
+
 	  /**
 	   * @brief Logs a message with a specified log level.
 	   * @param level The severity level of the log message.
 	   * @param message The message to log.
+	   * @param fields Optional typed key/value fields, rendered by each output stream that writes the message.
+	   */
+	  LOGIFY_API void log(LogLevel level, const std::string& message, std::initializer_list<Field> fields = {});
+
+	  /**
+	   * @brief Checks whether a message of a level would be written or kept, without taking any lock.
+	   *
+	   * True if the level passes the Logger's level and the lowest level of its streams, or if the
+	   * message would be kept by the flight recorder or held in a scope of the calling thread.
+	   * @param level The log level to check.
+	   * @return True if logging a message of this level has any effect besides the statistics.
+	   */
+	  [[nodiscard]] LOGIFY_API bool isEnabled(LogLevel level) const;
+
+	  /**
+	   * @brief Logs a message built by a producer, only if a message of the level is written or kept.
+	   *
+	   * The producer is called after the level checks pass, so an expensive message costs nothing
+	   * when its level is disabled:
+	   * @code
+	   * logger.debug([&]() { return request.toJson(); });
+	   * logger.debug([&](std::string& out) { request.appendJson(out); });
+	   * @endcode
+	   * @param level The severity level of the log message.
+	   * @param producer A callable returning the message, or appending it to a std::string&.
+	   * @param fields Optional typed key/value fields.
 	   */
-	  LOGIFY_API void log(LogLevel level, const std::string& message);
+	  template<MessageProducer F>
+	  void log(LogLevel level, F&& producer, std::initializer_list<Field> fields = {})
+	  {
+		  if (!isEnabled(level))
+		  {
+			  countFiltered(level);
+			  return;
+		  }
+
+		  if constexpr (std::invocable<F&, std::string&>)
+		  {
+			  std::string message;
+			  producer(message);
+			  log(level, message, fields);
+		  }
+		  else
+		  {
+			  log(level, std::string(producer()), fields);
+		  }
+	  }
 
 	  /**
 	   * @brief Logs a TRACE level message.
 	   * @param message The message to log.
+	   * @param fields Optional typed key/value fields.
 	   */
-	  LOGIFY_API void trace(const std::string& message);
+	  LOGIFY_API void trace(const std::string& message, std::initializer_list<Field> fields = {});
 
 	  /**
 	   * @brief Logs a DEBUG level message.
 	   * @param message The message to log.
+	   * @param fields Optional typed key/value fields.
 	   */
-	  LOGIFY_API void debug(const std::string& message);
+	  LOGIFY_API void debug(const std::string& message, std::initializer_list<Field> fields = {});
 
 	  /**
 	   * @brief Logs an INFO level message.
 	   * @param message The message to log.
+	   * @param fields Optional typed key/value fields.
 	   */
-	  LOGIFY_API void info(const std::string& message);
+	  LOGIFY_API void info(const std::string& message, std::initializer_list<Field> fields = {});
 
 	  /**
 	   * @brief Logs a WARN level message.
 	   * @param message The message to log.
+	   * @param fields Optional typed key/value fields.
 	   */
-	  LOGIFY_API void warn(const std::string& message);
+	  LOGIFY_API void warn(const std::string& message, std::initializer_list<Field> fields = {});
 
 	  /**
 	   * @brief Logs an ERROR level message.
 	   * @param message The message to log.
+	   * @param fields Optional typed key/value fields.
 	   */
-	  LOGIFY_API void error(const std::string& message);
+	  LOGIFY_API void error(const std::string& message, std::initializer_list<Field> fields = {});
 
 	  /**
 	   * @brief Logs a FATAL level message.
+	   *
+	   * Before returning, all messages logged so far (including this one) are written to the sinks,
+	   * as with flush(). This applies to every FATAL message, also when logged with log().
 	   * @param message The message to log.
+	   * @param fields Optional typed key/value fields.
+	   */
+	  LOGIFY_API void fatal(const std::string& message, std::initializer_list<Field> fields = {});
+
+	  /**
+	   * @brief Logs a TRACE level message built by a producer, only if it is written or kept.
+	   * @param producer A callable returning the message, or appending it to a std::string&.
+	   * @param fields Optional typed key/value fields.
+	   */
+	  template<MessageProducer F>
+	  void trace(F&& producer, std::initializer_list<Field> fields = {})
+	  {
+		  log(LogLevel::TRACE, std::forward<F>(producer), fields);
+	  }
+
+	  /**
+	   * @brief Logs a DEBUG level message built by a producer, only if it is written or kept.
+	   * @param producer A callable returning the message, or appending it to a std::string&.
+	   * @param fields Optional typed key/value fields.
+	   */
+	  template<MessageProducer F>
+	  void debug(F&& producer, std::initializer_list<Field> fields = {})
+	  {
+		  log(LogLevel::DEBUG, std::forward<F>(producer), fields);
+	  }
+
+	  /**
+	   * @brief Logs an INFO level message built by a producer, only if it is written or kept.
+	   * @param producer A callable returning the message, or appending it to a std::string&.
+	   * @param fields Optional typed key/value fields.
+	   */
+	  template<MessageProducer F>
+	  void info(F&& producer, std::initializer_list<Field> fields = {})
+	  {
+		  log(LogLevel::INFO, std::forward<F>(producer), fields);
+	  }
+
+	  /**
+	   * @brief Logs a WARN level message built by a producer, only if it is written or kept.
+	   * @param producer A callable returning the message, or appending it to a std::string&.
+	   * @param fields Optional typed key/value fields.
+	   */
+	  template<MessageProducer F>
+	  void warn(F&& producer, std::initializer_list<Field> fields = {})
+	  {
+		  log(LogLevel::WARN, std::forward<F>(producer), fields);
+	  }
+
+	  /**
+	   * @brief Logs an ERROR level message built by a producer, only if it is written or kept.
+	   * @param producer A callable returning the message, or appending it to a std::string&.
+	   * @param fields Optional typed key/value fields.
+	   */
+	  template<MessageProducer F>
+	  void error(F&& producer, std::initializer_list<Field> fields = {})
+	  {
+		  log(LogLevel::ERROR, std::forward<F>(producer), fields);
+	  }
+
+	  /**
+	   * @brief Logs a FATAL level message built by a producer, only if it is written or kept.
+	   * @param producer A callable returning the message, or appending it to a std::string&.
+	   * @param fields Optional typed key/value fields.
+	   */
+	  template<MessageProducer F>
+	  void fatal(F&& producer, std::initializer_list<Field> fields = {})
+	  {
+		  log(LogLevel::FATAL, std::forward<F>(producer), fields);
+	  }
+
+   private:
+	  /**
+	   * @brief Counts a message whose producer was not called because its level is disabled.
+	   * @param level The log level of the message.
 	   */
-	  LOGIFY_API void fatal(const std::string& message);
+	  LOGIFY_API void countFiltered(LogLevel level);
 
    private:
 	  friend class ScopedLogger;
+	  friend class LogStream;
 	  class Impl;                    ///< Forward declaration of the implementation class.
 	  std::unique_ptr<Impl> pImpl_;  ///< Pointer to the implementation class.
   };
@@ -0,0 +1,192 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <atomic>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+  // A stream buffer that blocks the first write until it is opened, to saturate the queue on demand.
+  class GateBuffer : public std::stringbuf
+  {
+   public:
+	  void open()
+	  {
+		  gate_.set_value();
+	  }
+
+	  void waitUntilBlocked() const
+	  {
+		  while (!blocked_.load()) std::this_thread::yield();
+	  }
+
+   protected:
+	  std::streamsize xsputn(const char* s, std::streamsize n) override
+	  {
+		  if (!blocked_.exchange(true)) opened_.wait();
+		  return std::stringbuf::xsputn(s, n);
+	  }
+
+	  int overflow(int c) override
+	  {
+		  if (!blocked_.exchange(true)) opened_.wait();
+		  return std::stringbuf::overflow(c);
+	  }
+
+   private:
+	  std::promise<void>       gate_;
+	  std::shared_future<void> opened_ = gate_.get_future().share();
+	  std::atomic<bool>        blocked_{false};
+  };
+}
+
+
+TEST_CASE("Logify Asynchronous Logging", "[Async]")
+{
+	using namespace Logify;
+
+	SECTION("Queued messages are written in order")
+	{
+		std::stringstream logStream;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(logStream);
+		logger.enableAsync(64);
+
+		for (int i = 0; i < 1000; ++i) logger.info("message " + std::to_string(i), {{"i", i}});
+		logger.flush();
+
+		std::string output = logStream.str();
+		REQUIRE(output.find("[INFO ]: message 0 i=0\n") != std::string::npos);
+		REQUIRE(output.find("[INFO ]: message 999 i=999\n") != std::string::npos);
+		REQUIRE(output.find("message 10 ") < output.find("message 11 "));
+		REQUIRE(logger.getDroppedCount(LogLevel::INFO) == 0);
+	}
+
+	SECTION("DropNewest drops and reports new messages when the queue is full")
+	{
+		GateBuffer   buffer;
+		std::ostream stream(&buffer);
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addOutputStream(stream);
+			logger.enableAsync(4, OverflowPolicy::DropNewest);
+
+			logger.info("blocking");
+			buffer.waitUntilBlocked();
+
+			for (int i = 0; i < 10; ++i) logger.info("message " + std::to_string(i));
+			REQUIRE(logger.getDroppedCount(LogLevel::INFO) == 6);
+
+			buffer.open();
+		}
+
+		std::string output = buffer.str();
+		REQUIRE(output.find("message 3\n") != std::string::npos);
+		REQUIRE(output.find("message 4\n") == std::string::npos);
+		REQUIRE(output.find("[WARN ]: Dropped 6 log records because the queue was full dropped=6") != std::string::npos);
+	}
+
+	SECTION("OverwriteOldest keeps the newest messages")
+	{
+		GateBuffer   buffer;
+		std::ostream stream(&buffer);
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addOutputStream(stream);
+			logger.enableAsync(4, OverflowPolicy::OverwriteOldest);
+
+			logger.info("blocking");
+			buffer.waitUntilBlocked();
+
+			for (int i = 0; i < 10; ++i) logger.info("message " + std::to_string(i));
+			REQUIRE(logger.getDroppedCount(LogLevel::INFO) == 6);
+
+			buffer.open();
+			logger.flush();
+		}
+
+		std::string output = buffer.str();
+		REQUIRE(output.find("message 5\n") == std::string::npos);
+		REQUIRE(output.find("message 6\n") != std::string::npos);
+		REQUIRE(output.find("message 9\n") != std::string::npos);
+	}
+
+	SECTION("DropBelowLevel drops low levels and keeps errors")
+	{
+		GateBuffer   buffer;
+		std::ostream stream(&buffer);
+
+		{
+			Logger logger(LogLevel::DEBUG);
+			logger.addOutputStream(stream);
+			logger.enableAsync(4, OverflowPolicy::DropBelowLevel, LogLevel::WARN);
+
+			logger.info("blocking");
+			buffer.waitUntilBlocked();
+
+			for (int i = 0; i < 4; ++i) logger.info("fill " + std::to_string(i));
+			logger.debug("dropped debug");
+			logger.info("dropped info");
+
+			// An error waits for room instead of being dropped.
+			std::thread producer([&logger]() { logger.error("kept error"); });
+			buffer.open();
+			producer.join();
+
+			REQUIRE(logger.getDroppedCount(LogLevel::DEBUG) == 1);
+			REQUIRE(logger.getDroppedCount(LogLevel::INFO) == 1);
+			REQUIRE(logger.getDroppedCount(LogLevel::ERROR) == 0);
+		}
+
+		std::string output = buffer.str();
+		REQUIRE(output.find("[ERROR]: kept error") != std::string::npos);
+		REQUIRE(output.find("dropped debug") == std::string::npos);
+		REQUIRE(output.find("dropped=2 trace=0 debug=1 info=1 warn=0 error=0 fatal=0") != std::string::npos);
+	}
+
+	SECTION("Messages larger than a slot are written intact")
+	{
+		std::stringstream logStream;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(logStream);
+		logger.enableAsync(16);
+
+		// Sizes around the inline storage of a slot, up to messages larger than an arena chunk.
+		std::vector<std::size_t> sizes{10, 150, 191, 192, 193, 1000, 20000, 100000};
+		auto                     writeAll = [&logger, &sizes](char c) {
+			for (int round = 0; round < 50; ++round)
+			{
+				for (std::size_t size : sizes)
+				{
+					logger.info(std::string(size, c), {{"size", size}, {"tag", std::string(size / 2, 'k')}});
+				}
+			}
+		};
+		std::thread other(writeAll, 'b');
+		writeAll('a');
+		other.join();
+		logger.flush();
+
+		std::string output = logStream.str();
+		for (char c : {'a', 'b'})
+		{
+			for (std::size_t size : sizes)
+			{
+				std::string line = "]: " + std::string(size, c) + " size=" + std::to_string(size)
+					+ " tag=" + std::string(size / 2, 'k') + "\n";
+				std::size_t count = 0;
+				for (std::size_t pos = output.find(line); pos != std::string::npos; pos = output.find(line, pos + 1))
+				{
+					++count;
+				}
+				REQUIRE(count == 50);
+			}
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include "TestUtils.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+  // A stream buffer whose first write never returns, to keep records in the queue until the crash.
+  class StuckBuffer : public std::stringbuf
+  {
+   public:
+	  void waitUntilStuck() const
+	  {
+		  while (!stuck_.load()) std::this_thread::yield();
+	  }
+
+   protected:
+	  std::streamsize xsputn(const char*, std::streamsize) override
+	  {
+		  stuck_.store(true);
+		  while (true) std::this_thread::sleep_for(std::chrono::seconds(1));
+	  }
+
+	  int overflow(int) override
+	  {
+		  stuck_.store(true);
+		  while (true) std::this_thread::sleep_for(std::chrono::seconds(1));
+	  }
+
+   private:
+	  std::atomic<bool> stuck_{false};
+  };
+}
+
+
+TEST_CASE("Logify Crash Handling", "[Crash]")
+{
+	using namespace Logify;
+
+	SECTION("FATAL messages flush buffered file entries before returning")
+	{
+		auto directory = makeTestDirectory("fatal_flush");
+
+		Logger logger(LogLevel::INFO);
+		logger.addFileStream((directory / "app.html").string());
+		logger.info("Buffered row.");
+		logger.fatal("Last words.");
+
+		// The logger is still alive, so nothing was written by its destruction.
+		std::string content = readFile(directory / "app_0000.html");
+		REQUIRE(content.find("Buffered row.") != std::string::npos);
+		REQUIRE(content.find("Last words.") != std::string::npos);
+	}
+
+#ifndef _WIN32
+	SECTION("Queued records are written to the files when the process aborts")
+	{
+		auto directory = makeTestDirectory("crash_drain");
+
+		pid_t child = fork();
+		REQUIRE(child >= 0);
+		if (child == 0)
+		{
+			// Let the process die with the default action after the crash handler, not the test framework's.
+			std::signal(SIGABRT, SIG_DFL);
+			Logger::installCrashHandler();
+
+			StuckBuffer  stuck;
+			std::ostream stuckStream(&stuck);
+
+			Logger logger(LogLevel::INFO);
+			logger.addOutputStream(stuckStream, LogLevel::WARN);
+			logger.addFileStream((directory / "app.log").string());
+			logger.addFileStream((directory / "app.jsonl").string());
+			logger.addFileStream((directory / "app.html").string());
+			logger.enableAsync(64);
+
+			// The first message opens the files; the writer gets stuck on the WARN message.
+			logger.info("opened");
+			logger.warn("stuck");
+			for (int i = 0; i < 10; ++i) logger.info("queued " + std::to_string(i), {{"index", i}});
+			stuck.waitUntilStuck();
+			std::abort();
+		}
+
+		int status = 0;
+		waitpid(child, &status, 0);
+		REQUIRE(WIFSIGNALED(status));
+		REQUIRE(WTERMSIG(status) == SIGABRT);
+
+		std::string text  = readFile(directory / "app_0000.log");
+		std::string jsonl = readFile(directory / "app_0000.jsonl");
+		std::string html  = readFile(directory / "app_0000.html");
+		REQUIRE(html.ends_with("</table></body></html>"));
+		REQUIRE(html.find("</table></body></html>") == html.size() - 22);
+		REQUIRE(text.find("[WARN ] stuck\n") != std::string::npos);
+		for (int i = 0; i < 10; ++i)
+		{
+			std::string index = std::to_string(i);
+			REQUIRE(text.find("[INFO ] queued " + index + " index=" + index + "\n") != std::string::npos);
+			REQUIRE(jsonl.find("\"message\":\"queued " + index + "\",\"fields\":{\"index\":" + index + "}}\n")
+				!= std::string::npos);
+			REQUIRE(html.find(">queued " + index + "</td>") != std::string::npos);
+		}
+	}
+#endif
+}
@@ -0,0 +1,601 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <Logify/ScopedLogger.h>
+#include "TestUtils.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#endif
+
+
+TEST_CASE("Logify FileStream formatting", "[FileStream]")
+{
+	using namespace Logify;
+
+	SECTION("HTML files escape special characters in messages")
+	{
+		auto directory = makeTestDirectory("html_escape");
+
+		// Long enough to cross several vector widths, with specials at varying offsets.
+		std::string payload;
+		for (int i = 0; i < 40; ++i) payload += std::string(i % 7, 'x') + "<&>\"'";
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.html").string());
+			logger.info(payload);
+			logger.info("first line\nsecond line");
+		}
+
+		std::string content = readFile(directory / "app_0000.html");
+
+		std::string expected;
+		for (int i = 0; i < 40; ++i) expected += std::string(i % 7, 'x') + "&lt;&amp;&gt;&quot;&#39;";
+
+		REQUIRE(content.find(expected) != std::string::npos);
+		REQUIRE(content.find("first line<br>second line") != std::string::npos);
+		REQUIRE(content.find(payload) == std::string::npos);
+	}
+
+	SECTION("LOG files indent every line of a multi-line message")
+	{
+		auto directory = makeTestDirectory("log_indent");
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.setIndentation(true);
+			logger.addFileStream((directory / "app.log").string());
+
+			ScopedLogger scope(logger, "Scope");
+			logger.info("line one\nline two\nline three");
+		}
+
+		std::string content = readFile(directory / "app_0000.log");
+		REQUIRE(content.find("  line one\n  line two\n  line three\n") != std::string::npos);
+	}
+
+	SECTION("JSONL files write one JSON object per message")
+	{
+		auto directory = makeTestDirectory("jsonl");
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.jsonl").string());
+			logger.info("plain message");
+			logger.warn("quote \" backslash \\ newline \n tab \t bell \a");
+		}
+
+		std::string content = readFile(directory / "app_0000.jsonl");
+
+		std::istringstream lines(content);
+		std::string        first, second, rest;
+		REQUIRE(std::getline(lines, first));
+		REQUIRE(std::getline(lines, second));
+		REQUIRE_FALSE(std::getline(lines, rest));
+
+		REQUIRE(first.rfind("{\"ts\":", 0) == 0);
+		REQUIRE(first.find(",\"pid\":") != std::string::npos);
+		REQUIRE(first.find(",\"tid\":") != std::string::npos);
+		REQUIRE(first.find(",\"level\":\"INFO\",\"message\":\"plain message\"}") != std::string::npos);
+		REQUIRE(second.find(R"("level":"WARN","message":"quote \" backslash \\ newline \n tab \t bell \u0007"})")
+					!= std::string::npos);
+	}
+
+	SECTION("Timestamps are the wall-clock time of the log call, even when written later")
+	{
+		auto directory = makeTestDirectory("ticks");
+		auto nowNs     = []() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::system_clock::now().time_since_epoch()
+			).count();
+		};
+
+		std::int64_t before, after;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.jsonl").string());
+			logger.enableAsync(16);
+
+			before = nowNs();
+			logger.info("queued");
+			after = nowNs();
+
+			// The record is converted and written well after the call.
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}
+
+		std::string  content = readFile(directory / "app_0000.jsonl");
+		std::int64_t ts      = std::stoll(content.substr(std::string("{\"ts\":").size()));
+		REQUIRE(ts >= before - 1000000);
+		REQUIRE(ts <= after + 1000000);
+	}
+
+	SECTION("Fields are rendered in the native format of each file type")
+	{
+		auto directory = makeTestDirectory("fields");
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string());
+			logger.addFileStream((directory / "app.html").string());
+			logger.addFileStream((directory / "app.jsonl").string());
+			logger.info("order filled", {{"qty", 100}, {"px", 12.5}, {"sym", "A<B"}, {"ok", false}});
+		}
+
+		REQUIRE(readFile(directory / "app_0000.log").find("order filled qty=100 px=12.5 sym=A<B ok=false\n")
+					!= std::string::npos);
+		REQUIRE(readFile(directory / "app_0000.html").find(
+			"<td class=\"fields\"><span class=\"field-key\">qty</span>=<span class=\"field-value\">100</span> "
+		) != std::string::npos);
+		REQUIRE(readFile(directory / "app_0000.html").find("<span class=\"field-value\">A&lt;B</span>")
+					!= std::string::npos);
+		REQUIRE(readFile(directory / "app_0000.jsonl").find(
+			R"("message":"order filled","fields":{"qty":100,"px":12.5,"sym":"A<B","ok":false}})"
+		) != std::string::npos);
+	}
+}
+
+
+TEST_CASE("Logify FileStream startup", "[FileStream]")
+{
+	using namespace Logify;
+
+	SECTION("No file is created before the first message")
+	{
+		auto directory = makeTestDirectory("lazy_open");
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.html").string());
+			REQUIRE(std::filesystem::is_empty(directory));
+		}
+
+		REQUIRE(std::filesystem::is_empty(directory));
+	}
+
+	SECTION("Logging continues with the highest existing index")
+	{
+		auto directory = makeTestDirectory("highest_index");
+
+		// Old segments, with a gap and files of other streams in between.
+		for (int index : {0, 1, 2, 7, 41})
+		{
+			std::ofstream((directory / ("app_" + std::string(index < 10 ? "000" : "00") + std::to_string(index) + ".log")))
+				<< "old\n";
+		}
+		std::ofstream(directory / "app_0099.html") << "other stream\n";
+		std::ofstream(directory / "app_backup.log") << "not a segment\n";
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string());
+			logger.info("Continued.");
+		}
+
+		std::string content = readFile(directory / "app_0041.log");
+		REQUIRE(content.find("old\n") == 0);
+		REQUIRE(content.find("Continued.") != std::string::npos);
+		REQUIRE(!std::filesystem::exists(directory / "app_0042.log"));
+	}
+
+	SECTION("A full last segment is rotated on the first message")
+	{
+		auto directory = makeTestDirectory("full_segment");
+		std::ofstream(directory / "app_0003.log") << std::string(300, 'x');
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), 256);
+			logger.info("Rotated.");
+		}
+
+		REQUIRE(readFile(directory / "app_0003.log") == std::string(300, 'x'));
+		REQUIRE(readFile(directory / "app_0004.log").find("Rotated.") != std::string::npos);
+	}
+
+	SECTION("HTML files are complete documents after every flush and are continued on restart")
+	{
+		auto directory = makeTestDirectory("html_footer");
+		auto path      = directory / "app_0000.html";
+		auto countOf   = [](const std::string& text, const std::string& part) {
+			int count = 0;
+			for (auto pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1)) ++count;
+			return count;
+		};
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.html").string());
+			logger.info("First session.");
+			logger.flush();
+
+			// The logger is still alive, yet the file already ends with the closing tags.
+			std::string content = readFile(path);
+			REQUIRE(content.ends_with("</table></body></html>"));
+			REQUIRE(content.find("First session.") != std::string::npos);
+
+			logger.info("Second batch.");
+		}
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.html").string());
+			logger.info("Second session.");
+		}
+
+		// Both sessions are in the same file, which has a single header and a single footer.
+		std::string content = readFile(path);
+		REQUIRE(std::filesystem::is_regular_file(path));
+		REQUIRE(!std::filesystem::exists(directory / "app_0001.html"));
+		REQUIRE(content.ends_with("</table></body></html>"));
+		REQUIRE(countOf(content, "<!DOCTYPE html>") == 1);
+		REQUIRE(countOf(content, "</table></body></html>") == 1);
+		REQUIRE(content.find("First session.") < content.find("Second batch."));
+		REQUIRE(content.find("Second batch.") < content.find("Second session."));
+	}
+
+	SECTION("HTML files without the closing tags or the fields column are not continued")
+	{
+		auto directory = makeTestDirectory("html_unclean");
+		auto path      = directory / "app_0000.html";
+
+		// A file of a process that crashed before writing the closing tags.
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.html").string());
+			logger.info("Before the crash.");
+		}
+		std::string written = readFile(path);
+		std::filesystem::resize_file(path, written.size() - std::string("</table></body></html>").size());
+		std::string unclean = readFile(path);
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.html").string());
+			logger.info("After the restart.");
+		}
+
+		// The file is left as it is, and the next index holds the new messages.
+		REQUIRE(readFile(path) == unclean);
+		REQUIRE(readFile(directory / "app_0001.html").find("After the restart.") != std::string::npos);
+
+		// A complete file with the four columns of older versions.
+		std::string older = "<!DOCTYPE html><html><body><table>\n<tr><th class=\"message\">Message</th></tr>\n"
+			"<tr><td>Old row.</td></tr>\n</table></body></html>";
+		std::ofstream(directory / "app_0002.html", std::ios::binary) << older;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.html").string());
+			logger.info("Newer version.");
+		}
+
+		REQUIRE(readFile(directory / "app_0002.html") == older);
+		std::string next = readFile(directory / "app_0003.html");
+		REQUIRE(next.find("Newer version.") != std::string::npos);
+		REQUIRE(next.ends_with("</table></body></html>"));
+	}
+}
+
+
+TEST_CASE("Logify FileStream retention", "[FileStream]")
+{
+	using namespace Logify;
+
+	// Counts the segments of "app.log" in a directory and sums their sizes.
+	auto countSegments = [](const std::filesystem::path& directory, std::uintmax_t* totalSize = nullptr) {
+		int count = 0;
+		if (totalSize != nullptr) *totalSize = 0;
+		for (const auto& entry : std::filesystem::directory_iterator(directory))
+		{
+			std::string name = entry.path().filename().string();
+			if (!name.starts_with("app_") || !name.ends_with(".log")) continue;
+			++count;
+			if (totalSize != nullptr) *totalSize += entry.file_size();
+		}
+		return count;
+	};
+
+	SECTION("The number of files is limited")
+	{
+		auto directory = makeTestDirectory("retention_files");
+
+		FileStreamOptions options;
+		options.maxFileSize = 256;
+		options.maxFiles    = 3;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			for (int i = 0; i < 40; ++i) logger.info("A message long enough to fill the small files quickly.");
+		}
+
+		// The newest files are kept, including the last one written.
+		REQUIRE(countSegments(directory) == 3);
+		REQUIRE(!std::filesystem::exists(directory / "app_0000.log"));
+	}
+
+	SECTION("The total size of the files is limited")
+	{
+		auto directory = makeTestDirectory("retention_bytes");
+
+		FileStreamOptions options;
+		options.maxFileSize   = 256;
+		options.maxTotalBytes = 1024;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			for (int i = 0; i < 40; ++i) logger.info("A message long enough to fill the small files quickly.");
+		}
+
+		std::uintmax_t totalSize = 0;
+		REQUIRE(countSegments(directory, &totalSize) >= 2);
+		REQUIRE(totalSize <= 1024 + 256);
+	}
+
+	SECTION("Old files are deleted when the file is opened")
+	{
+		auto directory = makeTestDirectory("retention_age");
+		for (const char* name : {"app_0000.log", "app_0001.log", "app_0002.log"})
+		{
+			std::ofstream(directory / name) << "old\n";
+			std::filesystem::last_write_time(
+				directory / name,
+				std::filesystem::file_time_type::clock::now() - std::chrono::hours(2)
+			);
+		}
+
+		FileStreamOptions options;
+		options.maxAge = std::chrono::hours(1);
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			logger.info("Continued.");
+		}
+
+		// The file being written is kept, even though it was old when it was opened.
+		REQUIRE(countSegments(directory) == 1);
+		REQUIRE(readFile(directory / "app_0002.log").find("Continued.") != std::string::npos);
+	}
+}
+
+
+TEST_CASE("Logify FileStream time rotation", "[FileStream]")
+{
+	using namespace Logify;
+
+	// Formats the current local time as the period of a file name.
+	auto currentPeriod = [](const char* format) {
+		std::time_t now = std::time(nullptr);
+		char        name[32];
+		std::strftime(name, sizeof(name), format, std::localtime(&now));
+		return std::string(name);
+	};
+
+	SECTION("Daily files carry the date in their name")
+	{
+		auto directory = makeTestDirectory("daily_rotation");
+
+		FileStreamOptions options;
+		options.rotation = RotationInterval::Daily;
+
+		std::string before = currentPeriod("%Y-%m-%d");
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			logger.info("Dated.");
+		}
+		std::string after = currentPeriod("%Y-%m-%d");
+
+		bool found = std::filesystem::exists(directory / ("app_" + before + "_0000.log"))
+			|| std::filesystem::exists(directory / ("app_" + after + "_0000.log"));
+		REQUIRE(found);
+	}
+
+	SECTION("Hourly files continue the highest index of the current hour")
+	{
+		auto directory = makeTestDirectory("hourly_rotation");
+
+		std::string period = currentPeriod("%Y-%m-%d_%H");
+		std::ofstream(directory / ("app_" + period + "_0002.log")) << "earlier\n";
+		std::ofstream(directory / "app_2000-01-01_00_0007.log") << "other hour\n";
+
+		FileStreamOptions options;
+		options.rotation = RotationInterval::Hourly;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			logger.info("Continued.");
+		}
+
+		// Skip the check if the hour changed while logging.
+		if (period == currentPeriod("%Y-%m-%d_%H"))
+		{
+			REQUIRE(readFile(directory / ("app_" + period + "_0002.log")).find("Continued.") != std::string::npos);
+		}
+	}
+
+	SECTION("Retention orders files by period, then by index")
+	{
+		auto directory = makeTestDirectory("period_retention");
+		std::ofstream(directory / "app_2000-01-01_0005.log") << "oldest\n";
+		std::ofstream(directory / "app_2000-01-02_0000.log") << "older\n";
+		std::ofstream(directory / "app_2000-01-02_0001.log") << "old\n";
+
+		FileStreamOptions options;
+		options.rotation = RotationInterval::Daily;
+		options.maxFiles = 2;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			logger.info("Today.");
+		}
+
+		REQUIRE(!std::filesystem::exists(directory / "app_2000-01-01_0005.log"));
+		REQUIRE(!std::filesystem::exists(directory / "app_2000-01-02_0000.log"));
+		REQUIRE(std::filesystem::exists(directory / "app_2000-01-02_0001.log"));
+	}
+
+	SECTION("Retention leaves the files of a stream whose name extends the base name")
+	{
+		auto directory = makeTestDirectory("sibling_retention");
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app_2.log").string());
+			logger.info("Other stream.");
+		}
+		REQUIRE(std::filesystem::exists(directory / "app_2_0000.log"));
+
+		FileStreamOptions options;
+		options.rotation = RotationInterval::Daily;
+		options.maxFiles = 1;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			logger.info("Today.");
+		}
+
+		REQUIRE(std::filesystem::exists(directory / "app_2_0000.log"));
+		REQUIRE(readFile(directory / "app_2_0000.log").find("Other stream.") != std::string::npos);
+	}
+}
+
+
+TEST_CASE("Logify FileStream time index", "[FileStream]")
+{
+	using namespace Logify;
+
+	SECTION("Index entries cover the records in parts of at least the interval")
+	{
+		auto directory = makeTestDirectory("time_index");
+
+		FileStreamOptions options;
+		options.indexInterval = 512;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			for (int i = 0; i < 100; ++i) logger.info("Indexed message " + std::to_string(i));
+		}
+
+		// The entries are the earliest and latest 64-bit nanoseconds, then the begin and end offsets.
+		std::string content = readFile(directory / "app_0000.log");
+		std::string index   = readFile(directory / "app_0000.log.idx");
+		REQUIRE(index.size() % 32 == 0);
+		REQUIRE(index.size() / 32 >= content.size() / 1024);
+
+		std::int64_t  previousLatest = 0;
+		std::uint64_t previousEnd    = 0;
+		for (std::size_t i = 0; i < index.size(); i += 32)
+		{
+			std::int64_t  earliest;
+			std::int64_t  latest;
+			std::uint64_t begin;
+			std::uint64_t end;
+			std::memcpy(&earliest, index.data() + i, sizeof(earliest));
+			std::memcpy(&latest, index.data() + i + 8, sizeof(latest));
+			std::memcpy(&begin, index.data() + i + 16, sizeof(begin));
+			std::memcpy(&end, index.data() + i + 24, sizeof(end));
+
+			// The parts follow each other from the start of the file to its end, at least one interval each but the last.
+			REQUIRE(begin == previousEnd);
+			REQUIRE(content[begin] == '[');
+			REQUIRE(content[end - 1] == '\n');
+			if (end < content.size()) REQUIRE(end - begin >= 512);
+			REQUIRE(earliest <= latest);
+			REQUIRE(earliest >= previousLatest);
+
+			previousLatest = latest;
+			previousEnd    = end;
+		}
+		REQUIRE(previousEnd == content.size());
+	}
+
+	SECTION("Dumped records are found by their time")
+	{
+		auto directory = makeTestDirectory("dump_index");
+		auto path      = directory / "app_0000.jsonl";
+
+		FileStreamOptions options;
+		options.indexInterval = 1;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.jsonl").string(), options);
+			logger.enableFlightRecorder();
+
+			logger.debug("Before the incident.");
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			for (int i = 0; i < 10; ++i) logger.info("Working " + std::to_string(i));
+			logger.error("Incident.");
+		}
+
+		// Find the time of the dumped record, written after the newer INFO records.
+		std::string   content = readFile(path);
+		std::size_t   line    = content.find("Before the incident.");
+		REQUIRE(line != std::string::npos);
+		REQUIRE(line > content.find("Working 9"));
+		line = content.rfind('\n', line) + 1;
+		std::int64_t time = std::stoll(content.substr(line + 6));
+
+		// Only the entry of the dumped record covers its time, though newer records were written before it.
+		std::string index = readFile(directory / "app_0000.jsonl.idx");
+		std::size_t found = 0;
+		for (std::size_t i = 0; i < index.size(); i += 32)
+		{
+			std::int64_t  earliest;
+			std::int64_t  latest;
+			std::uint64_t begin;
+			std::uint64_t end;
+			std::memcpy(&earliest, index.data() + i, sizeof(earliest));
+			std::memcpy(&latest, index.data() + i + 8, sizeof(latest));
+			std::memcpy(&begin, index.data() + i + 16, sizeof(begin));
+			std::memcpy(&end, index.data() + i + 24, sizeof(end));
+			if (earliest > time || latest < time) continue;
+
+			++found;
+			REQUIRE(begin == line);
+			REQUIRE(content.substr(begin, end - begin).find("Before the incident.") != std::string::npos);
+		}
+		REQUIRE(found == 1);
+	}
+}
+
+#ifdef __linux__
+TEST_CASE("Logify FileStream preallocation", "[FileStream]")
+{
+	using namespace Logify;
+
+	// The disk space allocated to a file, which may exceed its size.
+	auto allocatedBytes = [](const std::filesystem::path& path) {
+		struct stat status{};
+		stat(path.c_str(), &status);
+		return static_cast<std::uint64_t>(status.st_blocks) * 512;
+	};
+
+	SECTION("Space is reserved ahead of the data and released on close")
+	{
+		auto directory = makeTestDirectory("preallocation");
+		auto path      = directory / "app_0000.log";
+
+		FileStreamOptions options;
+		options.preallocate = 256 * 1024;
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addFileStream((directory / "app.log").string(), options);
+			logger.info("Preallocated.");
+
+			REQUIRE(std::filesystem::file_size(path) < 256);
+			REQUIRE(allocatedBytes(path) >= 256 * 1024);
+		}
+
+		REQUIRE(allocatedBytes(path) < 256 * 1024);
+		REQUIRE(readFile(path).find("Preallocated.") != std::string::npos);
+	}
+}
+#endif
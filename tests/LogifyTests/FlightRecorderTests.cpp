@@ -0,0 +1,135 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("Logify Flight Recorder", "[FlightRecorder]")
+{
+	using namespace Logify;
+
+	SECTION("Filtered messages are kept and written before an ERROR")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableFlightRecorder(4);
+
+		for (int i = 0; i < 10; ++i) logger.debug("Kept " + std::to_string(i), {{"index", i}});
+		logger.info("Written.");
+		REQUIRE(out.str().find("Kept") == std::string::npos);
+
+		logger.error("Failure.");
+		std::string text = out.str();
+
+		// Only the last four are kept, and they come before the ERROR, after the earlier messages.
+		REQUIRE(text.find("Kept 5") == std::string::npos);
+		REQUIRE(text.find("[DEBUG]: Kept 6 index=6") != std::string::npos);
+		REQUIRE(text.find("Written.") < text.find("Kept 6"));
+		REQUIRE(text.find("Kept 6") < text.find("Kept 9"));
+		REQUIRE(text.find("Kept 9") < text.find("Failure."));
+
+		// The kept messages are written only once.
+		logger.error("Second failure.");
+		text = out.str();
+		REQUIRE(text.find("Kept 9") == text.rfind("Kept 9"));
+	}
+
+	SECTION("Messages below the streams' levels are written past them on a dump")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::TRACE);
+		logger.addOutputStream(out, LogLevel::WARN);
+		logger.enableFlightRecorder(16);
+
+		logger.trace("Trace detail.");
+		logger.info("Info detail.");
+		logger.warn("Warning.");
+		REQUIRE(out.str().find("detail") == std::string::npos);
+
+		logger.dumpFlightRecorder();
+		std::string text = out.str();
+		REQUIRE(text.find("Warning.") < text.find("[TRACE]: Trace detail."));
+		REQUIRE(text.find("Trace detail.") < text.find("[INFO ]: Info detail."));
+
+		// A dump without kept messages writes nothing.
+		std::size_t size = text.size();
+		logger.dumpFlightRecorder();
+		REQUIRE(out.str().size() == size);
+	}
+
+	SECTION("The records of all threads are merged by time")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableFlightRecorder(8);
+
+		// Each thread logs after the previous one has exited; exited threads keep their records.
+		for (int t = 0; t < 3; ++t)
+		{
+			std::thread([&logger, t]() { logger.debug("Thread " + std::to_string(t)); }).join();
+		}
+		logger.debug("Main thread");
+		logger.dumpFlightRecorder();
+
+		std::string text = out.str();
+		REQUIRE(text.find("Thread 0") != std::string::npos);
+		REQUIRE(text.find("Thread 0") < text.find("Thread 1"));
+		REQUIRE(text.find("Thread 1") < text.find("Thread 2"));
+		REQUIRE(text.find("Thread 2") < text.find("Main thread"));
+	}
+
+	SECTION("Dumps keep their place in asynchronous mode")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableAsync(64);
+		logger.enableFlightRecorder(8);
+
+		logger.info("Queued.");
+		logger.debug("Kept.");
+		logger.error("Failure.");
+		logger.flush();
+
+		std::string text = out.str();
+		REQUIRE(text.find("Queued.") < text.find("Kept."));
+		REQUIRE(text.find("Kept.") < text.find("Failure."));
+	}
+
+	SECTION("Kept messages larger than a slot are written intact")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableFlightRecorder(4);
+
+		// The ring wraps many times, recycling the storage of the overwritten messages.
+		for (int i = 0; i < 200; ++i) logger.debug("Kept " + std::to_string(i) + " " + std::string(5000, 'x'));
+		logger.dumpFlightRecorder();
+
+		std::string text = out.str();
+		REQUIRE(text.find("Kept 195 ") == std::string::npos);
+		REQUIRE(text.find("Kept 196 " + std::string(5000, 'x') + "\n") != std::string::npos);
+		REQUIRE(text.find("Kept 199 " + std::string(5000, 'x') + "\n") != std::string::npos);
+	}
+
+	SECTION("Nothing is kept without the flight recorder")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableFlightRecorder(8);
+		logger.debug("Discarded.");
+		logger.disableFlightRecorder();
+
+		logger.debug("Filtered.");
+		logger.error("Failure.");
+		logger.dumpFlightRecorder();
+		REQUIRE(out.str().find("Discarded.") == std::string::npos);
+		REQUIRE(out.str().find("Filtered.") == std::string::npos);
+	}
+}
@@ -0,0 +1,226 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include "TestUtils.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+#ifndef _WIN32
+namespace
+{
+  std::vector<std::string> readLines(const std::filesystem::path& path)
+  {
+	  std::ifstream            file(path);
+	  std::vector<std::string> lines;
+	  for (std::string line; std::getline(file, line);) lines.push_back(line);
+	  return lines;
+  }
+
+  // Waits for a child, killing it if it hangs; returns whether it exited normally with status 0.
+  bool waitForChild(pid_t child, std::chrono::seconds timeout = std::chrono::seconds(10))
+  {
+	  auto deadline = std::chrono::steady_clock::now() + timeout;
+	  int  status   = 0;
+	  while (waitpid(child, &status, WNOHANG) == 0)
+	  {
+		  if (std::chrono::steady_clock::now() > deadline)
+		  {
+			  kill(child, SIGKILL);
+			  waitpid(child, &status, 0);
+			  return false;
+		  }
+		  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	  }
+	  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+}
+
+
+TEST_CASE("Logify Fork", "[Fork]")
+{
+	using namespace Logify;
+
+	SECTION("Forked children keep logging while the parent's threads log, each to a file of its own")
+	{
+		constexpr int Children = 5;
+		constexpr int Messages = 200;
+
+		auto directory = makeTestDirectory("fork");
+
+		Logger logger(LogLevel::INFO);
+		logger.addFileStream((directory / "app.log").string(), FileStreamOptions{});
+		logger.enableAsync(64);
+		logger.enableFlightRecorder(16);
+
+		// Keep the writer, the sinks and the flight recorder busy while forking.
+		std::atomic<bool> stopping{false};
+		std::thread       background([&] {
+			for (int i = 0; !stopping.load(); ++i)
+			{
+				logger.info("Background " + std::to_string(i));
+				logger.debug("Recorded " + std::to_string(i));
+			}
+		});
+
+		std::vector<pid_t> children;
+		for (int c = 0; c < Children; ++c)
+		{
+			pid_t child = fork();
+			REQUIRE(child >= 0);
+			if (child == 0)
+			{
+				// The child logs from the forking thread and from a new thread, through a new writer.
+				std::thread other([&] {
+					for (int i = 0; i < Messages; ++i) logger.info("Other " + std::to_string(i));
+				});
+				for (int i = 0; i < Messages; ++i) logger.info("Child " + std::to_string(i));
+				other.join();
+				logger.dumpFlightRecorder();
+				logger.flush();
+				_exit(0);
+			}
+			children.push_back(child);
+		}
+
+		bool exited = true;
+		for (pid_t child : children) exited = waitForChild(child) && exited;
+		REQUIRE(exited);
+
+		stopping.store(true);
+		background.join();
+		logger.info("Parent done");
+		logger.flush();
+
+		// The parent's file has only the parent's records.
+		auto parentLines = readLines(directory / "app_0000.log");
+		REQUIRE(!parentLines.empty());
+		REQUIRE(parentLines.back().ends_with("[INFO ] Parent done"));
+		bool parentOnly = true;
+		for (const auto& line : parentLines) parentOnly = parentOnly && line.find("Child ") == std::string::npos;
+		REQUIRE(parentOnly);
+
+		for (pid_t child : children)
+		{
+			// Each child writes its own records, with its own process and thread IDs, and none of the parent's.
+			std::string pid        = std::to_string(child);
+			auto        childLines = readLines(directory / ("app." + pid + "_0000.log"));
+
+			int  own      = 0;
+			bool ownIds   = true;
+			bool inherits = false;
+			for (const auto& line : childLines)
+			{
+				if (line.find("Background ") != std::string::npos) inherits = true;
+				if (line.find("Child ") == std::string::npos && line.find("Other ") == std::string::npos) continue;
+				++own;
+				ownIds = ownIds && line.find("[ID:" + pid + "/") != std::string::npos;
+#ifdef __linux__
+				// The forking thread is the main thread of the child, whose thread ID is the process ID.
+				if (line.find("Child ") != std::string::npos)
+				{
+					ownIds = ownIds && line.find("[ID:" + pid + "/" + pid + "]") != std::string::npos;
+				}
+#endif
+			}
+			REQUIRE(own == 2 * Messages);
+			REQUIRE(ownIds);
+			REQUIRE_FALSE(inherits);
+		}
+	}
+
+	SECTION("A synchronous logger keeps its sinks usable in the child")
+	{
+		std::ostringstream output;
+		Logger             logger(LogLevel::INFO);
+		logger.addOutputStream(output);
+		logger.info("Before");
+
+		int pipeEnds[2];
+		REQUIRE(pipe(pipeEnds) == 0);
+		pid_t child = fork();
+		REQUIRE(child >= 0);
+		if (child == 0)
+		{
+			// Report the child's own output through the pipe.
+			logger.info("In child");
+			std::string text = output.str();
+			bool        ok   = text.find("[INFO ]: Before") != std::string::npos
+				&& text.find("[ID:" + std::to_string(getpid()) + "/") != std::string::npos;
+			char result = ok ? '1' : '0';
+			(void) !write(pipeEnds[1], &result, 1);
+			_exit(0);
+		}
+		close(pipeEnds[1]);
+
+		char result = 0;
+		REQUIRE(read(pipeEnds[0], &result, 1) == 1);
+		close(pipeEnds[0]);
+		REQUIRE(waitForChild(child));
+		REQUIRE(result == '1');
+		REQUIRE(output.str().find("In child") == std::string::npos);
+	}
+
+	SECTION("The threads of a child start with its first use of the logger")
+	{
+		auto directory = makeTestDirectory("fork_lazy");
+		std::ofstream(directory / "level") << "INFO";
+
+		FileStreamOptions options;
+		options.maxFiles = 2;
+
+		auto logger = std::make_unique<Logger>(LogLevel::INFO);
+		logger->addFileStream((directory / "app.log").string(), options);
+		logger->addNetworkStream("unix:" + (directory / "missing.sock").string());
+		logger->watchLevelFile((directory / "level").string());
+		logger->enableAsync(64);
+		logger->info("Before");
+
+		pid_t child = fork();
+		REQUIRE(child >= 0);
+		if (child == 0)
+		{
+			// A grandchild forked before the child used the logger logs through threads of its own.
+			pid_t grandchild = fork();
+			if (grandchild == 0)
+			{
+				logger->info("Grandchild");
+				logger->flush();
+				logger.reset();
+				_exit(0);
+			}
+
+			// The child never logs: destroying the logger must not touch the parent's threads.
+			bool ok = grandchild > 0 && waitForChild(grandchild);
+			logger.reset();
+			_exit(ok ? 0 : 1);
+		}
+		REQUIRE(waitForChild(child));
+
+		logger->info("Parent done");
+		logger->flush();
+		REQUIRE(readLines(directory / "app_0000.log").back().ends_with("[INFO ] Parent done"));
+
+		// Only the grandchild wrote a file of its own; the child opened none.
+		std::vector<std::string> written;
+		for (const auto& entry : std::filesystem::directory_iterator(directory))
+		{
+			auto lines = readLines(entry.path());
+			if (!lines.empty() && lines.back().ends_with("[INFO ] Grandchild")) written.push_back(entry.path().string());
+		}
+		REQUIRE(written.size() == 1);
+		REQUIRE(written.front().find("app." + std::to_string(child) + ".") != std::string::npos);
+	}
+}
+#endif
@@ -0,0 +1,159 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include "TestUtils.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+
+namespace
+{
+  void setLevelVariable(const char* value)
+  {
+#ifdef _WIN32
+	  _putenv_s("LOGIFY_LEVEL", value == nullptr ? "" : value);
+#else
+	  if (value == nullptr) unsetenv("LOGIFY_LEVEL");
+	  else setenv("LOGIFY_LEVEL", value, 1);
+#endif
+  }
+
+  void writeFile(const std::filesystem::path& path, const std::string& content)
+  {
+	  std::ofstream file(path, std::ios::out | std::ios::trunc);
+	  file << content;
+  }
+
+  // Waits until the lowest enabled level of the logger is the given one.
+  bool waitForLevel(const Logify::Logger& logger, Logify::LogLevel level)
+  {
+	  using Logify::LogLevel;
+	  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	  while (std::chrono::steady_clock::now() < deadline)
+	  {
+		  bool below = level == LogLevel::TRACE || !logger.isEnabled(static_cast<LogLevel>(static_cast<int>(level) - 1));
+		  if (logger.isEnabled(level) && below) return true;
+		  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	  }
+	  return false;
+  }
+}
+
+
+TEST_CASE("Logify Level Control", "[LevelControl]")
+{
+	using namespace Logify;
+
+	std::ostringstream output;
+
+	SECTION("LOGIFY_LEVEL overrides the level given to the constructor")
+	{
+		setLevelVariable("debug");
+		Logger logger(LogLevel::WARN);
+		logger.addOutputStream(output);
+		REQUIRE(logger.isEnabled(LogLevel::DEBUG));
+		REQUIRE(!logger.isEnabled(LogLevel::TRACE));
+
+		// An unknown name is ignored.
+		setLevelVariable("verbose");
+		Logger other(LogLevel::WARN);
+		other.addOutputStream(output);
+		REQUIRE(!other.isEnabled(LogLevel::INFO));
+
+		setLevelVariable(nullptr);
+	}
+
+	SECTION("The level follows a watched file")
+	{
+		auto directory = makeTestDirectory("level");
+		auto path      = directory / "level";
+
+		Logger logger(LogLevel::INFO);
+		logger.addOutputStream(output);
+
+		// A missing file leaves the level unchanged; an existing one applies at once.
+		logger.watchLevelFile(path.string());
+		REQUIRE(waitForLevel(logger, LogLevel::INFO));
+		writeFile(path, "WARN\n");
+		logger.watchLevelFile(path.string());
+		REQUIRE(waitForLevel(logger, LogLevel::WARN));
+
+		writeFile(path, "debug\n");
+		REQUIRE(waitForLevel(logger, LogLevel::DEBUG));
+
+		// Replacing the file by a rename.
+		writeFile(directory / "level.new", "ERROR");
+		std::filesystem::rename(directory / "level.new", path);
+		REQUIRE(waitForLevel(logger, LogLevel::ERROR));
+
+		// Other files of the directory and unknown names are ignored.
+		writeFile(directory / "other", "TRACE");
+		writeFile(path, "loud");
+		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		REQUIRE(waitForLevel(logger, LogLevel::ERROR));
+
+		// After stopping, writing the file has no effect.
+		logger.stopWatchingLevelFile();
+		writeFile(path, "TRACE");
+		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		REQUIRE(waitForLevel(logger, LogLevel::ERROR));
+
+		REQUIRE_THROWS_AS(logger.watchLevelFile((directory / "missing" / "level").string()), std::runtime_error);
+	}
+
+#ifndef _WIN32
+	SECTION("SIGUSR1 lowers and SIGUSR2 raises the level by one step")
+	{
+		Logger logger(LogLevel::INFO);
+		logger.addOutputStream(output);
+		logger.enableLevelSignals();
+
+		std::raise(SIGUSR1);
+		REQUIRE(waitForLevel(logger, LogLevel::DEBUG));
+		std::raise(SIGUSR1);
+		std::raise(SIGUSR1);
+		REQUIRE(waitForLevel(logger, LogLevel::TRACE));
+
+		for (int i = 0; i < 4; ++i) std::raise(SIGUSR2);
+		REQUIRE(waitForLevel(logger, LogLevel::ERROR));
+		std::raise(SIGUSR2);
+		std::raise(SIGUSR2);
+		REQUIRE(waitForLevel(logger, LogLevel::FATAL));
+
+		// The signals no longer reach a disabled logger.
+		logger.disableLevelSignals();
+		std::raise(SIGUSR1);
+		REQUIRE(waitForLevel(logger, LogLevel::FATAL));
+	}
+
+	SECTION("Loggers can be destroyed while the signals are delivered")
+	{
+		// The handlers are installed before the first signal is sent.
+		Logger first(LogLevel::INFO);
+		first.addOutputStream(output);
+		first.enableLevelSignals();
+
+		std::atomic<bool> stop{false};
+		std::thread       sender([&stop]() {
+			while (!stop.load()) std::raise(SIGUSR1);
+		});
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addOutputStream(output);
+			logger.enableLevelSignals();
+		}
+
+		stop.store(true);
+		sender.join();
+	}
+#endif
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <Logify/LogStream.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+namespace
+{
+  struct Point
+  {
+	  int x;
+	  int y;
+  };
+
+  // An operator<< that logs while the enclosing message is still being collected.
+  Logify::Logger* nestedLogger = nullptr;
+
+  std::ostream& operator<<(std::ostream& out, const Point& point)
+  {
+	  LOGIFY_STREAM_DEBUG(*nestedLogger) << "Printing a point.";
+	  return out << '(' << point.x << ", " << point.y << ')';
+  }
+}
+
+TEST_CASE("Logify Stream Macros", "[LogStream]")
+{
+	using namespace Logify;
+
+	SECTION("Stream operands form one message")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+
+		int    x     = 42;
+		double ratio = 0.5;
+		LOGIFY_STREAM_INFO(logger) << "x=" << x << ", ratio=" << ratio;
+		LOGIFY_STREAM_WARN(logger) << "Second.";
+
+		std::string text = out.str();
+		REQUIRE(text.find("[INFO ]: x=42, ratio=0.5\n") != std::string::npos);
+		REQUIRE(text.find("[WARN ]: Second.\n") != std::string::npos);
+	}
+
+	SECTION("Disabled levels do not evaluate the operands")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+
+		int  calls     = 0;
+		auto expensive = [&calls]() { return ++calls; };
+		LOGIFY_STREAM_DEBUG(logger) << "value " << expensive();
+		REQUIRE(calls == 0);
+		REQUIRE(out.str().empty());
+		REQUIRE(logger.stats().filtered[static_cast<std::size_t>(LogLevel::DEBUG)] == 1);
+
+		LOGIFY_STREAM(logger, LogLevel::ERROR) << "value " << expensive();
+		REQUIRE(calls == 1);
+		REQUIRE(out.str().find("value 1") != std::string::npos);
+	}
+
+	SECTION("Long messages and manipulators do not leak into the next message")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+
+		std::string longText(1000, 'a');
+		LOGIFY_STREAM_INFO(logger) << longText << std::hex << 255 << std::setprecision(2) << 3.14159;
+		LOGIFY_STREAM_INFO(logger) << 255 << ' ' << 3.14159;
+
+		std::string text = out.str();
+		REQUIRE(text.find(longText + "ff3.1\n") != std::string::npos);
+		REQUIRE(text.find("]: 255 3.14159\n") != std::string::npos);
+	}
+
+	SECTION("Messages logged inside an operand and on other threads stay separate")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::DEBUG);
+		logger.addOutputStream(out);
+		nestedLogger = &logger;
+
+		LOGIFY_STREAM_INFO(logger) << "Point " << Point{1, 2} << '.';
+		std::thread([&logger]() { LOGIFY_STREAM_INFO(logger) << "Other thread " << 7; }).join();
+
+		std::string text = out.str();
+		REQUIRE(text.find("[DEBUG]: Printing a point.\n") != std::string::npos);
+		REQUIRE(text.find("[INFO ]: Point (1, 2).\n") != std::string::npos);
+		REQUIRE(text.find("[INFO ]: Other thread 7\n") != std::string::npos);
+	}
+
+	SECTION("The macros are single statements")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+
+		bool failed = false;
+		if (failed)
+			LOGIFY_STREAM_ERROR(logger) << "Failed.";
+		else
+			LOGIFY_STREAM_INFO(logger) << "Succeeded.";
+
+		REQUIRE(out.str().find("Failed.") == std::string::npos);
+		REQUIRE(out.str().find("Succeeded.") != std::string::npos);
+	}
+}
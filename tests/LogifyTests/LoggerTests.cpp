@@ -2,6 +2,17 @@
 #include <Logify/Logify.h>
 #include <sstream>
 #include <string>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 TEST_CASE("Logify Logger", "[Logger]")
@@ -84,6 +95,41 @@ TEST_CASE("Logify Logger", "[Logger]")
 		// Further checks could be added here to validate the timestamp format.
 	}
 
+	SECTION("Timestamps in UTC and local time match the C library")
+	{
+		// Formats the current time like the logger does, up to the minute, with the C library.
+		auto expected = [](bool utc) {
+			std::time_t now = std::time(nullptr);
+			std::tm     parts{};
+#ifdef _WIN32
+			utc ? gmtime_s(&parts, &now) : localtime_s(&parts, &now);
+#else
+			utc ? gmtime_r(&now, &parts) : localtime_r(&now, &parts);
+#endif
+			char text[64];
+			std::strftime(text, sizeof(text), "[%Y-%m-%d %H:%M %a %j", &parts);
+			return std::string(text);
+		};
+
+		logger.setTimeFormat("%Y-%m-%d %H:%M %a %j");
+		for (bool utc : {true, false})
+		{
+			logger.setTimeZone(utc ? TimeZone::UTC : TimeZone::Local);
+
+			// Retry if the minute changes while logging.
+			std::string before, after;
+			do
+			{
+				logStream.str("");
+				before = expected(utc);
+				logger.info("Zone test.");
+				after = expected(utc);
+			} while (before != after);
+
+			REQUIRE(logStream.str().rfind(before + ".", 0) == 0);
+		}
+	}
+
 	SECTION("Multiple output streams")
 	{
 		std::stringstream additionalStream;
@@ -97,7 +143,135 @@ TEST_CASE("Logify Logger", "[Logger]")
 		REQUIRE(logOutput2.find("[INFO ]: This message should appear in both streams.") != std::string::npos);
 	}
 
+	SECTION("Structured fields")
+	{
+		logger.info("order filled", {{"qty", 100}, {"px", 12.5}, {"sym", "ABC"}, {"ok", true}, {"note", "two words"}});
+
+		std::string logOutput = logStream.str();
+		REQUIRE(logOutput.find("[INFO ]: order filled qty=100 px=12.5 sym=ABC ok=true note=\"two words\"\n")
+					!= std::string::npos);
+	}
+
+	SECTION("Per-stream minimum levels")
+	{
+		std::stringstream warnStream;
+		logger.addOutputStream(warnStream, LogLevel::WARN);
+
+		logger.info("Only in the first stream.");
+		logger.error("In both streams.");
+
+		REQUIRE(logStream.str().find("[INFO ]: Only in the first stream.") != std::string::npos);
+		REQUIRE(logStream.str().find("[ERROR]: In both streams.") != std::string::npos);
+		REQUIRE(warnStream.str().find("Only in the first stream.") == std::string::npos);
+		REQUIRE(warnStream.str().find("[ERROR]: In both streams.") != std::string::npos);
+	}
+
+	SECTION("Removing an output stream")
+	{
+		logger.removeOutputStream(logStream);
+		logger.info("Not written anywhere.");
+
+		REQUIRE(logStream.str().empty());
+	}
+
+	SECTION("Concurrent logging writes complete lines")
+	{
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&logger, t]() {
+				for (int i = 0; i < 250; ++i) logger.info("thread " + std::to_string(t) + " message " + std::to_string(i));
+			});
+		}
+		for (auto& thread : threads) thread.join();
+
+		std::istringstream lines(logStream.str());
+		std::string        line;
+		int                count = 0;
+		while (std::getline(lines, line))
+		{
+			REQUIRE(line.find("[INFO ]: thread ") != std::string::npos);
+			++count;
+		}
+		REQUIRE(count == 1000);
+	}
+
+	SECTION("Lazy messages are only built when their level is enabled")
+	{
+		int calls = 0;
+		logger.debug([&calls]() {
+			++calls;
+			return std::string("Expensive debug message.");
+		});
+		logger.info([&calls]() {
+			++calls;
+			return "Lazy info message.";
+		}, {{"id", 7}});
+		logger.warn([&calls](std::string& out) {
+			++calls;
+			out += "Appended warning.";
+		});
+
+		std::string logOutput = logStream.str();
+		REQUIRE(calls == 2);
+		REQUIRE(logOutput.find("Expensive debug message.") == std::string::npos);
+		REQUIRE(logOutput.find("[INFO ]: Lazy info message. id=7\n") != std::string::npos);
+		REQUIRE(logOutput.find("[WARN ]: Appended warning.\n") != std::string::npos);
+
+		// Skipped messages are still counted as filtered.
+		REQUIRE(logger.stats().filtered[static_cast<std::size_t>(LogLevel::DEBUG)] == 1);
+	}
+
+	SECTION("isEnabled reflects the Logger's and the streams' levels")
+	{
+		REQUIRE(!logger.isEnabled(LogLevel::DEBUG));
+		REQUIRE(logger.isEnabled(LogLevel::INFO));
+
+		logger.removeOutputStream(logStream);
+		REQUIRE(!logger.isEnabled(LogLevel::WARN));
+
+		logger.enableFlightRecorder(8);
+		REQUIRE(logger.isEnabled(LogLevel::TRACE));
+	}
+
 
 	// TODO File Streams
 
-}
\ No newline at end of file
+}
+
+#ifndef _WIN32
+TEST_CASE("Logify Console Stream", "[Logger]")
+{
+	using namespace Logify;
+
+	SECTION("Redirected console output is written without colors")
+	{
+		auto path = std::filesystem::temp_directory_path() / "logify_tests_console.txt";
+
+		// Redirect standard output to a file for the duration of the test.
+		std::fflush(stdout);
+		int savedStdout = dup(1);
+		int file        = open(path.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		REQUIRE(file >= 0);
+		dup2(file, 1);
+		close(file);
+
+		{
+			Logger logger(LogLevel::INFO);
+			logger.addConsoleStream(ConsoleTarget::StdOut);
+			logger.warn("Console message", {{"code", 7}});
+		}
+
+		// Restore standard output.
+		dup2(savedStdout, 1);
+		close(savedStdout);
+
+		std::ifstream     input(path);
+		std::stringstream content;
+		content << input.rdbuf();
+
+		REQUIRE(content.str().find("[WARN ]: Console message code=7\n") != std::string::npos);
+		REQUIRE(content.str().find('\033') == std::string::npos);
+	}
+}
+#endif
@@ -0,0 +1,218 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+#ifndef _WIN32
+namespace
+{
+  // A stand-in for a log aggregator: accepts connections and collects what they send.
+  class Listener
+  {
+   public:
+	  // Listens on a Unix domain socket at the given path.
+	  explicit Listener(const std::filesystem::path& path)
+	  {
+		  std::filesystem::remove(path);
+		  sockaddr_un address{};
+		  address.sun_family = AF_UNIX;
+		  std::string text   = path.string();
+		  text.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+		  listen(AF_UNIX, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+		  address_ = "unix:" + text;
+	  }
+
+	  // Listens on a free TCP port of the loopback interface.
+	  Listener()
+	  {
+		  sockaddr_in address{};
+		  address.sin_family      = AF_INET;
+		  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		  listen(AF_INET, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+
+		  socklen_t size = sizeof(address);
+		  getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &size);
+		  address_ = "tcp:127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+	  }
+
+	  ~Listener()
+	  {
+		  closeConnection();
+		  close(listener_);
+	  }
+
+	  const std::string& address() const { return address_; }
+
+	  // Receives until the given number of lines arrived in total, accepting new connections as needed.
+	  const std::string& receiveLines(std::size_t lines, std::chrono::milliseconds timeout = std::chrono::seconds(5))
+	  {
+		  auto deadline = std::chrono::steady_clock::now() + timeout;
+		  while (lineCount() < lines && std::chrono::steady_clock::now() < deadline)
+		  {
+			  pollfd entry{connection_ >= 0 ? connection_ : listener_, POLLIN, 0};
+			  if (poll(&entry, 1, 10) <= 0) continue;
+
+			  if (connection_ < 0)
+			  {
+				  connection_ = accept(listener_, nullptr, nullptr);
+				  continue;
+			  }
+
+			  char    buffer[65536];
+			  ssize_t size = read(connection_, buffer, sizeof(buffer));
+			  if (size > 0) received_.append(buffer, static_cast<std::size_t>(size));
+			  else closeConnection();
+		  }
+		  return received_;
+	  }
+
+	  void closeConnection()
+	  {
+		  if (connection_ >= 0) close(connection_);
+		  connection_ = -1;
+	  }
+
+	  std::size_t lineCount() const { return static_cast<std::size_t>(std::count(received_.begin(), received_.end(), '\n')); }
+
+   private:
+	  void listen(int family, const sockaddr* address, socklen_t size)
+	  {
+		  listener_ = socket(family, SOCK_STREAM, 0);
+		  if (listener_ < 0 || bind(listener_, address, size) != 0 || ::listen(listener_, 4) != 0)
+		  {
+			  throw std::runtime_error("Cannot listen");
+		  }
+	  }
+
+	  int         listener_   = -1;
+	  int         connection_ = -1;
+	  std::string address_;
+	  std::string received_;
+  };
+
+  std::filesystem::path makeSocketPath(const std::string& name)
+  {
+	  auto directory = std::filesystem::temp_directory_path() / "logify_tests_network";
+	  std::filesystem::create_directories(directory);
+	  return directory / (name + "_" + std::to_string(getpid()) + ".sock");
+  }
+}
+#endif
+
+
+TEST_CASE("Logify Network Streams", "[Network]")
+{
+	using namespace Logify;
+
+	SECTION("Invalid addresses are rejected")
+	{
+		Logger logger(LogLevel::INFO);
+		REQUIRE_THROWS_AS(logger.addNetworkStream("localhost:5140"), std::invalid_argument);
+		REQUIRE_THROWS_AS(logger.addNetworkStream("tcp:localhost"), std::invalid_argument);
+		REQUIRE_THROWS_AS(logger.addNetworkStream("unix:"), std::invalid_argument);
+	}
+
+#ifndef _WIN32
+	SECTION("Records are sent as text lines over a Unix domain socket")
+	{
+		Listener listener(makeSocketPath("text"));
+
+		Logger logger(LogLevel::INFO);
+		logger.addNetworkStream(listener.address());
+		for (int i = 0; i < 1000; ++i) logger.info("Message " + std::to_string(i), {{"index", i}});
+
+		const std::string& received = listener.receiveLines(1000);
+		logger.flush();
+		REQUIRE(listener.lineCount() == 1000);
+		REQUIRE(received.find("[INFO ]: Message 0 index=0\n") != std::string::npos);
+		REQUIRE(received.ends_with("[INFO ]: Message 999 index=999\n"));
+
+		LoggerStats stats = logger.stats();
+		REQUIRE(stats.sinks[0].name == listener.address());
+		REQUIRE(stats.sinks[0].bytesWritten == received.size());
+		REQUIRE(stats.sinks[0].writeErrors == 0);
+	}
+
+	SECTION("Records are sent as JSON lines over TCP")
+	{
+		Listener listener;
+
+		NetworkStreamOptions options;
+		options.format = NetworkFormat::JsonLines;
+
+		Logger logger(LogLevel::INFO);
+		logger.addNetworkStream(listener.address(), options);
+		logger.warn("Disk \"data\" almost full", {{"free", 0.5}});
+
+		const std::string& received = listener.receiveLines(1);
+		REQUIRE(received.starts_with("{\"ts\":"));
+		REQUIRE(received.ends_with(
+			",\"level\":\"WARN\",\"message\":\"Disk \\\"data\\\" almost full\",\"fields\":{\"free\":0.5}}\n"
+		));
+	}
+
+	SECTION("Records logged while the peer is down are sent once it is reachable again")
+	{
+		auto path = makeSocketPath("reconnect");
+		std::filesystem::remove(path);
+
+		NetworkStreamOptions options;
+		options.minReconnectDelay = std::chrono::milliseconds(5);
+		options.maxReconnectDelay = std::chrono::milliseconds(20);
+
+		Logger logger(LogLevel::INFO);
+		logger.addNetworkStream("unix:" + path.string(), options);
+		for (int i = 0; i < 10; ++i) logger.info("Before " + std::to_string(i));
+
+		// Logging does not wait for the peer.
+		Listener listener(path);
+		listener.receiveLines(10);
+		REQUIRE(listener.lineCount() == 10);
+
+		// The peer drops the connection; the stream reconnects and sends the next records.
+		listener.closeConnection();
+		for (int i = 0; i < 10; ++i) logger.info("After " + std::to_string(i));
+
+		const std::string& received = listener.receiveLines(20 - logger.stats().sinks[0].writeErrors);
+		REQUIRE(received.find("[INFO ]: Before 9\n") != std::string::npos);
+		REQUIRE(received.ends_with("[INFO ]: After 9\n"));
+	}
+
+	SECTION("The backlog kept while the peer is down is bounded")
+	{
+		auto path = makeSocketPath("bounded");
+		std::filesystem::remove(path);
+
+		NetworkStreamOptions options;
+		options.maxPendingBytes   = 1000;
+		options.minReconnectDelay = std::chrono::milliseconds(5);
+		options.maxReconnectDelay = std::chrono::milliseconds(5);
+
+		Logger logger(LogLevel::INFO);
+		logger.addNetworkStream("unix:" + path.string(), options);
+		for (int i = 0; i < 100; ++i) logger.info("Message " + std::to_string(i));
+
+		std::uint64_t dropped = logger.stats().sinks[0].writeErrors;
+		REQUIRE(dropped > 50);
+
+		Listener listener(path);
+		listener.receiveLines(100 - dropped);
+		REQUIRE(listener.lineCount() == 100 - dropped);
+		REQUIRE(listener.receiveLines(100 - dropped).find("[INFO ]: Message 0\n") != std::string::npos);
+	}
+#endif
+}
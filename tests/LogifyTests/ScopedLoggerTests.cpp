@@ -0,0 +1,152 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <Logify/ScopedLogger.h>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+TEST_CASE("Logify Scope Buffering", "[ScopedLogger]")
+{
+	using namespace Logify;
+
+	SECTION("Debug messages of a scope without problems are discarded")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableScopeBuffering();
+
+		{
+			ScopedLogger scope(logger, "handleRequest");
+			logger.debug("Parsed headers.");
+			logger.info("Request handled.");
+		}
+
+		std::string text = out.str();
+		REQUIRE(text.find("handleRequest {") != std::string::npos);
+		REQUIRE(text.find("Request handled.") != std::string::npos);
+		REQUIRE(text.find("Parsed headers.") == std::string::npos);
+	}
+
+	SECTION("An error writes the debug messages of its scope just before it")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableScopeBuffering();
+
+		{
+			ScopedLogger outer(logger, "handleRequest");
+			logger.debug("Parsed headers.", {{"size", 12}});
+			{
+				ScopedLogger inner(logger, "queryDatabase");
+				logger.debug("Sent query.");
+			}
+			logger.error("Request failed.");
+		}
+
+		// The messages of the nested scope are held until the outermost scope ends.
+		std::string text = out.str();
+		REQUIRE(text.find("[DEBUG]: ") != std::string::npos);
+		REQUIRE(text.find("Parsed headers. size=12") != std::string::npos);
+		REQUIRE(text.find("queryDatabase {") < text.find("Parsed headers."));
+		REQUIRE(text.find("Parsed headers.") < text.find("Sent query."));
+		REQUIRE(text.find("Sent query.") < text.find("Request failed."));
+		REQUIRE(text.find("Sent query.") == text.rfind("Sent query."));
+	}
+
+	SECTION("Messages outside scopes and of other threads' scopes are not held")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::DEBUG);
+		logger.addOutputStream(out);
+		logger.enableScopeBuffering();
+
+		logger.debug("Outside.");
+		{
+			ScopedLogger scope(logger, "work");
+			std::thread([&logger]() { logger.debug("Other thread."); }).join();
+			logger.debug("Held.");
+		}
+		std::thread([&logger]() {
+			ScopedLogger scope(logger, "failing");
+			logger.debug("Context.");
+			logger.warn("Warning.");
+		}).join();
+
+		std::string text = out.str();
+		REQUIRE(text.find("Outside.") != std::string::npos);
+		REQUIRE(text.find("Other thread.") != std::string::npos);
+		REQUIRE(text.find("Held.") == std::string::npos);
+		REQUIRE(text.find("Context.") < text.find("Warning."));
+	}
+
+	SECTION("A logger created where a destroyed one was has its own scope buffer")
+	{
+		// The storage of the Logger is reused, and usually the one of its implementation too.
+		std::optional<Logger> logger;
+		for (int i = 0; i < 50; ++i)
+		{
+			std::stringstream small;
+			logger.emplace(LogLevel::INFO);
+			logger->addOutputStream(small);
+			logger->enableScopeBuffering(LogLevel::DEBUG, LogLevel::WARN, 2);
+			{
+				ScopedLogger scope(*logger, "small");
+				logger->debug("Held.");
+			}
+			logger.reset();
+
+			std::stringstream out;
+			logger.emplace(LogLevel::INFO);
+			logger->addOutputStream(out);
+			logger->enableScopeBuffering(LogLevel::DEBUG, LogLevel::WARN, 8);
+			{
+				ScopedLogger scope(*logger, "large");
+				for (int j = 0; j < 5; ++j) logger->debug("Step " + std::to_string(j) + ".");
+				logger->error("Failed.");
+			}
+			logger.reset();
+
+			std::string text = out.str();
+			for (int j = 0; j < 5; ++j) REQUIRE(text.find("Step " + std::to_string(j) + ".") != std::string::npos);
+		}
+	}
+
+	SECTION("Held messages are counted as accepted only once written")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::DEBUG);
+		logger.addOutputStream(out);
+		logger.enableScopeBuffering();
+		auto debug = static_cast<std::size_t>(LogLevel::DEBUG);
+
+		{
+			ScopedLogger scope(logger, "discarded");
+			logger.debug("Discarded.");
+		}
+		REQUIRE(logger.stats().accepted[debug] == 0);
+
+		{
+			ScopedLogger scope(logger, "written");
+			logger.debug("Written.");
+			logger.warn("Problem.");
+		}
+		REQUIRE(logger.stats().accepted[debug] == 1);
+	}
+
+	SECTION("Without scope buffering, scopes do not change what is written")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::DEBUG);
+		logger.addOutputStream(out);
+
+		{
+			ScopedLogger scope(logger, "work");
+			logger.debug("Written at once.");
+		}
+		REQUIRE(out.str().find("Written at once.") < out.str().find("} // End of work"));
+	}
+}
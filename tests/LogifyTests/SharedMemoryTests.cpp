@@ -0,0 +1,168 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+  // A segment name of its own for each test case and test process.
+  std::string makeRingName(const std::string& name)
+  {
+#ifdef _WIN32
+	  return "logify_tests_" + name;
+#else
+	  return "logify_tests_" + name + "_" + std::to_string(getpid());
+#endif
+  }
+
+  std::vector<std::string> splitLines(const std::string& text)
+  {
+	  std::vector<std::string> lines;
+	  std::istringstream       stream(text);
+	  for (std::string line; std::getline(stream, line);) lines.push_back(line);
+	  return lines;
+  }
+}
+
+
+TEST_CASE("Logify Shared Memory", "[SharedMemory]")
+{
+	using namespace Logify;
+
+	SECTION("The collector writes the published records with their fields")
+	{
+		std::string name = makeRingName("fields");
+		Logger::removeSharedMemory(name);
+
+		std::stringstream output;
+		Logger            collector(LogLevel::TRACE);
+		collector.addOutputStream(output);
+		collector.startCollector(name, 256);
+
+		Logger producer(LogLevel::TRACE);
+		producer.addSharedMemoryStream(name);
+		producer.info("Hello", {{"user", "alice"}, {"count", 3}, {"ratio", 0.5}, {"ok", true}});
+		producer.error("Second");
+
+		// A message spanning many cells.
+		std::string large(3000, 'x');
+		producer.warn(large, {{"size", large.size()}});
+
+		collector.flush();
+		auto lines = splitLines(output.str());
+		REQUIRE(lines.size() == 3);
+		REQUIRE(lines[0].ends_with("[INFO ]: Hello user=alice count=3 ratio=0.5 ok=true"));
+		REQUIRE(lines[1].ends_with("[ERROR]: Second"));
+		REQUIRE(lines[2].ends_with("[WARN ]: " + large + " size=3000"));
+
+		SinkStats stats = producer.stats().sinks[0];
+		REQUIRE(stats.name == "shm:" + name);
+		REQUIRE(stats.writeErrors == 0);
+
+		collector.stopCollector();
+		Logger::removeSharedMemory(name);
+	}
+
+	SECTION("Records that do not fit into a full ring are dropped and reported by the collector")
+	{
+		std::string name = makeRingName("full");
+		Logger::removeSharedMemory(name);
+
+		Logger producer(LogLevel::TRACE);
+		producer.addSharedMemoryStream(name, 64);
+		for (int i = 0; i < 100; ++i) producer.info("Message " + std::to_string(i));
+		REQUIRE(producer.stats().sinks[0].writeErrors == 36);
+
+		std::stringstream output;
+		{
+			Logger collector(LogLevel::TRACE);
+			collector.addOutputStream(output);
+			collector.startCollector(name);
+		}
+
+		// The kept records come first, then the report.
+		auto lines = splitLines(output.str());
+		REQUIRE(lines.size() == 65);
+		REQUIRE(lines[0].ends_with("Message 0"));
+		REQUIRE(lines[63].ends_with("Message 63"));
+		REQUIRE(lines[64].find("[WARN ]: Dropped 36 log records because the shared memory ring was full") != std::string::npos);
+
+		Logger::removeSharedMemory(name);
+	}
+
+#ifndef _WIN32
+	SECTION("Records of several processes are collected in the order of each thread")
+	{
+		constexpr int Processes = 4;
+		constexpr int Messages  = 2000;
+
+		std::string name = makeRingName("processes");
+		Logger::removeSharedMemory(name);
+
+		std::stringstream output;
+		Logger            collector(LogLevel::TRACE);
+		collector.addOutputStream(output);
+		collector.startCollector(name, 1024);
+
+		std::vector<pid_t> children;
+		for (int p = 0; p < Processes; ++p)
+		{
+			pid_t child = fork();
+			REQUIRE(child >= 0);
+			if (child == 0)
+			{
+				Logger producer(LogLevel::TRACE);
+				producer.addSharedMemoryStream(name);
+				for (int i = 0; i < Messages; ++i)
+				{
+					// Wait for the collector instead of dropping, to check that nothing is lost.
+					std::uint64_t errors = producer.stats().sinks[0].writeErrors;
+					producer.info("Message " + std::to_string(i));
+					while (producer.stats().sinks[0].writeErrors != errors)
+					{
+						errors = producer.stats().sinks[0].writeErrors;
+						usleep(100);
+						producer.info("Message " + std::to_string(i));
+					}
+				}
+				_exit(0);
+			}
+			children.push_back(child);
+		}
+
+		for (pid_t child : children)
+		{
+			int status = 0;
+			waitpid(child, &status, 0);
+			REQUIRE(WIFEXITED(status));
+		}
+		collector.flush();
+		collector.stopCollector();
+		Logger::removeSharedMemory(name);
+
+		// Each process's records arrive complete and in order.
+		std::map<std::string, int> nextIndex;
+		bool                       ordered = true;
+		for (const auto& line : splitLines(output.str()))
+		{
+			if (line.find("[WARN ]: Dropped") != std::string::npos) continue;
+
+			auto        idStart = line.find("[ID:");
+			auto        idEnd   = line.find('/', idStart);
+			std::string pid     = line.substr(idStart + 4, idEnd - idStart - 4);
+			ordered             = ordered && line.ends_with("[INFO ]: Message " + std::to_string(nextIndex[pid]++));
+		}
+		REQUIRE(ordered);
+		REQUIRE(nextIndex.size() == Processes);
+		for (const auto& [pid, count] : nextIndex) REQUIRE(count == Messages);
+	}
+#endif
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch.hpp>
+#include <Logify/Logify.h>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("Logify Statistics", "[Stats]")
+{
+	using namespace Logify;
+
+	constexpr auto Debug = static_cast<std::size_t>(LogLevel::DEBUG);
+	constexpr auto Info  = static_cast<std::size_t>(LogLevel::INFO);
+	constexpr auto Warn  = static_cast<std::size_t>(LogLevel::WARN);
+
+	SECTION("Accepted and filtered messages are counted per level")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+
+		logger.debug("Filtered.");
+		logger.info("First.");
+		logger.info("Second.", {{"key", 1}});
+		logger.warn("Third.");
+
+		LoggerStats stats = logger.stats();
+		REQUIRE(stats.filtered[Debug] == 1);
+		REQUIRE(stats.accepted[Debug] == 0);
+		REQUIRE(stats.accepted[Info] == 2);
+		REQUIRE(stats.accepted[Warn] == 1);
+		REQUIRE(stats.queueHighWater == 0);
+
+		REQUIRE(stats.sinks.size() == 1);
+		REQUIRE(stats.sinks[0].name == "ostream");
+		REQUIRE(stats.sinks[0].bytesWritten == out.str().size());
+		REQUIRE(stats.sinks[0].flushes == 3);
+		REQUIRE(stats.sinks[0].writeErrors == 0);
+		REQUIRE(stats.bytesWritten == out.str().size());
+	}
+
+	SECTION("Counts from many threads add up exactly")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 8; ++t)
+		{
+			threads.emplace_back([&logger]() {
+				for (int i = 0; i < 500; ++i)
+				{
+					logger.info("Counted.");
+					logger.debug("Filtered.");
+				}
+			});
+		}
+		for (auto& thread : threads) thread.join();
+
+		LoggerStats stats = logger.stats();
+		REQUIRE(stats.accepted[Info] == 4000);
+		REQUIRE(stats.filtered[Debug] == 4000);
+		REQUIRE(stats.sinks[0].flushes == 4000);
+	}
+
+	SECTION("Write errors are counted for failed streams")
+	{
+		std::stringstream broken;
+		broken.setstate(std::ios::badbit);
+
+		Logger logger(LogLevel::INFO);
+		logger.addOutputStream(broken);
+		logger.info("Lost.");
+		logger.info("Lost too.");
+
+		LoggerStats stats = logger.stats();
+		REQUIRE(stats.writeErrors == 2);
+		REQUIRE(stats.bytesWritten == 0);
+	}
+
+	SECTION("File rotations are counted")
+	{
+		auto directory = std::filesystem::temp_directory_path() / "logify_tests_stats_rotation";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+
+		Logger logger(LogLevel::INFO);
+		logger.addFileStream((directory / "app.log").string(), 256);
+		for (int i = 0; i < 20; ++i) logger.info("A message long enough to fill the small files quickly.");
+
+		LoggerStats stats = logger.stats();
+		REQUIRE(stats.sinks.size() == 1);
+		REQUIRE(stats.sinks[0].name == (directory / "app.log").string());
+		REQUIRE(stats.rotations > 0);
+		REQUIRE(stats.rotations == stats.sinks[0].rotations);
+		REQUIRE(stats.flushes == 20);
+	}
+
+	SECTION("The queue depth high-water mark is tracked in asynchronous mode")
+	{
+		std::stringstream out;
+		Logger            logger(LogLevel::INFO);
+		logger.addOutputStream(out);
+		logger.enableAsync(64);
+
+		for (int i = 0; i < 200; ++i) logger.info("Queued.");
+		logger.flush();
+
+		LoggerStats stats = logger.stats();
+		REQUIRE(stats.accepted[Info] == 200);
+		REQUIRE(stats.queueHighWater >= 1);
+		REQUIRE(stats.queueHighWater <= 64);
+		REQUIRE(stats.sinks[0].flushes == 200);
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+// Creates an empty directory for the files of one test case.
+inline std::filesystem::path makeTestDirectory(const std::string& name)
+{
+	auto directory = std::filesystem::temp_directory_path() / ("logify_tests_" + name);
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	return directory;
+}
+
+// Reads a whole file; a missing file reads as empty.
+inline std::string readFile(const std::filesystem::path& path)
+{
+	std::ifstream     file(path, std::ios::in | std::ios::binary);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
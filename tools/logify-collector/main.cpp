@@ -0,0 +1,159 @@
+/*
+ * Logify Collector Tool
+ *
+ * Writes the records that the Loggers of other processes publish into a shared memory ring
+ * (Logger::addSharedMemoryStream) to a log file, until it is interrupted. Being the only
+ * writer of the file, it rotates and trims it without coordinating with the producers.
+ * Records still in the ring when the collector stops are written by its next run.
+ *
+ * Usage:
+ *   logify-collector <name> <file> [--max-size BYTES] [--max-files COUNT] [--capacity CELLS]
+ *                    [--level LEVEL] [--remove]
+ */
+
+#include <Logify/Logify.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+
+namespace
+{
+  // The level names in ascending order, as written by Logify.
+  constexpr std::array<std::string_view, 6> LevelNames{"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+  volatile std::sig_atomic_t interrupted = 0;
+
+  void onSignal(int)
+  {
+	  interrupted = 1;
+  }
+
+  void printUsage()
+  {
+	  std::cerr << "Usage: logify-collector <name> <file> [--max-size BYTES] [--max-files COUNT] [--capacity CELLS]\n"
+				<< "                        [--level LEVEL] [--remove]\n"
+				<< "  <name>       The name of the shared memory ring given to addSharedMemoryStream().\n"
+				<< "  <file>       The log file to write, e.g. logs/app.log; rotated like a Logify file stream.\n"
+				<< "  --max-size   The size at which the file is rotated (default is 10MB).\n"
+				<< "  --max-files  The number of rotated files kept (default is all).\n"
+				<< "  --capacity   The number of 256-byte cells of the ring, if it is created here (default is 16384).\n"
+				<< "  --level      TRACE, DEBUG, INFO, WARN, ERROR or FATAL; records below it are left out.\n"
+				<< "  --remove     Remove the ring when stopping.\n";
+  }
+
+  std::optional<Logify::LogLevel> parseLevel(std::string_view name)
+  {
+	  for (std::size_t i = 0; i < LevelNames.size(); ++i)
+	  {
+		  if (LevelNames[i] == name) return static_cast<Logify::LogLevel>(i);
+	  }
+	  return std::nullopt;
+  }
+
+  std::optional<std::uint64_t> parseNumber(const std::string& text)
+  {
+	  try
+	  {
+		  std::size_t   end   = 0;
+		  std::uint64_t value = std::stoull(text, &end);
+		  if (end == text.size()) return value;
+	  }
+	  catch (const std::exception&)
+	  {}
+	  return std::nullopt;
+  }
+}
+
+
+int main(int argc, char* argv[])
+{
+	// Read the arguments.
+	std::string                name;
+	std::string                file;
+	std::size_t                capacity = 16384;
+	Logify::LogLevel           level    = Logify::LogLevel::TRACE;
+	bool                       remove   = false;
+	Logify::FileStreamOptions  options;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view argument = argv[i];
+		bool             hasValue = i + 1 < argc;
+		if ((argument == "--max-size" || argument == "--max-files" || argument == "--capacity") && hasValue)
+		{
+			auto number = parseNumber(argv[++i]);
+			if (!number)
+			{
+				std::cerr << "logify-collector: invalid number '" << argv[i] << "'\n";
+				return 2;
+			}
+			if (argument == "--max-size") options.maxFileSize = *number;
+			else if (argument == "--max-files") options.maxFiles = *number;
+			else capacity = *number;
+		}
+		else if (argument == "--level" && hasValue)
+		{
+			auto parsed = parseLevel(argv[++i]);
+			if (!parsed)
+			{
+				std::cerr << "logify-collector: invalid level '" << argv[i] << "'\n";
+				return 2;
+			}
+			level = *parsed;
+		}
+		else if (argument == "--remove")
+		{
+			remove = true;
+		}
+		else if (!argument.starts_with("--") && name.empty())
+		{
+			name = argument;
+		}
+		else if (!argument.starts_with("--") && file.empty())
+		{
+			file = argument;
+		}
+		else
+		{
+			printUsage();
+			return 2;
+		}
+	}
+	if (name.empty() || file.empty())
+	{
+		printUsage();
+		return 2;
+	}
+
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+
+	try
+	{
+		// The logger writes the collected records to the file; its own level filters them.
+		Logify::Logger logger(level);
+		logger.addFileStream(file, options);
+		logger.startCollector(name, capacity);
+
+		while (interrupted == 0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+		// Write what has been published so far; the destructor closes the file.
+		logger.stopCollector();
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << "logify-collector: " << exception.what() << "\n";
+		return 1;
+	}
+
+	if (remove) Logify::Logger::removeSharedMemory(name);
+	return 0;
+}
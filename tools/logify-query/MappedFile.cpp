@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+Logify::MappedFile::MappedFile(const std::string& path)
+	: data_(nullptr), size_(0), open_(false), file_(INVALID_HANDLE_VALUE), mapping_(nullptr)
+{
+	file_ = CreateFileA(
+		path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr
+	);
+	if (file_ == INVALID_HANDLE_VALUE) return;
+	open_ = true;
+
+	// An empty file cannot be mapped; it simply has no data.
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) return;
+
+	mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr) return;
+
+	data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ != nullptr) size_ = static_cast<std::size_t>(size.QuadPart);
+}
+
+Logify::MappedFile::~MappedFile()
+{
+	if (data_ != nullptr) UnmapViewOfFile(data_);
+	if (mapping_ != nullptr) CloseHandle(mapping_);
+	if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+}
+
+#else
+
+Logify::MappedFile::MappedFile(const std::string& path)
+	: data_(nullptr), size_(0), open_(false)
+{
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return;
+	open_ = true;
+
+	// An empty file cannot be mapped; it simply has no data.
+	struct stat status{};
+	if (::fstat(fd, &status) == 0 && status.st_size > 0)
+	{
+		void* mapping = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED)
+		{
+			data_ = static_cast<const char*>(mapping);
+			size_ = static_cast<std::size_t>(status.st_size);
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed.
+	::close(fd);
+}
+
+Logify::MappedFile::~MappedFile()
+{
+	if (data_ != nullptr) ::munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Logify Query Tool - Memory-Mapped Files
+ *
+ * Author: Mustafa Alotbah
+ * Contact: mustafa.alotbah@gmail.com
+ * Date: 2026 October
+ *
+ * Description:
+ * This header file defines the MappedFile class, which maps a file read-only into memory,
+ * so that the query tool only reads the pages of the byte ranges it looks at.
+ *
+ * License:
+ * BSD 3-Clause License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace Logify
+{
+
+  /**
+   * @class MappedFile
+   * @brief A file mapped read-only into memory for the lifetime of the object.
+   *
+   * A file that cannot be opened or is empty has no data; isOpen() tells them apart.
+   */
+  class MappedFile
+  {
+   public:
+	  /**
+	   * @brief Maps the file at the given path.
+	   * @param path The path of the file.
+	   */
+	  explicit MappedFile(const std::string& path);
+
+	  /**
+	   * @brief Unmaps the file.
+	   */
+	  ~MappedFile();
+
+	  MappedFile(const MappedFile&)            = delete;
+	  MappedFile& operator=(const MappedFile&) = delete;
+
+	  /**
+	   * @brief Checks whether the file could be opened.
+	   */
+	  [[nodiscard]] bool isOpen() const { return open_; }
+
+	  /**
+	   * @brief Retrieves the contents of the file.
+	   */
+	  [[nodiscard]] std::string_view data() const { return {data_, size_}; }
+
+   private:
+	  const char* data_;     ///< The first byte of the mapping, or nullptr.
+	  std::size_t size_;     ///< The size of the file.
+	  bool        open_;     ///< Whether the file could be opened.
+#ifdef _WIN32
+	  void*       file_;     ///< The handle of the file.
+	  void*       mapping_;  ///< The handle of the file mapping.
+#endif
+  };
+
+} // namespace Logify
@@ -0,0 +1,303 @@
+/*
+ * Logify Query Tool
+ *
+ * Prints the records of the rotated files of a Logify file stream within a time range,
+ * optionally leaving out records below a level. The sparse time index written next to each
+ * file ("app_0000.log.idx") selects the parts of the file whose earliest and latest times
+ * overlap the range, and only those parts of the memory-mapped file are read, together with
+ * the records written since the last index entry. JSON Lines records are then filtered by
+ * their exact timestamp. The text timestamps of LOG and HTML files are not parsed, so for
+ * these the result is part-granular: it holds every record of the selected parts. A time
+ * range on a LOG or HTML file without an index is an error rather than printing the file.
+ *
+ * Usage:
+ *   logify-query <file> [--from TIME] [--to TIME] [--level LEVEL]
+ */
+
+#include "LogIndex.h"
+#include "LogSegments.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace
+{
+  // The level names in ascending order, as written by Logify.
+  constexpr std::array<std::string_view, 6> LevelNames{"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+  // The file formats of Logify file streams.
+  enum class Format
+  {
+	  Log,
+	  Html,
+	  Jsonl
+  };
+
+  struct Query
+  {
+	  std::string  file;                                              // The file name given to addFileStream().
+	  std::int64_t from  = std::numeric_limits<std::int64_t>::min();  // Nanoseconds since the epoch.
+	  std::int64_t to    = std::numeric_limits<std::int64_t>::max();  // Nanoseconds since the epoch, inclusive.
+	  int          level = 0;                                         // The lowest level printed.
+
+	  // Whether --from or --to was given.
+	  [[nodiscard]] bool hasTimeRange() const
+	  {
+		  return from != std::numeric_limits<std::int64_t>::min() || to != std::numeric_limits<std::int64_t>::max();
+	  }
+  };
+
+  void printUsage()
+  {
+	  std::cerr << "Usage: logify-query <file> [--from TIME] [--to TIME] [--level LEVEL]\n"
+				<< "  <file>   The file name given to addFileStream(), e.g. logs/app.log; all its rotated files are read.\n"
+				<< "  TIME     \"YYYY-MM-DD HH:MM[:SS]\" or \"HH:MM[:SS]\" (today), in local time. The end is inclusive.\n"
+				<< "  LEVEL    TRACE, DEBUG, INFO, WARN, ERROR or FATAL; records below it are left out.\n"
+				<< "JSON Lines records are filtered by their exact time. For .log and .html files, the records of every\n"
+				<< "index part that overlaps the range are printed, and a time range needs the index of each file.\n";
+  }
+
+  // Parses a local time; a time without a date is today. Returns the first and last nanosecond it stands for.
+  std::optional<std::pair<std::int64_t, std::int64_t>> parseTime(const std::string& text)
+  {
+	  static constexpr std::array<std::pair<const char*, bool>, 4> Formats{
+		  {{"%Y-%m-%d %H:%M:%S", true}, {"%Y-%m-%d %H:%M", false}, {"%H:%M:%S", true}, {"%H:%M", false}}
+	  };
+
+	  for (const auto& [format, hasSeconds] : Formats)
+	  {
+		  // Start from today, so that a time without a date keeps today's date.
+		  std::time_t now = std::time(nullptr);
+		  std::tm     local{};
+#ifdef _WIN32
+		  localtime_s(&local, &now);
+#else
+		  localtime_r(&now, &local);
+#endif
+		  local.tm_sec = 0;
+
+		  std::istringstream input(text);
+		  input >> std::get_time(&local, format);
+		  if (input.fail() || input.peek() != std::char_traits<char>::eof()) continue;
+
+		  local.tm_isdst = -1;
+		  std::time_t  seconds = std::mktime(&local);
+		  std::int64_t first   = static_cast<std::int64_t>(seconds) * 1'000'000'000;
+		  std::int64_t length  = hasSeconds ? 1'000'000'000 : 60'000'000'000;
+		  return std::make_pair(first, first + length - 1);
+	  }
+	  return std::nullopt;
+  }
+
+  std::optional<int> parseLevel(std::string_view name)
+  {
+	  for (std::size_t i = 0; i < LevelNames.size(); ++i)
+	  {
+		  if (LevelNames[i] == name) return static_cast<int>(i);
+	  }
+	  return std::nullopt;
+  }
+
+  // Finds the text between a marker and the next terminator in a line, or an empty view.
+  std::string_view findBetween(std::string_view line, std::string_view marker, char terminator)
+  {
+	  std::size_t start = line.find(marker);
+	  if (start == std::string_view::npos) return {};
+	  start += marker.size();
+
+	  std::size_t end = line.find(terminator, start);
+	  if (end == std::string_view::npos) return {};
+	  return line.substr(start, end - start);
+  }
+
+  // Determines the level of a record's first line; -1 if the line does not start a record.
+  int recordLevel(std::string_view line, Format format)
+  {
+	  std::string_view name;
+	  switch (format)
+	  {
+		  case Format::Log:
+			  // "[timestamp][ID:pid/tid][LEVEL] message"; other lines continue a multi-line message.
+			  if (!line.starts_with('[') || line.find("][ID:") == std::string_view::npos) return -1;
+			  name = findBetween(line.substr(line.find("][ID:") + 5), "][", ']');
+			  break;
+		  case Format::Html:
+			  // The rows of the table; the header and the closing tags are not records.
+			  if (!line.starts_with("<tr class=\"log-entry\">")) return -1;
+			  name = findBetween(line, "<td class=\"level ", '"');
+			  break;
+		  case Format::Jsonl:
+			  name = findBetween(line, "\"level\":\"", '"');
+			  break;
+	  }
+
+	  // The labels of text and HTML files are padded to five characters.
+	  name = name.substr(0, name.find(' '));
+	  return parseLevel(name).value_or(-1);
+  }
+
+  // Reads the timestamp of a JSON Lines record, the only format whose time is not locale-formatted.
+  std::optional<std::int64_t> recordTime(std::string_view line)
+  {
+	  if (!line.starts_with("{\"ts\":")) return std::nullopt;
+	  line.remove_prefix(6);
+
+	  std::int64_t time   = 0;
+	  auto         result = std::from_chars(line.data(), line.data() + line.size(), time);
+	  if (result.ec != std::errc()) return std::nullopt;
+	  return time;
+  }
+
+  // Prints the records of a part of a file that pass the level, and for JSON Lines, the time range.
+  void printRecords(std::string_view text, Format format, const Query& query)
+  {
+	  bool printing = false;
+	  while (!text.empty())
+	  {
+		  std::size_t      end  = text.find('\n');
+		  std::size_t      size = end == std::string_view::npos ? text.size() : end + 1;
+		  std::string_view line = text.substr(0, size);
+		  text.remove_prefix(size);
+
+		  // A line that starts a record decides whether it and its continuation lines are printed.
+		  int level = recordLevel(line, format);
+		  if (level >= 0)
+		  {
+			  printing = level >= query.level;
+			  if (printing && format == Format::Jsonl)
+			  {
+				  auto time = recordTime(line);
+				  printing  = time && *time >= query.from && *time <= query.to;
+			  }
+		  }
+		  else if (format != Format::Log)
+		  {
+			  printing = false;
+		  }
+
+		  if (printing) std::fwrite(line.data(), 1, line.size(), stdout);
+	  }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+	// Read the arguments.
+	Query query;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view argument = argv[i];
+		bool             hasValue = i + 1 < argc;
+		if (argument == "--from" && hasValue)
+		{
+			auto time = parseTime(argv[++i]);
+			if (!time)
+			{
+				std::cerr << "logify-query: invalid time '" << argv[i] << "'\n";
+				return 2;
+			}
+			query.from = time->first;
+		}
+		else if (argument == "--to" && hasValue)
+		{
+			auto time = parseTime(argv[++i]);
+			if (!time)
+			{
+				std::cerr << "logify-query: invalid time '" << argv[i] << "'\n";
+				return 2;
+			}
+			query.to = time->second;
+		}
+		else if (argument == "--level" && hasValue)
+		{
+			auto level = parseLevel(argv[++i]);
+			if (!level)
+			{
+				std::cerr << "logify-query: invalid level '" << argv[i] << "'\n";
+				return 2;
+			}
+			query.level = *level;
+		}
+		else if (!argument.starts_with("--") && query.file.empty())
+		{
+			query.file = argument;
+		}
+		else
+		{
+			printUsage();
+			return 2;
+		}
+	}
+	if (query.file.empty())
+	{
+		printUsage();
+		return 2;
+	}
+
+	// Split the file name as the file stream does: "logs/app.log" has the segments "logs/app_NNNN.log".
+	std::size_t dotPos    = query.file.find_last_of('.');
+	std::string baseName  = dotPos == std::string::npos ? query.file : query.file.substr(0, dotPos);
+	std::string extension = dotPos == std::string::npos ? "log" : query.file.substr(dotPos + 1);
+
+	Format format = Format::Log;
+	if (extension == "html" || extension == "htm") format = Format::Html;
+	if (extension == "jsonl" || extension == "ndjson") format = Format::Jsonl;
+
+	// Read the segments from oldest to newest.
+	std::vector<Logify::LogSegment> segments = Logify::findLogSegments(baseName, extension);
+	std::sort(segments.begin(), segments.end(), [](const Logify::LogSegment& a, const Logify::LogSegment& b) {
+		return a.isOlderThan(b.period, b.index);
+	});
+	if (segments.empty())
+	{
+		std::cerr << "logify-query: no files of '" << query.file << "' found\n";
+		return 1;
+	}
+
+	int status = 0;
+	for (const Logify::LogSegment& segment : segments)
+	{
+		Logify::MappedFile file(segment.path.string());
+		std::string_view   text = file.data();
+
+		// Narrow the file down to the byte ranges of the time range, if it has an index.
+		Logify::MappedFile index(Logify::indexPath(segment.path.string()));
+		if (!index.isOpen())
+		{
+			// Without an index, only JSON Lines records can be filtered by their time.
+			if (format != Format::Jsonl && query.hasTimeRange())
+			{
+				std::cerr << "logify-query: '" << segment.path.string() << "' has no time index; "
+						  << "a time range needs one for .log and .html files\n";
+				status = 1;
+				continue;
+			}
+			printRecords(text, format, query);
+			continue;
+		}
+
+		const auto* entries = reinterpret_cast<const Logify::IndexEntry*>(index.data().data());
+		std::size_t count   = index.data().size() / sizeof(Logify::IndexEntry);
+		for (auto [start, end] : Logify::findByteRanges(entries, count, query.from, query.to, text.size()))
+		{
+			printRecords(text.substr(start, end - start), format, query);
+		}
+	}
+
+	std::fflush(stdout);
+	return status;
+}